@@ -8,6 +8,7 @@
 // ============================================================================
 
 let SENSOR_POLL_INTERVAL = 5000; // Poll sensors dynamically based on readInterval (default 5s)
+const SENSOR_POLL_MARGIN = 150;   // Poll this long after the device's next reading lands
 const STATUS_UPDATE_INTERVAL = 30000;
 
 // ============================================================================
@@ -102,8 +103,7 @@ document.addEventListener('DOMContentLoaded', async () => {
     // Check for updates and show banner if available
     setTimeout(() => checkForUpdates(), 600);
     
-    // Start polling (chart history loaded in first loadSensors call)
-    sensorPollTimer = setInterval(loadSensors, SENSOR_POLL_INTERVAL);
+    // Polling is scheduled by each loadSensors call (chart history loaded in the first one)
     setInterval(loadStatus, STATUS_UPDATE_INTERVAL);
     // Note: Backend checks for updates every 24h automatically
     // Frontend only needs to check on page load, tab switch, or manual refresh
@@ -549,9 +549,29 @@ function startRebootCheck() {
 // Sensor Data Polling
 // ============================================================================
 
+function scheduleSensorPoll(delay) {
+    if (sensorPollTimer) {
+        clearTimeout(sensorPollTimer);
+    }
+    sensorPollTimer = setTimeout(loadSensors, delay);
+}
+
 async function loadSensors() {
+    // Fallback when the device gives no hint (or the request fails)
+    let nextPoll = SENSOR_POLL_INTERVAL;
     try {
-        const data = await apiGet('sensors');
+        const response = await fetch('/api/sensors');
+        if (!response.ok) {
+            throw new Error(`API error: ${response.status}`);
+        }
+        
+        // Poll again just after the device completes its next reading
+        const nextReading = parseInt(response.headers.get('X-Next-Reading'), 10);
+        if (!isNaN(nextReading)) {
+            nextPoll = Math.min(Math.max(nextReading + SENSOR_POLL_MARGIN, 500), SENSOR_POLL_INTERVAL * 2);
+        }
+        
+        const data = await response.json();
         sensors = data;
         
         // Apply custom order
@@ -576,6 +596,7 @@ async function loadSensors() {
     } catch (error) {
         console.error('Error loading sensors:', error);
     }
+    scheduleSensorPoll(nextPoll);
 }
 
 function sensorManager_getAverage() {
@@ -937,7 +958,7 @@ function updateSensorGrid() {
             </div>
             <div class="sensor-temperature">
                 ${sensor.connected ? formatTemp(sensor.temperature) : '--'}
-                <span class="unit">°C</span>
+                <span class="unit">${sensor.unit || '°C'}</span>
             </div>
             <div class="sensor-thresholds">
                 <span>Low: ${sensor.thresholdLow}°C</span>
@@ -1504,14 +1525,8 @@ function populateSystemForm(config) {
 }
 
 function updatePollInterval(readInterval) {
-    // Set frontend poll to match ESP32 read interval (in milliseconds)
+    // Fallback poll interval when the device gives no next-reading hint (ms)
     SENSOR_POLL_INTERVAL = readInterval * 1000;
-    
-    // Restart sensor polling with new interval
-    if (sensorPollTimer) {
-        clearInterval(sensorPollTimer);
-        sensorPollTimer = setInterval(loadSensors, SENSOR_POLL_INTERVAL);
-    }
 }
 
 async function saveSystemConfig() {
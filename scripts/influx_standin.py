@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""
+Stand-in InfluxDB write endpoint for testing the exporter without a server.
+Accepts 1.x (/write) and 2.x (/api/v2/write) writes, gunzips the body,
+checks every line of line protocol and prints a summary per batch.
+
+Usage:
+    python3 scripts/influx_standin.py                  # Listen on :8086, accept everything
+    python3 scripts/influx_standin.py --token secret   # Require "Authorization: Token secret"
+    python3 scripts/influx_standin.py --fail-next 3    # Answer the next 3 writes with 503 (backoff)
+    python3 scripts/influx_standin.py --fail-rate 0.5  # Answer half the writes with 503
+    python3 scripts/influx_standin.py --fail-status 500 --fail-rate 1 --dump
+
+Point the station at it with
+    {"enabled":true,"url":"http://<pc-ip>:8086/api/v2/write?org=test&bucket=test"}
+"""
+
+import argparse
+import gzip
+import random
+import time
+from http.server import BaseHTTPRequestHandler, HTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+WRITE_PATHS = ("/write", "/api/v2/write")
+
+
+def split_unescaped(text, separator, quotes=False):
+    """Split on separator, skipping backslash escapes (and double-quoted strings)."""
+    parts = []
+    current = ""
+    escaped = False
+    quoted = False
+    for ch in text:
+        if escaped:
+            current += ch
+            escaped = False
+        elif ch == "\\":
+            current += ch
+            escaped = True
+        elif quotes and ch == '"':
+            current += ch
+            quoted = not quoted
+        elif ch == separator and not quoted:
+            parts.append(current)
+            current = ""
+        else:
+            current += ch
+    if quoted:
+        raise ValueError("unterminated string")
+    parts.append(current)
+    return parts
+
+
+def check_field_value(value):
+    if value.startswith('"'):
+        if len(value) < 2 or not value.endswith('"'):
+            raise ValueError(f"bad string field {value!r}")
+    elif value in ("t", "T", "true", "True", "TRUE", "f", "F", "false", "False", "FALSE"):
+        pass
+    elif value.endswith(("i", "u")):
+        int(value[:-1])
+    else:
+        float(value)
+
+
+def check_line(line):
+    """Raise ValueError unless line is valid line protocol; return the timestamp (or None)."""
+    sections = split_unescaped(line, " ", quotes=True)
+    if len(sections) not in (2, 3):
+        raise ValueError(f"expected 2 or 3 space-separated sections, got {len(sections)}")
+
+    series = split_unescaped(sections[0], ",")
+    if not series[0]:
+        raise ValueError("empty measurement")
+    for tag in series[1:]:
+        key, sep, value = tag.partition("=")
+        if not sep or not key or not value:
+            raise ValueError(f"bad tag {tag!r}")
+
+    for field in split_unescaped(sections[1], ",", quotes=True):
+        key, sep, value = field.partition("=")
+        if not sep or not key or not value:
+            raise ValueError(f"bad field {field!r}")
+        check_field_value(value)
+
+    if len(sections) == 3:
+        return int(sections[2])
+    return None
+
+
+class WriteHandler(BaseHTTPRequestHandler):
+    args = None
+    writes = 0
+    failures_left = 0
+
+    def reply(self, status, message=""):
+        body = message.encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_POST(self):
+        url = urlsplit(self.path)
+        query = parse_qs(url.query)
+        length = int(self.headers.get("Content-Length", 0))
+        raw = self.rfile.read(length)
+        cls = WriteHandler
+
+        if url.path not in WRITE_PATHS:
+            self.reply(404, "not found")
+            return
+
+        if cls.args.token and self.headers.get("Authorization") != f"Token {cls.args.token}":
+            print(f"401  {url.path}: missing or wrong token")
+            self.reply(401, "unauthorized")
+            return
+
+        # Injected server errors exercise the exporter's backoff and second buffer
+        cls.writes += 1
+        if cls.failures_left > 0 or random.random() < cls.args.fail_rate:
+            cls.failures_left = max(0, cls.failures_left - 1)
+            print(f"{cls.args.fail_status}  write #{cls.writes}: injected failure ({len(raw)} bytes)")
+            self.reply(cls.args.fail_status, "injected failure")
+            return
+
+        body = raw
+        if self.headers.get("Content-Encoding") == "gzip":
+            try:
+                body = gzip.decompress(raw)
+            except OSError as err:
+                print(f"400  write #{cls.writes}: bad gzip body ({err})")
+                self.reply(400, "bad gzip body")
+                return
+
+        try:
+            text = body.decode("utf-8")
+        except UnicodeDecodeError:
+            self.reply(400, "body is not UTF-8")
+            return
+
+        lines = [line for line in text.split("\n") if line]
+        errors = []
+        newest = None
+        for number, line in enumerate(lines, 1):
+            try:
+                timestamp = check_line(line)
+                if timestamp is not None:
+                    newest = timestamp if newest is None else max(newest, timestamp)
+            except ValueError as err:
+                errors.append(f"line {number}: {err}: {line}")
+
+        precision = query.get("precision", ["ns"])[0]
+        target = query.get("bucket", query.get("db", ["?"]))[0]
+        ratio = f", gzip {100 * len(raw) // max(len(body), 1)}%" if body is not raw else ""
+        age = ""
+        if newest is not None and precision == "ms":
+            age = f", newest {time.time() - newest / 1000:.1f} s old"
+
+        if errors:
+            print(f"400  write #{cls.writes} to {target}: {len(errors)} of {len(lines)} lines invalid")
+            for error in errors[:5]:
+                print(f"       {error}")
+            self.reply(400, errors[0])
+            return
+
+        print(f"204  write #{cls.writes} to {target}: {len(lines)} lines, {len(body)} bytes{ratio}{age}")
+        if cls.args.dump:
+            for line in lines:
+                print(f"       {line}")
+        self.reply(204)
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--port", type=int, default=8086, help="TCP port")
+    parser.add_argument("--token", default="", help="Required API token (empty = no auth)")
+    parser.add_argument("--fail-next", type=int, default=0, help="Fail this many writes first")
+    parser.add_argument("--fail-rate", type=float, default=0.0, help="Fraction of writes to fail")
+    parser.add_argument("--fail-status", type=int, default=503, help="HTTP status of failed writes")
+    parser.add_argument("--dump", action="store_true", help="Print every accepted line")
+    args = parser.parse_args()
+
+    WriteHandler.args = args
+    WriteHandler.failures_left = args.fail_next
+
+    server = HTTPServer(("", args.port), WriteHandler)
+    print(f"Listening on :{args.port} for {' and '.join(WRITE_PATHS)}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+Stand-in peer stations for testing hub mode without extra hardware.
+Sends UDP telemetry datagrams (same format as the firmware) to the
+multicast group, one per station per interval.
+
+Usage:
+    python3 scripts/peer_standin.py                    # 1 station, 3 sensors, every 5 s
+    python3 scripts/peer_standin.py --stations 3 --sensors 2 --interval 2
+    python3 scripts/peer_standin.py --drop 0.1         # Skip 10% of datagrams (hub counts them as lost)
+    python3 scripts/peer_standin.py --fail 1           # Sensor 1 reports disconnected
+"""
+
+import argparse
+import math
+import random
+import socket
+import struct
+import time
+
+MAGIC = b"TM"
+VERSION = 1
+VALUE_INVALID = -32768
+READING_CONNECTED = 0x01
+
+
+def build_datagram(device_id, sequence, readings):
+    """Header (magic, version, count, device ID, sequence) followed by readings."""
+    packet = MAGIC + struct.pack("<BB6sI", VERSION, len(readings), device_id, sequence)
+    for address, value, alarm, flags in readings:
+        packet += struct.pack("<8shBB", address, value, alarm, flags)
+    return packet
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--group", default="239.255.77.77", help="Multicast group")
+    parser.add_argument("--port", type=int, default=47700, help="UDP port")
+    parser.add_argument("--stations", type=int, default=1, help="Number of stand-in stations")
+    parser.add_argument("--sensors", type=int, default=3, help="Sensors per station (max 10)")
+    parser.add_argument("--interval", type=float, default=5.0, help="Seconds between read cycles")
+    parser.add_argument("--drop", type=float, default=0.0, help="Fraction of datagrams to skip")
+    parser.add_argument("--fail", type=int, action="append", default=[], help="Sensor index reported as disconnected")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)
+
+    # Locally administered MACs and DS18B20-family addresses, distinct per station
+    stations = []
+    for s in range(args.stations):
+        device_id = bytes([0x02, 0x54, 0x4D, 0x00, 0x00, s + 1])
+        addresses = [bytes([0x28, 0x54, 0x4D, s + 1, i, 0, 0, 0]) for i in range(min(args.sensors, 10))]
+        stations.append({"id": device_id, "addresses": addresses, "sequence": 0})
+
+    print(f"Sending as {args.stations} station(s) to {args.group}:{args.port} every {args.interval} s")
+
+    while True:
+        now = time.time()
+        for s, station in enumerate(stations):
+            readings = []
+            for i, address in enumerate(station["addresses"]):
+                if i in args.fail:
+                    readings.append((address, VALUE_INVALID, 3, 0))
+                    continue
+                temp = 20.0 + 5 * s + i + 2 * math.sin(now / 60 + i)
+                readings.append((address, round(temp * 100), 0, READING_CONNECTED))
+
+            sequence = station["sequence"]
+            station["sequence"] += 1
+            if random.random() < args.drop:
+                continue
+
+            sock.sendto(build_datagram(station["id"], sequence, readings), (args.group, args.port))
+
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,727 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Alarm Rule Engine Implementation
+ */
+
+#include "alarm_rules.h"
+#include <math.h>
+#include <time.h>
+
+namespace {
+
+enum class TokenType : uint8_t {
+    END,
+    NUMBER,         // Optionally with a duration unit
+    CLOCK,          // HH:MM
+    WORD,           // Keyword
+    ADDRESS,        // @ + 16 hex digits
+    NAME,           // "quoted sensor name"
+    SYMBOL,         // Operator or punctuation
+    INVALID
+};
+
+struct Token {
+    TokenType type;
+    const char* start;
+    uint8_t length;
+    float number;
+    char unit;
+};
+
+// ============================================================================
+// Compiler
+// ============================================================================
+
+class RuleCompiler {
+public:
+    RuleCompiler(const AlarmRuleDef& def, CompiledAlarmRule& out, char* error, size_t errorLen) :
+        _source(def.expression),
+        _pos(def.expression),
+        _out(out),
+        _error(error),
+        _errorLen(errorLen),
+        _failed(false),
+        _depth(0) {
+        memset(&_out, 0, sizeof(_out));
+        if (_errorLen > 0) {
+            _error[0] = '\0';
+        }
+
+        // refs[0] is always the target sensor ("value")
+        strlcpy(_out.refs[0], def.target, SENSOR_ADDR_STR_LEN);
+        _out.refCount = 1;
+    }
+
+    bool run() {
+        if (_out.refs[0][0] == '\0') {
+            return fail("No target sensor");
+        }
+
+        next();
+        if (_tok.type == TokenType::END) {
+            return fail("Empty expression");
+        }
+
+        parseExpr();
+        if (!_failed && _tok.type != TokenType::END) {
+            fail("Unexpected token");
+        }
+        if (!_failed) {
+            _out.code[_out.codeLength++] = (uint8_t)AlarmRuleOp::END;
+        }
+        return !_failed;
+    }
+
+private:
+    const char* _source;
+    const char* _pos;
+    Token _tok;
+    CompiledAlarmRule& _out;
+    char* _error;
+    size_t _errorLen;
+    bool _failed;
+    uint8_t _depth;
+
+    bool fail(const char* message) {
+        if (!_failed) {
+            snprintf(_error, _errorLen, "%s at %d", message, (int)(_tok.start - _source) + 1);
+            _failed = true;
+        }
+        return false;
+    }
+
+    // ---------- Tokenizer ----------
+
+    void next() {
+        while (*_pos == ' ' || *_pos == '\t') {
+            _pos++;
+        }
+
+        _tok.start = _pos;
+        _tok.length = 0;
+        _tok.number = 0.0f;
+        _tok.unit = 0;
+
+        char c = *_pos;
+        if (c == '\0') {
+            _tok.type = TokenType::END;
+            return;
+        }
+
+        if (isdigit((unsigned char)c) || c == '.') {
+            char* end;
+            _tok.number = strtof(_pos, &end);
+            _pos = end;
+            _tok.type = TokenType::NUMBER;
+
+            if (*_pos == ':' && isdigit((unsigned char)_pos[1])) {
+                // HH:MM
+                long minutes = strtol(_pos + 1, &end, 10);
+                _pos = end;
+                if (_tok.number < 0 || _tok.number > 23 || minutes > 59 ||
+                    _tok.number != floorf(_tok.number)) {
+                    _tok.type = TokenType::INVALID;
+                }
+                _tok.number = _tok.number * 60 + minutes;
+                _tok.type = _tok.type == TokenType::INVALID ? TokenType::INVALID : TokenType::CLOCK;
+            } else if ((*_pos == 's' || *_pos == 'm' || *_pos == 'h') &&
+                       !isalnum((unsigned char)_pos[1])) {
+                _tok.unit = *_pos++;
+            }
+        } else if (isalpha((unsigned char)c)) {
+            while (isalnum((unsigned char)*_pos) || *_pos == '_') {
+                _pos++;
+            }
+            _tok.type = TokenType::WORD;
+        } else if (c == '@') {
+            _pos++;
+            while (isxdigit((unsigned char)*_pos)) {
+                _pos++;
+            }
+            _tok.type = (_pos - _tok.start == SENSOR_ADDR_STR_LEN) ? TokenType::ADDRESS : TokenType::INVALID;
+        } else if (c == '"') {
+            _pos++;
+            while (*_pos && *_pos != '"') {
+                _pos++;
+            }
+            if (*_pos == '"') {
+                _pos++;
+                _tok.type = TokenType::NAME;
+            } else {
+                _tok.type = TokenType::INVALID;
+            }
+        } else if ((c == '<' || c == '>') && _pos[1] == '=') {
+            _pos += 2;
+            _tok.type = TokenType::SYMBOL;
+        } else if ((c == '&' || c == '|') && _pos[1] == c) {
+            _pos += 2;
+            _tok.type = TokenType::SYMBOL;
+        } else if (strchr("<>+-(),!", c)) {
+            _pos++;
+            _tok.type = TokenType::SYMBOL;
+        } else {
+            _pos++;
+            _tok.type = TokenType::INVALID;
+        }
+
+        _tok.length = _pos - _tok.start;
+    }
+
+    bool is(const char* text) const {
+        if (_tok.type != TokenType::WORD && _tok.type != TokenType::SYMBOL) {
+            return false;
+        }
+        size_t len = strlen(text);
+        return _tok.length == len && strncasecmp(_tok.start, text, len) == 0;
+    }
+
+    bool accept(const char* text) {
+        if (is(text)) {
+            next();
+            return true;
+        }
+        return false;
+    }
+
+    bool expect(const char* text) {
+        if (accept(text)) {
+            return true;
+        }
+        char message[16];
+        snprintf(message, sizeof(message), "Expected '%s'", text);
+        return fail(message);
+    }
+
+    // ---------- Code emission ----------
+
+    void emitByte(uint8_t b) {
+        // Keep one byte for the final END
+        if (_out.codeLength >= ALARM_RULE_MAX_CODE - 1) {
+            fail("Expression too long");
+            return;
+        }
+        _out.code[_out.codeLength++] = b;
+    }
+
+    void emitOp(AlarmRuleOp op, int8_t stackEffect) {
+        emitByte((uint8_t)op);
+        _depth += stackEffect;
+        if (_depth > ALARM_RULE_STACK_DEPTH) {
+            fail("Expression too deep");
+        }
+    }
+
+    void emitU16(uint16_t value) {
+        emitByte(value & 0xFF);
+        emitByte(value >> 8);
+    }
+
+    void emitFloat(float value) {
+        uint8_t bytes[sizeof(float)];
+        memcpy(bytes, &value, sizeof(bytes));
+        for (uint8_t i = 0; i < sizeof(bytes); i++) {
+            emitByte(bytes[i]);
+        }
+    }
+
+    int8_t addRef(const char* address) {
+        for (uint8_t i = 0; i < _out.refCount; i++) {
+            if (strcmp(_out.refs[i], address) == 0) {
+                return i;
+            }
+        }
+        if (_out.refCount >= ALARM_RULE_MAX_REFS) {
+            fail("Too many sensors");
+            return -1;
+        }
+        strlcpy(_out.refs[_out.refCount], address, SENSOR_ADDR_STR_LEN);
+        return _out.refCount++;
+    }
+
+    // ---------- Parser ----------
+
+    void parseExpr() {
+        parseAnd();
+        while (!_failed && (accept("||") || accept("or"))) {
+            parseAnd();
+            emitOp(AlarmRuleOp::OR, -1);
+        }
+    }
+
+    void parseAnd() {
+        parseNot();
+        while (!_failed && (accept("&&") || accept("and"))) {
+            parseNot();
+            emitOp(AlarmRuleOp::AND, -1);
+        }
+    }
+
+    void parseNot() {
+        if (accept("!") || accept("not")) {
+            parseNot();
+            emitOp(AlarmRuleOp::NOT, 0);
+            return;
+        }
+
+        parsePrimary();
+
+        if (!_failed && accept("for")) {
+            if (_tok.type != TokenType::NUMBER || _tok.unit == 0) {
+                fail("Expected duration");
+                return;
+            }
+            float seconds = _tok.number * (_tok.unit == 'h' ? 3600 : _tok.unit == 'm' ? 60 : 1);
+            if (seconds < 1 || seconds > 65535) {
+                fail("Duration out of range");
+                return;
+            }
+            if (_out.timerCount >= ALARM_RULE_MAX_TIMERS) {
+                fail("Too many durations");
+                return;
+            }
+            next();
+            emitOp(AlarmRuleOp::HOLD, 0);
+            emitByte(_out.timerCount++);
+            emitU16((uint16_t)seconds);
+        }
+    }
+
+    void parsePrimary() {
+        if (accept("(")) {
+            parseExpr();
+            expect(")");
+            return;
+        }
+
+        if (accept("time")) {
+            uint16_t window[2];
+            expect("(");
+            for (uint8_t i = 0; i < 2 && !_failed; i++) {
+                if (i == 1) {
+                    expect(",");
+                }
+                if (_tok.type != TokenType::CLOCK) {
+                    fail("Expected HH:MM");
+                    return;
+                }
+                window[i] = (uint16_t)_tok.number;
+                next();
+            }
+            expect(")");
+            emitOp(AlarmRuleOp::TIME_WINDOW, 1);
+            emitU16(window[0]);
+            emitU16(window[1]);
+            return;
+        }
+
+        parseSum();
+
+        AlarmRuleOp cmp;
+        if (accept("<=")) {
+            cmp = AlarmRuleOp::LE;
+        } else if (accept(">=")) {
+            cmp = AlarmRuleOp::GE;
+        } else if (accept("<")) {
+            cmp = AlarmRuleOp::LT;
+        } else if (accept(">")) {
+            cmp = AlarmRuleOp::GT;
+        } else {
+            fail("Expected comparison");
+            return;
+        }
+
+        parseSum();
+        emitOp(cmp, -1);
+    }
+
+    void parseSum() {
+        parseOperand();
+        while (!_failed) {
+            if (accept("+")) {
+                parseOperand();
+                emitOp(AlarmRuleOp::ADD, -1);
+            } else if (accept("-")) {
+                parseOperand();
+                emitOp(AlarmRuleOp::SUB, -1);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void parseOperand() {
+        if (_failed) {
+            return;
+        }
+
+        bool negative = accept("-");
+        if (_tok.type == TokenType::NUMBER && _tok.unit == 0) {
+            emitOp(AlarmRuleOp::PUSH, 1);
+            emitFloat(negative ? -_tok.number : _tok.number);
+            next();
+            return;
+        }
+        if (negative) {
+            fail("Expected number");
+            return;
+        }
+
+        AlarmRuleOp load = AlarmRuleOp::LOAD;
+        bool isRate = accept("rate");
+        if (isRate) {
+            load = AlarmRuleOp::RATE;
+            expect("(");
+        }
+
+        int8_t ref = parseSensor();
+        if (ref < 0) {
+            return;
+        }
+        emitOp(load, 1);
+        emitByte(ref);
+
+        if (isRate) {
+            expect(")");
+        }
+    }
+
+    int8_t parseSensor() {
+        if (_failed) {
+            return -1;
+        }
+
+        if (accept("value")) {
+            return 0;
+        }
+
+        if (_tok.type == TokenType::ADDRESS) {
+            char address[SENSOR_ADDR_STR_LEN];
+            for (uint8_t i = 0; i < SENSOR_ADDR_STR_LEN - 1; i++) {
+                address[i] = toupper((unsigned char)_tok.start[1 + i]);
+            }
+            address[SENSOR_ADDR_STR_LEN - 1] = '\0';
+            next();
+            return addRef(address);
+        }
+
+        if (_tok.type == TokenType::NAME) {
+            // Names are resolved to addresses now so renaming a sensor later
+            // does not change what the rule refers to
+            const char* name = _tok.start + 1;
+            size_t nameLen = _tok.length - 2;
+            for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+                const SensorConfig* config = configManager.getSensorConfig(i);
+                if (config && config->isConfigured &&
+                    strlen(config->name) == nameLen && strncmp(config->name, name, nameLen) == 0) {
+                    next();
+                    return addRef(config->address);
+                }
+            }
+            fail("Unknown sensor name");
+            return -1;
+        }
+
+        fail("Expected sensor");
+        return -1;
+    }
+};
+
+uint16_t readU16(const uint8_t* code) {
+    return code[0] | (code[1] << 8);
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+AlarmRuleEngine::AlarmRuleEngine() {
+    for (uint8_t i = 0; i < MAX_ALARM_RULES; i++) {
+        memset(&_compiled[i], 0, sizeof(_compiled[i]));
+        memset(&_state[i], 0, sizeof(_state[i]));
+    }
+    for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+        _rate[i] = NAN;
+        _rateRefValue[i] = TEMP_INVALID;
+        _rateRefMs[i] = 0;
+    }
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+bool AlarmRuleEngine::compile(const AlarmRuleDef& def, CompiledAlarmRule& out,
+                              char* error, size_t errorLen) {
+    RuleCompiler compiler(def, out, error, errorLen);
+    return compiler.run();
+}
+
+void AlarmRuleEngine::load() {
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        RuleState& state = _state[slot];
+        memset(&state, 0, sizeof(state));
+        memset(state.refIndex, -1, sizeof(state.refIndex));
+
+        const AlarmRuleDef* def = configManager.getAlarmRuleDef(slot);
+        if (!def || !def->enabled) {
+            continue;
+        }
+
+        state.severity = def->severity;
+        state.valid = compile(*def, _compiled[slot], state.error, sizeof(state.error));
+
+        if (state.valid) {
+            Serial.printf("[Rules] Rule %d '%s': %d bytes\n",
+                slot, def->name, _compiled[slot].codeLength);
+        } else {
+            Serial.printf("[Rules] Rule %d '%s' invalid: %s\n",
+                slot, def->name, state.error);
+        }
+    }
+}
+
+void AlarmRuleEngine::bind(const char* const* addresses, uint8_t count) {
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        if (!_state[slot].valid) {
+            continue;
+        }
+
+        const CompiledAlarmRule& rule = _compiled[slot];
+        for (uint8_t r = 0; r < rule.refCount; r++) {
+            _state[slot].refIndex[r] = -1;
+            for (uint8_t i = 0; i < count; i++) {
+                if (strcmp(addresses[i], rule.refs[r]) == 0) {
+                    _state[slot].refIndex[r] = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Sensor indices may have moved
+    for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+        _rate[i] = NAN;
+        _rateRefMs[i] = 0;
+    }
+}
+
+void AlarmRuleEngine::evaluate(const float* values, uint8_t count) {
+    uint32_t now = millis();
+    updateRates(values, count, now);
+
+    // Local time for time() windows, unknown until NTP has synced
+    int16_t minuteOfDay = -1;
+    time_t epoch = time(nullptr);
+    if (epoch >= MIN_VALID_EPOCH) {
+        struct tm local;
+        localtime_r(&epoch, &local);
+        minuteOfDay = local.tm_hour * 60 + local.tm_min;
+    }
+
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        RuleState& state = _state[slot];
+        if (!state.valid) {
+            continue;
+        }
+
+        // Unknown (a sensor is missing) does not fire
+        bool active = run(slot, values, count, minuteOfDay, now) == 1.0f;
+
+        if (active != state.active) {
+            state.active = active;
+            const AlarmRuleDef* def = configManager.getAlarmRuleDef(slot);
+            Serial.printf("[Rules] Rule %d '%s' %s\n",
+                slot, def ? def->name : "", active ? "active" : "cleared");
+        }
+    }
+}
+
+bool AlarmRuleEngine::getTargetAlarm(uint8_t sensorIndex, AlarmRuleSeverity& severity) const {
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        const RuleState& state = _state[slot];
+        if (state.valid && state.active && state.refIndex[0] == sensorIndex) {
+            severity = state.severity;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AlarmRuleEngine::isValid(uint8_t slot) const {
+    return slot < MAX_ALARM_RULES && _state[slot].valid;
+}
+
+bool AlarmRuleEngine::isActive(uint8_t slot) const {
+    return slot < MAX_ALARM_RULES && _state[slot].active;
+}
+
+bool AlarmRuleEngine::isReferenced(uint8_t sensorIndex) const {
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        if (!_state[slot].valid) {
+            continue;
+        }
+        for (uint8_t r = 0; r < _compiled[slot].refCount; r++) {
+            if (_state[slot].refIndex[r] == sensorIndex) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const char* AlarmRuleEngine::getError(uint8_t slot) const {
+    return slot < MAX_ALARM_RULES ? _state[slot].error : "";
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+void AlarmRuleEngine::updateRates(const float* values, uint8_t count, uint32_t now) {
+    for (uint8_t i = 0; i < count && i < MAX_SENSORS; i++) {
+        if (values[i] == TEMP_INVALID) {
+            _rate[i] = NAN;
+            _rateRefMs[i] = 0;
+            continue;
+        }
+
+        if (_rateRefMs[i] == 0) {
+            _rateRefValue[i] = values[i];
+            _rateRefMs[i] = now;
+            continue;
+        }
+
+        // Measure over a full window so single-LSB steps don't look like a ramp
+        uint32_t elapsed = now - _rateRefMs[i];
+        if (elapsed >= ALARM_RULE_RATE_WINDOW_MS) {
+            _rate[i] = (values[i] - _rateRefValue[i]) * 60000.0f / elapsed;
+            _rateRefValue[i] = values[i];
+            _rateRefMs[i] = now;
+        }
+    }
+}
+
+float AlarmRuleEngine::run(uint8_t slot, const float* values, uint8_t count,
+                           int16_t minuteOfDay, uint32_t now) {
+    const CompiledAlarmRule& rule = _compiled[slot];
+    RuleState& state = _state[slot];
+
+    // Truth values are 1/0, NAN means unknown
+    float stack[ALARM_RULE_STACK_DEPTH];
+    uint8_t sp = 0;
+    uint8_t pc = 0;
+
+    while (pc < rule.codeLength) {
+        AlarmRuleOp op = (AlarmRuleOp)rule.code[pc++];
+
+        switch (op) {
+            case AlarmRuleOp::END:
+                pc = rule.codeLength;
+                break;
+
+            case AlarmRuleOp::PUSH: {
+                float value;
+                memcpy(&value, &rule.code[pc], sizeof(value));
+                pc += sizeof(value);
+                stack[sp++] = value;
+                break;
+            }
+
+            case AlarmRuleOp::LOAD:
+            case AlarmRuleOp::RATE: {
+                int8_t index = state.refIndex[rule.code[pc++]];
+                float value = NAN;
+                if (index >= 0 && index < count && values[index] != TEMP_INVALID) {
+                    value = (op == AlarmRuleOp::LOAD) ? values[index] : _rate[index];
+                }
+                stack[sp++] = value;
+                break;
+            }
+
+            case AlarmRuleOp::ADD:
+            case AlarmRuleOp::SUB: {
+                float b = stack[--sp];
+                float a = stack[sp - 1];
+                stack[sp - 1] = (op == AlarmRuleOp::ADD) ? a + b : a - b;
+                break;
+            }
+
+            case AlarmRuleOp::LT:
+            case AlarmRuleOp::LE:
+            case AlarmRuleOp::GT:
+            case AlarmRuleOp::GE: {
+                float b = stack[--sp];
+                float a = stack[sp - 1];
+                bool result;
+                switch (op) {
+                    case AlarmRuleOp::LT: result = a < b; break;
+                    case AlarmRuleOp::LE: result = a <= b; break;
+                    case AlarmRuleOp::GT: result = a > b; break;
+                    default:              result = a >= b; break;
+                }
+                stack[sp - 1] = (isnan(a) || isnan(b)) ? NAN : (result ? 1.0f : 0.0f);
+                break;
+            }
+
+            case AlarmRuleOp::AND:
+            case AlarmRuleOp::OR: {
+                float b = stack[--sp];
+                float a = stack[sp - 1];
+                // A known operand can decide the result even if the other is unknown
+                float decisive = (op == AlarmRuleOp::AND) ? 0.0f : 1.0f;
+                if (a == decisive || b == decisive) {
+                    stack[sp - 1] = decisive;
+                } else if (isnan(a) || isnan(b)) {
+                    stack[sp - 1] = NAN;
+                } else {
+                    stack[sp - 1] = 1.0f - decisive;
+                }
+                break;
+            }
+
+            case AlarmRuleOp::NOT:
+                if (!isnan(stack[sp - 1])) {
+                    stack[sp - 1] = 1.0f - stack[sp - 1];
+                }
+                break;
+
+            case AlarmRuleOp::TIME_WINDOW: {
+                uint16_t start = readU16(&rule.code[pc]);
+                uint16_t end = readU16(&rule.code[pc + 2]);
+                pc += 4;
+
+                float value = NAN;
+                if (minuteOfDay >= 0) {
+                    // Windows may wrap past midnight (22:00 to 06:00)
+                    bool inside = (start <= end)
+                        ? (minuteOfDay >= start && minuteOfDay < end)
+                        : (minuteOfDay >= start || minuteOfDay < end);
+                    value = inside ? 1.0f : 0.0f;
+                }
+                stack[sp++] = value;
+                break;
+            }
+
+            case AlarmRuleOp::HOLD: {
+                uint8_t timer = rule.code[pc];
+                uint32_t holdMs = readU16(&rule.code[pc + 1]) * 1000UL;
+                pc += 3;
+
+                if (stack[sp - 1] == 1.0f) {
+                    if (state.timerStart[timer] == 0) {
+                        state.timerStart[timer] = now ? now : 1;
+                    }
+                    stack[sp - 1] = (now - state.timerStart[timer] >= holdMs) ? 1.0f : 0.0f;
+                } else {
+                    // False or unknown restarts the duration
+                    state.timerStart[timer] = 0;
+                }
+                break;
+            }
+        }
+    }
+
+    return sp > 0 ? stack[sp - 1] : NAN;
+}
@@ -0,0 +1,168 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Alarm Rule Engine Header
+ *
+ * Rules extend the per-sensor thresholds with expressions such as
+ *   value > 75 for 5m
+ *   value - @28FF641E8716043C > 10 && time(06:00, 22:00)
+ *   rate("Boiler") > 2 or "Return" < 30
+ *
+ * Expressions are compiled once (at load or when edited) into a small
+ * stack bytecode without jumps, so evaluating all rules in a read cycle
+ * costs at most MAX_ALARM_RULES * ALARM_RULE_MAX_CODE instructions.
+ *
+ * Grammar:
+ *   expr     := and { ("||" | "or") and }
+ *   and      := not { ("&&" | "and") not }
+ *   not      := ("!" | "not") not | primary [ "for" DURATION ]
+ *   primary  := "(" expr ")" | "time" "(" HH:MM "," HH:MM ")" | sum CMP sum
+ *   sum      := operand { ("+" | "-") operand }
+ *   operand  := NUMBER | sensor | "rate" "(" sensor ")"
+ *   sensor   := "value" | "@" ADDRESS | "\"" NAME "\""
+ *   CMP      := "<" | "<=" | ">" | ">="
+ *   DURATION := NUMBER ("s" | "m" | "h")
+ *
+ * "value" is the rule's target sensor. rate() is in degrees per minute.
+ * Comparisons involving a disconnected sensor are unknown, and a rule
+ * only fires when its expression is definitely true.
+ */
+
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+
+// ============================================================================
+// Bytecode
+// ============================================================================
+
+enum class AlarmRuleOp : uint8_t {
+    END = 0,
+    PUSH,           // f32 constant
+    LOAD,           // u8 ref: sensor value
+    RATE,           // u8 ref: sensor rate of change
+    ADD,
+    SUB,
+    LT,
+    LE,
+    GT,
+    GE,
+    AND,
+    OR,
+    NOT,
+    TIME_WINDOW,    // u16 start, u16 end (minute of day, local time)
+    HOLD            // u8 timer, u16 seconds: operand true for that long
+};
+
+/**
+ * Compiled form of an AlarmRuleDef
+ */
+struct CompiledAlarmRule {
+    uint8_t code[ALARM_RULE_MAX_CODE];
+    uint8_t codeLength;
+    char refs[ALARM_RULE_MAX_REFS][SENSOR_ADDR_STR_LEN];  // refs[0] is the target
+    uint8_t refCount;
+    uint8_t timerCount;
+};
+
+// ============================================================================
+// AlarmRuleEngine Class
+// ============================================================================
+
+class AlarmRuleEngine {
+public:
+    /**
+     * Constructor
+     */
+    AlarmRuleEngine();
+
+    /**
+     * Compile a rule definition
+     * @param def Rule definition (target and expression)
+     * @param out Compiled rule
+     * @param error Error message buffer (set on failure)
+     * @param errorLen Error buffer size
+     * @return true if the expression compiled
+     */
+    static bool compile(const AlarmRuleDef& def, CompiledAlarmRule& out,
+                        char* error, size_t errorLen);
+
+    /**
+     * Compile all rule definitions from the configuration
+     * Resets rule state; call bind() afterwards
+     */
+    void load();
+
+    /**
+     * Resolve sensor references to current sensor indices
+     * @param addresses Address string per sensor index
+     * @param count Number of sensors
+     */
+    void bind(const char* const* addresses, uint8_t count);
+
+    /**
+     * Evaluate all rules for one read cycle
+     * @param values Calibrated value per sensor index (TEMP_INVALID if unavailable)
+     * @param count Number of sensors
+     */
+    void evaluate(const float* values, uint8_t count);
+
+    /**
+     * Get alarm raised by rules on a sensor
+     * @param sensorIndex Sensor index
+     * @param severity Severity of the first active rule targeting the sensor
+     * @return true if any rule targeting the sensor is active
+     */
+    bool getTargetAlarm(uint8_t sensorIndex, AlarmRuleSeverity& severity) const;
+
+    /**
+     * Check if a rule slot compiled successfully
+     */
+    bool isValid(uint8_t slot) const;
+
+    /**
+     * Check if a rule currently holds
+     */
+    bool isActive(uint8_t slot) const;
+
+    /**
+     * Check if any valid rule reads a sensor (as target or operand)
+     */
+    bool isReferenced(uint8_t sensorIndex) const;
+
+    /**
+     * Get compile error of a rule slot (empty if none)
+     */
+    const char* getError(uint8_t slot) const;
+
+private:
+    struct RuleState {
+        bool valid;
+        bool active;
+        AlarmRuleSeverity severity;
+        int8_t refIndex[ALARM_RULE_MAX_REFS];       // Sensor index per ref, -1 if absent
+        uint32_t timerStart[ALARM_RULE_MAX_TIMERS]; // 0 = condition not holding
+        char error[48];
+    };
+
+    CompiledAlarmRule _compiled[MAX_ALARM_RULES];
+    RuleState _state[MAX_ALARM_RULES];
+
+    // rate() tracking per sensor index
+    float _rate[MAX_SENSORS];
+    float _rateRefValue[MAX_SENSORS];
+    uint32_t _rateRefMs[MAX_SENSORS];
+
+    void updateRates(const float* values, uint8_t count, uint32_t now);
+
+    /**
+     * Run one compiled rule
+     * @return 1 (true), 0 (false) or NAN (unknown)
+     */
+    float run(uint8_t slot, const float* values, uint8_t count,
+              int16_t minuteOfDay, uint32_t now);
+};
+
+#endif // ALARM_RULES_H
@@ -0,0 +1,67 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Boot Metrics Implementation
+ */
+
+#include "boot_metrics.h"
+
+// Global instance
+BootMetrics bootMetrics;
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+BootMetrics::BootMetrics() {
+    for (uint8_t i = 0; i < (uint8_t)BootStage::COUNT; i++) {
+        _marks[i] = 0;
+    }
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void BootMetrics::mark(BootStage stage) {
+    uint8_t index = (uint8_t)stage;
+    if (index >= (uint8_t)BootStage::COUNT || _marks[index] != 0) {
+        return;
+    }
+
+    // 0 means "not reached", so a stage at the very first ms reads as 1
+    uint32_t now = millis();
+    _marks[index] = now > 0 ? now : 1;
+
+    Serial.printf("[Boot] %s at %lu ms\n", bootStageToString(stage), (unsigned long)_marks[index]);
+}
+
+uint32_t BootMetrics::get(BootStage stage) const {
+    uint8_t index = (uint8_t)stage;
+    return index < (uint8_t)BootStage::COUNT ? _marks[index] : 0;
+}
+
+void BootMetrics::toJson(JsonObject obj) const {
+    for (uint8_t i = 0; i < (uint8_t)BootStage::COUNT; i++) {
+        if (_marks[i] != 0) {
+            obj[bootStageToString((BootStage)i)] = _marks[i];
+        }
+    }
+}
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+const char* bootStageToString(BootStage stage) {
+    switch (stage) {
+        case BootStage::CONFIG_LOADED:  return "configLoaded";
+        case BootStage::DISPLAY_READY:  return "displayReady";
+        case BootStage::SENSORS_READY:  return "sensorsReady";
+        case BootStage::WEB_READY:      return "webReady";
+        case BootStage::SETUP_DONE:     return "setupDone";
+        case BootStage::WIFI_CONNECTED: return "wifiConnected";
+        case BootStage::FIRST_READING:  return "firstReading";
+        case BootStage::FIRST_PUBLISH:  return "firstPublish";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Boot Metrics Header
+ *
+ * Records when each boot stage completed (ms since start), so the effect
+ * of boot ordering can be measured in the field:
+ * - setup stages: configuration, display, sensor discovery, web server
+ * - asynchronous milestones: WiFi association, first reading, first publish
+ */
+
+#ifndef BOOT_METRICS_H
+#define BOOT_METRICS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * Boot stages in the order they are reported
+ */
+enum class BootStage : uint8_t {
+    CONFIG_LOADED,
+    DISPLAY_READY,
+    SENSORS_READY,
+    WEB_READY,
+    SETUP_DONE,
+    WIFI_CONNECTED,
+    FIRST_READING,
+    FIRST_PUBLISH,
+    COUNT
+};
+
+// ============================================================================
+// BootMetrics Class
+// ============================================================================
+
+class BootMetrics {
+public:
+    /**
+     * Constructor
+     */
+    BootMetrics();
+
+    /**
+     * Record that a stage completed (only the first call counts)
+     * Safe to call from any task
+     */
+    void mark(BootStage stage);
+
+    /**
+     * Get when a stage completed
+     * @return ms since start, 0 if not reached yet
+     */
+    uint32_t get(BootStage stage) const;
+
+    /**
+     * Add all reached stages to a JSON object ({"sensorsReady": 812, ...})
+     */
+    void toJson(JsonObject obj) const;
+
+private:
+    volatile uint32_t _marks[(uint8_t)BootStage::COUNT];
+};
+
+/**
+ * Get boot stage as string (JSON key)
+ */
+const char* bootStageToString(BootStage stage);
+
+// Global boot metrics instance
+extern BootMetrics bootMetrics;
+
+#endif // BOOT_METRICS_H
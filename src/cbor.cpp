@@ -0,0 +1,328 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * CBOR Encoding Implementation
+ */
+
+#include "cbor.h"
+
+namespace {
+
+// Major types (RFC 8949 section 3.1)
+constexpr uint8_t CBOR_UINT = 0;
+constexpr uint8_t CBOR_NEGINT = 1;
+constexpr uint8_t CBOR_BYTES = 2;
+constexpr uint8_t CBOR_TEXT = 3;
+constexpr uint8_t CBOR_ARRAY = 4;
+constexpr uint8_t CBOR_MAP = 5;
+
+constexpr uint8_t CBOR_SIMPLE = 7;
+
+// Simple values and floats (major type 7)
+constexpr uint8_t CBOR_FALSE = 0xF4;
+constexpr uint8_t CBOR_TRUE = 0xF5;
+constexpr uint8_t CBOR_NULL = 0xF6;
+constexpr uint8_t CBOR_UNDEFINED = 0xF7;
+constexpr uint8_t CBOR_FLOAT16 = 0xF9;
+constexpr uint8_t CBOR_FLOAT32 = 0xFA;
+constexpr uint8_t CBOR_FLOAT64 = 0xFB;
+
+// Half precision to float (RFC 8949 appendix D)
+float halfToFloat(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+
+    float value;
+    if (exponent == 0) {
+        value = ldexpf(mantissa, -24);
+    } else if (exponent != 31) {
+        value = ldexpf(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+CborWriter::CborWriter(uint8_t* buffer, size_t capacity) :
+    _buffer(buffer),
+    _capacity(capacity),
+    _length(0),
+    _overflow(false) {
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void CborWriter::writeMap(size_t count) {
+    writeHead(CBOR_MAP, count);
+}
+
+void CborWriter::writeArray(size_t count) {
+    writeHead(CBOR_ARRAY, count);
+}
+
+void CborWriter::writeText(const char* text) {
+    writeText(text, text ? strlen(text) : 0);
+}
+
+void CborWriter::writeText(const char* text, size_t len) {
+    writeHead(CBOR_TEXT, len);
+    writeRaw(reinterpret_cast<const uint8_t*>(text), len);
+}
+
+void CborWriter::writeBytes(const uint8_t* data, size_t len) {
+    writeHead(CBOR_BYTES, len);
+    writeRaw(data, len);
+}
+
+void CborWriter::writeUint(uint64_t value) {
+    writeHead(CBOR_UINT, value);
+}
+
+void CborWriter::writeInt(int64_t value) {
+    if (value >= 0) {
+        writeHead(CBOR_UINT, (uint64_t)value);
+    } else {
+        // Negative integers encode -1 - n
+        writeHead(CBOR_NEGINT, (uint64_t)(-1 - value));
+    }
+}
+
+void CborWriter::writeFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint8_t out[5] = {
+        CBOR_FLOAT32,
+        (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits
+    };
+    writeRaw(out, sizeof(out));
+}
+
+void CborWriter::writeBool(bool value) {
+    uint8_t b = value ? CBOR_TRUE : CBOR_FALSE;
+    writeRaw(&b, 1);
+}
+
+void CborWriter::writeNull() {
+    uint8_t b = CBOR_NULL;
+    writeRaw(&b, 1);
+}
+
+void CborWriter::writeVariant(JsonVariantConst value) {
+    if (value.is<JsonObjectConst>()) {
+        JsonObjectConst obj = value.as<JsonObjectConst>();
+        writeMap(obj.size());
+        for (JsonPairConst kv : obj) {
+            writeText(kv.key().c_str());
+            writeVariant(kv.value());
+        }
+    } else if (value.is<JsonArrayConst>()) {
+        JsonArrayConst arr = value.as<JsonArrayConst>();
+        writeArray(arr.size());
+        for (JsonVariantConst item : arr) {
+            writeVariant(item);
+        }
+    } else if (value.is<bool>()) {
+        writeBool(value.as<bool>());
+    } else if (value.is<int64_t>()) {
+        writeInt(value.as<int64_t>());
+    } else if (value.is<uint64_t>()) {
+        writeUint(value.as<uint64_t>());
+    } else if (value.is<float>()) {
+        writeFloat(value.as<float>());
+    } else if (value.is<const char*>()) {
+        writeText(value.as<const char*>());
+    } else {
+        writeNull();
+    }
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+void CborWriter::writeHead(uint8_t majorType, uint64_t value) {
+    uint8_t out[9];
+    size_t len;
+    uint8_t mt = majorType << 5;
+
+    if (value < 24) {
+        out[0] = mt | (uint8_t)value;
+        len = 1;
+    } else if (value <= 0xFF) {
+        out[0] = mt | 24;
+        out[1] = (uint8_t)value;
+        len = 2;
+    } else if (value <= 0xFFFF) {
+        out[0] = mt | 25;
+        out[1] = (uint8_t)(value >> 8);
+        out[2] = (uint8_t)value;
+        len = 3;
+    } else if (value <= 0xFFFFFFFFULL) {
+        out[0] = mt | 26;
+        for (uint8_t i = 0; i < 4; i++) {
+            out[1 + i] = (uint8_t)(value >> (24 - 8 * i));
+        }
+        len = 5;
+    } else {
+        out[0] = mt | 27;
+        for (uint8_t i = 0; i < 8; i++) {
+            out[1 + i] = (uint8_t)(value >> (56 - 8 * i));
+        }
+        len = 9;
+    }
+
+    writeRaw(out, len);
+}
+
+void CborWriter::writeRaw(const uint8_t* data, size_t len) {
+    if (_overflow || _length + len > _capacity) {
+        _overflow = true;
+        return;
+    }
+    memcpy(_buffer + _length, data, len);
+    _length += len;
+}
+
+// ============================================================================
+// CborReader
+// ============================================================================
+
+CborReader::CborReader(const uint8_t* data, size_t len) :
+    _data(data),
+    _len(len),
+    _pos(0),
+    _error(false) {
+}
+
+bool CborReader::readArray(size_t& count) {
+    uint64_t value;
+    if (!readHead(CBOR_ARRAY, value)) {
+        return false;
+    }
+    count = (size_t)value;
+    return true;
+}
+
+bool CborReader::readBytes(const uint8_t*& data, size_t& len) {
+    uint64_t value;
+    if (!readHead(CBOR_BYTES, value)) {
+        return false;
+    }
+    if (value > _len - _pos) {
+        _error = true;
+        return false;
+    }
+    data = _data + _pos;
+    len = (size_t)value;
+    _pos += len;
+    return true;
+}
+
+bool CborReader::readText(const char*& text, size_t& len) {
+    uint64_t value;
+    if (!readHead(CBOR_TEXT, value)) {
+        return false;
+    }
+    if (value > _len - _pos) {
+        _error = true;
+        return false;
+    }
+    text = reinterpret_cast<const char*>(_data + _pos);
+    len = (size_t)value;
+    _pos += len;
+    return true;
+}
+
+bool CborReader::readNumber(float& value) {
+    uint64_t arg;
+    switch (peekType()) {
+        case CBOR_UINT:
+            if (!readHead(CBOR_UINT, arg)) return false;
+            value = (float)arg;
+            return true;
+
+        case CBOR_NEGINT:
+            if (!readHead(CBOR_NEGINT, arg)) return false;
+            value = -1.0f - (float)arg;
+            return true;
+
+        case CBOR_SIMPLE:
+            break;
+
+        default:
+            _error = true;
+            return false;
+    }
+
+    uint8_t initial = _data[_pos];
+    if (initial != CBOR_FLOAT16 && initial != CBOR_FLOAT32 && initial != CBOR_FLOAT64) {
+        _error = true;
+        return false;
+    }
+    if (!readHead(CBOR_SIMPLE, arg)) {
+        return false;
+    }
+
+    if (initial == CBOR_FLOAT16) {
+        value = halfToFloat((uint16_t)arg);
+    } else if (initial == CBOR_FLOAT32) {
+        uint32_t bits = (uint32_t)arg;
+        memcpy(&value, &bits, sizeof(value));
+    } else {
+        double d;
+        memcpy(&d, &arg, sizeof(d));
+        value = (float)d;
+    }
+    return true;
+}
+
+bool CborReader::readNull() {
+    if (_error || atEnd() || (_data[_pos] != CBOR_NULL && _data[_pos] != CBOR_UNDEFINED)) {
+        return false;
+    }
+    _pos++;
+    return true;
+}
+
+uint8_t CborReader::peekType() const {
+    return (_error || atEnd()) ? 0xFF : _data[_pos] >> 5;
+}
+
+bool CborReader::readHead(uint8_t majorType, uint64_t& value) {
+    if (peekType() != majorType) {
+        _error = true;
+        return false;
+    }
+
+    uint8_t info = _data[_pos++] & 0x1F;
+    if (info < 24) {
+        value = info;
+        return true;
+    }
+
+    // 24-27: argument follows in 1, 2, 4 or 8 bytes; indefinite lengths
+    // (31) are not supported
+    if (info > 27) {
+        _error = true;
+        return false;
+    }
+    size_t size = (size_t)1 << (info - 24);
+    if (size > _len - _pos) {
+        _error = true;
+        return false;
+    }
+
+    value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value = (value << 8) | _data[_pos++];
+    }
+    return true;
+}
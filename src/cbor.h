@@ -0,0 +1,125 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * CBOR Encoding Header
+ *
+ * Minimal CBOR (RFC 8949) writer and reader for compact binary payloads:
+ * - Works on caller-provided buffers, no allocation
+ * - Definite-length maps/arrays only
+ * - Can serialize an ArduinoJson document, so binary endpoints reuse the
+ *   same builders as the REST API
+ */
+
+#ifndef CBOR_H
+#define CBOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// ============================================================================
+// CborWriter Class
+// ============================================================================
+
+class CborWriter {
+public:
+    /**
+     * Constructor
+     * @param buffer Output buffer
+     * @param capacity Output buffer size
+     */
+    CborWriter(uint8_t* buffer, size_t capacity);
+
+    void writeMap(size_t count);
+    void writeArray(size_t count);
+    void writeText(const char* text);
+    void writeText(const char* text, size_t len);
+    void writeBytes(const uint8_t* data, size_t len);
+    void writeUint(uint64_t value);
+    void writeInt(int64_t value);
+    void writeFloat(float value);
+    void writeBool(bool value);
+    void writeNull();
+
+    /**
+     * Serialize an ArduinoJson value (objects, arrays and scalars)
+     */
+    void writeVariant(JsonVariantConst value);
+
+    /**
+     * Get number of bytes written
+     */
+    size_t length() const { return _length; }
+
+    /**
+     * Check if output did not fit in the buffer
+     */
+    bool overflowed() const { return _overflow; }
+
+private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _length;
+    bool _overflow;
+
+    void writeHead(uint8_t majorType, uint64_t value);
+    void writeRaw(const uint8_t* data, size_t len);
+};
+
+// ============================================================================
+// CborReader Class
+// ============================================================================
+
+/**
+ * Pull reader over a CBOR buffer
+ * Each read fails (and the reader stays failed) when the next item is not
+ * of the requested type or would run past the end of the buffer. Strings
+ * point into the buffer and are not null-terminated.
+ */
+class CborReader {
+public:
+    /**
+     * Constructor
+     * @param data Input buffer
+     * @param len Input buffer size
+     */
+    CborReader(const uint8_t* data, size_t len);
+
+    bool readArray(size_t& count);
+    bool readBytes(const uint8_t*& data, size_t& len);
+    bool readText(const char*& text, size_t& len);
+
+    /**
+     * Read an integer or a half, single or double precision float
+     */
+    bool readNumber(float& value);
+
+    /**
+     * Consume the next item if it is null or undefined
+     * @return true if consumed (not an error otherwise)
+     */
+    bool readNull();
+
+    /**
+     * Get the major type of the next item (0xFF at the end)
+     */
+    uint8_t peekType() const;
+
+    /**
+     * Check if the whole buffer has been read
+     */
+    bool atEnd() const { return _pos >= _len; }
+
+    /**
+     * Check if a read failed
+     */
+    bool failed() const { return _error; }
+
+private:
+    const uint8_t* _data;
+    size_t _len;
+    size_t _pos;
+    bool _error;
+
+    bool readHead(uint8_t majorType, uint64_t& value);
+};
+
+#endif // CBOR_H
@@ -0,0 +1,773 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * CoAP Server Implementation
+ */
+
+#include "coap_server.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+#include "cbor.h"
+#include "gzip_encoder.h"
+#include "web_server.h"
+#include "wifi_manager.h"
+
+// Global instance
+CoapServer coapServer;
+
+namespace {
+
+constexpr uint8_t COAP_VERSION = 1;
+constexpr uint8_t COAP_PAYLOAD_MARKER = 0xFF;
+
+// Option numbers (RFC 7252 section 5.10, RFC 7641, RFC 7959)
+constexpr uint16_t OPT_URI_HOST = 3;
+constexpr uint16_t OPT_OBSERVE = 6;
+constexpr uint16_t OPT_URI_PORT = 7;
+constexpr uint16_t OPT_URI_PATH = 11;
+constexpr uint16_t OPT_CONTENT_FORMAT = 12;
+constexpr uint16_t OPT_MAX_AGE = 14;
+constexpr uint16_t OPT_URI_QUERY = 15;
+constexpr uint16_t OPT_ACCEPT = 17;
+constexpr uint16_t OPT_BLOCK2 = 23;
+constexpr uint16_t OPT_SIZE2 = 28;
+
+// Content formats
+constexpr uint16_t FORMAT_LINK = 40;
+constexpr uint16_t FORMAT_CBOR = 60;
+
+constexpr size_t RX_BUFFER_SIZE = 256;
+constexpr size_t TX_BUFFER_SIZE = 48 + (1u << (COAP_BLOCK_SZX + 4));
+constexpr uint8_t MAX_REQUESTS_PER_UPDATE = 8;
+
+const char DISCOVERY_LINKS[] =
+    "</sensors>;ct=60;obs,</status>;ct=60;obs";
+
+uint8_t txBuffer[TX_BUFFER_SIZE];
+
+/**
+ * Encode option header and value, return new position (0 on overflow)
+ */
+size_t putOption(uint8_t* buf, size_t cap, size_t pos, uint16_t& lastNumber,
+                 uint16_t number, const uint8_t* value, uint16_t len) {
+    uint16_t delta = number - lastNumber;
+    lastNumber = number;
+
+    uint8_t ext[4];
+    size_t extLen = 0;
+    uint8_t deltaNibble;
+    uint8_t lenNibble;
+
+    if (delta < 13) {
+        deltaNibble = delta;
+    } else if (delta < 269) {
+        deltaNibble = 13;
+        ext[extLen++] = delta - 13;
+    } else {
+        deltaNibble = 14;
+        ext[extLen++] = (delta - 269) >> 8;
+        ext[extLen++] = (delta - 269) & 0xFF;
+    }
+
+    if (len < 13) {
+        lenNibble = len;
+    } else if (len < 269) {
+        lenNibble = 13;
+        ext[extLen++] = len - 13;
+    } else {
+        lenNibble = 14;
+        ext[extLen++] = (len - 269) >> 8;
+        ext[extLen++] = (len - 269) & 0xFF;
+    }
+
+    if (pos + 1 + extLen + len > cap) {
+        return 0;
+    }
+
+    buf[pos++] = (deltaNibble << 4) | lenNibble;
+    memcpy(buf + pos, ext, extLen);
+    pos += extLen;
+    memcpy(buf + pos, value, len);
+    return pos + len;
+}
+
+size_t putOptionUint(uint8_t* buf, size_t cap, size_t pos, uint16_t& lastNumber,
+                     uint16_t number, uint32_t value) {
+    // Minimal big-endian encoding, zero has no bytes
+    uint8_t bytes[4];
+    uint8_t len = 0;
+    for (int8_t shift = 24; shift >= 0; shift -= 8) {
+        uint8_t b = (uint8_t)(value >> shift);
+        if (len > 0 || b != 0) {
+            bytes[len++] = b;
+        }
+    }
+    return putOption(buf, cap, pos, lastNumber, number, bytes, len);
+}
+
+uint32_t decodeUint(const uint8_t* value, uint16_t len) {
+    uint32_t result = 0;
+    for (uint16_t i = 0; i < len && i < 4; i++) {
+        result = (result << 8) | value[i];
+    }
+    return result;
+}
+
+/**
+ * Point an observer at a sensor; notifications follow its address, so a
+ * rescan that moves the sensor to another index does not redirect them
+ */
+void observeSensor(CoapObserver& o, uint8_t sensorIndex) {
+    o.sensorIndex = sensorIndex;
+    const SensorData* data = sensorManager.getSensorData(sensorIndex);
+    strlcpy(o.sensorAddress, data ? data->addressStr : "", sizeof(o.sensorAddress));
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+CoapServer::CoapServer() :
+    _socket(-1),
+    _payload(nullptr),
+    _payloadLen(0),
+    _payloadResource(CoapResource::NONE),
+    _payloadIndex(0),
+    _payloadGeneration(0),
+    _nextMessageId(0),
+    _observeSequence(0),
+    _lastGeneration(0),
+    _requestCount(0),
+    _notifyCount(0),
+    _reconfigureRequested(false) {
+    memset(_observers, 0, sizeof(_observers));
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void CoapServer::update() {
+    const CoapConfig& config = configManager.getCoapConfig();
+
+    // Handle reconfigure request from web handlers (thread-safe)
+    if (_reconfigureRequested) {
+        _reconfigureRequested = false;
+        closeSocket();
+    }
+
+    if (!config.enabled || !wifiManager.isConnected()) {
+        if (_socket >= 0) {
+            closeSocket();
+        }
+        return;
+    }
+
+    if (_socket < 0 && !openSocket()) {
+        return;
+    }
+
+    pollRequests();
+
+    uint32_t generation = sensorManager.getReadGeneration();
+    if (generation != _lastGeneration) {
+        _lastGeneration = generation;
+        notifyObservers();
+    }
+}
+
+uint8_t CoapServer::getObserverCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        if (_observers[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Socket
+// ============================================================================
+
+bool CoapServer::openSocket() {
+    const CoapConfig& config = configManager.getCoapConfig();
+
+    if (!_payload) {
+        _payload = static_cast<uint8_t*>(malloc(COAP_PAYLOAD_BUFFER_SIZE));
+        if (!_payload) {
+            Serial.println(F("[CoAP] Failed to allocate payload buffer"));
+            return false;
+        }
+    }
+
+    _socket = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket < 0) {
+        Serial.println(F("[CoAP] Failed to create socket"));
+        return false;
+    }
+
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(config.port);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (lwip_bind(_socket, (struct sockaddr*)&local, sizeof(local)) < 0) {
+        Serial.printf("[CoAP] Failed to bind port %u (errno %d)\n", config.port, errno);
+        closeSocket();
+        return false;
+    }
+
+    // Requests are polled from the main loop
+    int flags = lwip_fcntl(_socket, F_GETFL, 0);
+    lwip_fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
+
+    _nextMessageId = (uint16_t)esp_random();
+    _lastGeneration = sensorManager.getReadGeneration();
+    _payloadResource = CoapResource::NONE;
+
+    Serial.printf("[CoAP] Listening on UDP port %u\n", config.port);
+    return true;
+}
+
+void CoapServer::closeSocket() {
+    if (_socket >= 0) {
+        lwip_close(_socket);
+        _socket = -1;
+    }
+
+    // Observers must re-register after the server restarts
+    memset(_observers, 0, sizeof(_observers));
+
+    free(_payload);
+    _payload = nullptr;
+    _payloadResource = CoapResource::NONE;
+}
+
+// ============================================================================
+// Requests
+// ============================================================================
+
+void CoapServer::pollRequests() {
+    uint8_t buffer[RX_BUFFER_SIZE];
+
+    for (uint8_t i = 0; i < MAX_REQUESTS_PER_UPDATE; i++) {
+        struct sockaddr_in from;
+        socklen_t fromLen = sizeof(from);
+
+        int len = lwip_recvfrom(_socket, buffer, sizeof(buffer), 0,
+                                (struct sockaddr*)&from, &fromLen);
+        if (len <= 0) {
+            break;
+        }
+
+        CoapRequest req;
+        if (!parseRequest(buffer, len, req)) {
+            DEBUG_PRINTLN(F("[CoAP] Dropped malformed message"));
+            continue;
+        }
+
+        handleRequest(req, from.sin_addr.s_addr, from.sin_port);
+    }
+}
+
+bool CoapServer::parseRequest(const uint8_t* data, size_t len, CoapRequest& req) {
+    memset(&req, 0, sizeof(req));
+
+    if (len < 4 || (data[0] >> 6) != COAP_VERSION) {
+        return false;
+    }
+
+    req.type = (CoapType)((data[0] >> 4) & 0x03);
+    req.tokenLen = data[0] & 0x0F;
+    req.code = data[1];
+    req.messageId = ((uint16_t)data[2] << 8) | data[3];
+
+    if (req.tokenLen > 8 || 4u + req.tokenLen > len) {
+        return false;
+    }
+    memcpy(req.token, data + 4, req.tokenLen);
+
+    size_t pos = 4 + req.tokenLen;
+    uint16_t number = 0;
+
+    while (pos < len) {
+        if (data[pos] == COAP_PAYLOAD_MARKER) {
+            break;  // Request payloads are not used
+        }
+
+        uint16_t delta = data[pos] >> 4;
+        uint16_t optLen = data[pos] & 0x0F;
+        pos++;
+
+        if (delta == 13) {
+            if (pos >= len) return false;
+            delta = data[pos++] + 13;
+        } else if (delta == 14) {
+            if (pos + 1 >= len) return false;
+            delta = (((uint16_t)data[pos] << 8) | data[pos + 1]) + 269;
+            pos += 2;
+        } else if (delta == 15) {
+            return false;
+        }
+
+        if (optLen == 13) {
+            if (pos >= len) return false;
+            optLen = data[pos++] + 13;
+        } else if (optLen == 14) {
+            if (pos + 1 >= len) return false;
+            optLen = (((uint16_t)data[pos] << 8) | data[pos + 1]) + 269;
+            pos += 2;
+        } else if (optLen == 15) {
+            return false;
+        }
+
+        if (pos + optLen > len) {
+            return false;
+        }
+
+        number += delta;
+        const uint8_t* value = data + pos;
+
+        switch (number) {
+            case OPT_URI_PATH:
+                if (req.pathCount < 2) {
+                    size_t n = optLen < sizeof(req.path[0]) - 1 ? optLen : sizeof(req.path[0]) - 1;
+                    memcpy(req.path[req.pathCount], value, n);
+                    req.path[req.pathCount][n] = '\0';
+                }
+                // Count extra segments so deeper paths do not match
+                if (req.pathCount < 255) {
+                    req.pathCount++;
+                }
+                break;
+            case OPT_OBSERVE:
+                req.hasObserve = true;
+                req.observe = decodeUint(value, optLen);
+                break;
+            case OPT_ACCEPT:
+                req.hasAccept = true;
+                req.accept = decodeUint(value, optLen);
+                break;
+            case OPT_BLOCK2:
+                req.hasBlock2 = true;
+                req.block2 = decodeUint(value, optLen);
+                break;
+            case OPT_URI_HOST:
+            case OPT_URI_PORT:
+            case OPT_URI_QUERY:
+                break;
+            default:
+                // Odd option numbers are critical (RFC 7252 section 5.4.1)
+                if (number & 0x01) {
+                    req.badOption = true;
+                }
+                break;
+        }
+
+        pos += optLen;
+    }
+
+    return true;
+}
+
+void CoapServer::handleRequest(const CoapRequest& req, uint32_t addr, uint16_t port) {
+    // Replies to our confirmable notifications
+    if (req.type == CoapType::ACK || req.type == CoapType::RST) {
+        for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+            CoapObserver& o = _observers[i];
+            if (!o.active || o.addr != addr || o.port != port || o.lastMessageId != req.messageId) {
+                continue;
+            }
+            if (req.type == CoapType::RST) {
+                o.active = false;
+                DEBUG_PRINTLN(F("[CoAP] Observer cancelled (RST)"));
+            } else {
+                o.awaitingAck = false;
+            }
+        }
+        return;
+    }
+
+    // Empty CON is a ping
+    if (req.code == COAP_CODE_EMPTY) {
+        if (req.type == CoapType::CON) {
+            sendEmpty(addr, port, CoapType::RST, req.messageId);
+        }
+        return;
+    }
+
+    // Ignore responses, only requests are accepted
+    if ((req.code >> 5) != 0) {
+        return;
+    }
+
+    _requestCount++;
+
+    CoapType type = req.type == CoapType::CON ? CoapType::ACK : CoapType::NON;
+    uint16_t messageId = req.type == CoapType::CON ? req.messageId : _nextMessageId++;
+    uint8_t errorCode = 0;
+
+    uint8_t sensorIndex = 0;
+    CoapResource resource = resolve(req, sensorIndex);
+    uint16_t format = resource == CoapResource::DISCOVERY ? FORMAT_LINK : FORMAT_CBOR;
+
+    uint32_t blockNum = req.hasBlock2 ? (req.block2 >> 4) : 0;
+    uint8_t szx = req.hasBlock2 ? (req.block2 & 0x07) : COAP_BLOCK_SZX;
+    if (szx > COAP_BLOCK_SZX) {
+        szx = COAP_BLOCK_SZX;
+    }
+
+    if (req.badOption) {
+        errorCode = COAP_CODE_BAD_OPTION;
+    } else if (req.code != COAP_CODE_GET) {
+        errorCode = COAP_CODE_METHOD_NOT_ALLOWED;
+    } else if (resource == CoapResource::NONE) {
+        errorCode = COAP_CODE_NOT_FOUND;
+    } else if (req.hasAccept && req.accept != format) {
+        errorCode = COAP_CODE_NOT_ACCEPTABLE;
+    } else if (req.hasBlock2 && (req.block2 & 0x07) == 7) {
+        errorCode = COAP_CODE_BAD_REQUEST;
+    } else if (!render(resource, sensorIndex)) {
+        errorCode = COAP_CODE_INTERNAL_ERROR;
+    } else if (blockNum > 0 && (blockNum << (szx + 4)) >= _payloadLen) {
+        errorCode = COAP_CODE_BAD_OPTION;
+    }
+
+    if (errorCode != 0) {
+        sendMessage(addr, port, type, errorCode, messageId, req.token, req.tokenLen,
+                    -1, 0, 0, false);
+        return;
+    }
+
+    // Observe registration (RFC 7641 section 4.1)
+    int32_t observe = -1;
+    CoapObserver* existing = findObserver(addr, port, req.token, req.tokenLen);
+
+    if (req.hasObserve && req.observe == 0 && blockNum == 0 && resource != CoapResource::DISCOVERY) {
+        CoapObserver* o = existing ? existing : addObserver(req, addr, port, resource, sensorIndex);
+        if (o) {
+            o->resource = resource;
+            observeSensor(*o, sensorIndex);
+            o->stateHash = stateHash(resource, sensorIndex);
+            o->awaitingAck = false;
+            observe = _observeSequence & 0xFFFFFF;
+        }
+        // Table full: serve the request without Observe
+    } else if (existing && !req.hasBlock2) {
+        // Deregistration, or a plain GET reusing the token
+        existing->active = false;
+    }
+
+    sendMessage(addr, port, type, COAP_CODE_CONTENT, messageId, req.token, req.tokenLen,
+                observe, format, (blockNum << 4) | szx, true);
+}
+
+CoapResource CoapServer::resolve(const CoapRequest& req, uint8_t& sensorIndex) {
+    if (req.pathCount == 1 && strcmp(req.path[0], "sensors") == 0) {
+        return CoapResource::SENSORS;
+    }
+
+    if (req.pathCount == 1 && strcmp(req.path[0], "status") == 0) {
+        return CoapResource::STATUS;
+    }
+
+    if (req.pathCount == 2 && strcmp(req.path[0], ".well-known") == 0 &&
+        strcmp(req.path[1], "core") == 0) {
+        return CoapResource::DISCOVERY;
+    }
+
+    if (req.pathCount == 2 && strcmp(req.path[0], "sensors") == 0) {
+        const char* id = req.path[1];
+        uint8_t count = sensorManager.getSensorCount();
+
+        // Numeric index, as in /api/sensors/{index}
+        bool numeric = id[0] != '\0';
+        for (const char* p = id; *p; p++) {
+            if (!isdigit((unsigned char)*p)) {
+                numeric = false;
+                break;
+            }
+        }
+        if (numeric) {
+            int index = atoi(id);
+            if (index < count) {
+                sensorIndex = index;
+                return CoapResource::SENSOR;
+            }
+            return CoapResource::NONE;
+        }
+
+        // Sensor ROM address
+        for (uint8_t i = 0; i < count; i++) {
+            const SensorData* data = sensorManager.getSensorData(i);
+            if (data && strcasecmp(data->addressStr, id) == 0) {
+                sensorIndex = i;
+                return CoapResource::SENSOR;
+            }
+        }
+    }
+
+    return CoapResource::NONE;
+}
+
+// ============================================================================
+// Representations
+// ============================================================================
+
+bool CoapServer::render(CoapResource resource, uint8_t sensorIndex) {
+    uint32_t generation = sensorManager.getReadGeneration();
+
+    // Reuse within a read cycle so Block2 transfers stay consistent
+    if (_payloadResource == resource && _payloadIndex == sensorIndex &&
+        _payloadGeneration == generation) {
+        return true;
+    }
+
+    _payloadResource = CoapResource::NONE;
+
+    if (resource == CoapResource::DISCOVERY) {
+        _payloadLen = strlen(DISCOVERY_LINKS);
+        memcpy(_payload, DISCOVERY_LINKS, _payloadLen);
+    } else {
+        JsonDocument doc;
+
+        if (resource == CoapResource::SENSORS) {
+            JsonArray sensors = doc.to<JsonArray>();
+            for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+                JsonObject obj = sensors.add<JsonObject>();
+                webServer.buildSensorJson(obj, i);
+            }
+        } else if (resource == CoapResource::SENSOR) {
+            JsonObject obj = doc.to<JsonObject>();
+            webServer.buildSensorJson(obj, sensorIndex);
+        } else {
+            webServer.buildStatusJson(doc);
+        }
+
+        CborWriter writer(_payload, COAP_PAYLOAD_BUFFER_SIZE);
+        writer.writeVariant(doc.as<JsonVariantConst>());
+        if (writer.overflowed()) {
+            Serial.println(F("[CoAP] Representation too large"));
+            return false;
+        }
+        _payloadLen = writer.length();
+    }
+
+    _payloadResource = resource;
+    _payloadIndex = sensorIndex;
+    _payloadGeneration = generation;
+    return true;
+}
+
+uint32_t CoapServer::stateHash(CoapResource resource, uint8_t sensorIndex) {
+    uint8_t count = sensorManager.getSensorCount();
+    uint8_t first = 0;
+    uint8_t last = count;
+
+    if (resource == CoapResource::SENSOR) {
+        first = sensorIndex;
+        last = sensorIndex + 1 < count ? sensorIndex + 1 : count;
+    }
+
+    // Only values a client cares about, not timers like lastReadMs/uptime
+    uint32_t hash = GzipEncoder::crc32(0, &count, sizeof(count));
+    for (uint8_t i = first; i < last; i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        if (!data) {
+            continue;
+        }
+        uint8_t state[4];
+        int16_t value = (int16_t)lroundf(data->temperature * 100.0f);
+        memcpy(state, &value, sizeof(value));
+        state[2] = (uint8_t)data->alarmState;
+        state[3] = data->connected ? 1 : 0;
+        hash = GzipEncoder::crc32(hash, state, sizeof(state));
+    }
+    return hash;
+}
+
+// ============================================================================
+// Observe
+// ============================================================================
+
+void CoapServer::notifyObservers() {
+    uint32_t now = millis();
+
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        CoapObserver& o = _observers[i];
+        if (!o.active) {
+            continue;
+        }
+
+        if (o.awaitingAck && (now - o.confirmSentMs) > COAP_OBSERVE_ACK_TIMEOUT_MS) {
+            o.active = false;
+            DEBUG_PRINTLN(F("[CoAP] Observer timed out"));
+            continue;
+        }
+
+        // Sensor disappeared: final error notification ends the observation
+        if (o.resource == CoapResource::SENSOR) {
+            int8_t index = sensorManager.getSensorIndexByAddress(o.sensorAddress);
+            o.sensorIndex = index >= 0 ? (uint8_t)index : MAX_SENSORS;
+        }
+        if (o.resource == CoapResource::SENSOR && o.sensorIndex >= sensorManager.getSensorCount()) {
+            sendMessage(o.addr, o.port, CoapType::NON, COAP_CODE_NOT_FOUND, _nextMessageId++,
+                        o.token, o.tokenLen, -1, 0, 0, false);
+            o.active = false;
+            continue;
+        }
+
+        uint32_t hash = stateHash(o.resource, o.sensorIndex);
+        if (hash == o.stateHash || !render(o.resource, o.sensorIndex)) {
+            continue;
+        }
+        o.stateHash = hash;
+
+        // Periodically confirmable so dead clients are detected
+        CoapType type = CoapType::NON;
+        if (++o.sinceConfirmable >= COAP_OBSERVE_CON_INTERVAL && !o.awaitingAck) {
+            type = CoapType::CON;
+            o.sinceConfirmable = 0;
+            o.awaitingAck = true;
+            o.confirmSentMs = now;
+        }
+
+        o.lastMessageId = _nextMessageId++;
+        _observeSequence++;
+
+        if (sendMessage(o.addr, o.port, type, COAP_CODE_CONTENT, o.lastMessageId,
+                        o.token, o.tokenLen, _observeSequence & 0xFFFFFF, FORMAT_CBOR,
+                        COAP_BLOCK_SZX, true)) {
+            _notifyCount++;
+        }
+    }
+}
+
+CoapObserver* CoapServer::findObserver(uint32_t addr, uint16_t port,
+                                       const uint8_t* token, uint8_t tokenLen) {
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        CoapObserver& o = _observers[i];
+        if (o.active && o.addr == addr && o.port == port && o.tokenLen == tokenLen &&
+            memcmp(o.token, token, tokenLen) == 0) {
+            return &o;
+        }
+    }
+    return nullptr;
+}
+
+CoapObserver* CoapServer::addObserver(const CoapRequest& req, uint32_t addr, uint16_t port,
+                                      CoapResource resource, uint8_t sensorIndex) {
+    for (uint8_t i = 0; i < COAP_MAX_OBSERVERS; i++) {
+        CoapObserver& o = _observers[i];
+        if (o.active) {
+            continue;
+        }
+
+        memset(&o, 0, sizeof(o));
+        o.active = true;
+        o.addr = addr;
+        o.port = port;
+        memcpy(o.token, req.token, req.tokenLen);
+        o.tokenLen = req.tokenLen;
+        o.resource = resource;
+        observeSensor(o, sensorIndex);
+
+        DEBUG_PRINTF("[CoAP] Observer %u registered\n", i);
+        return &o;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Message Output
+// ============================================================================
+
+bool CoapServer::sendMessage(uint32_t addr, uint16_t port, CoapType type, uint8_t code,
+                             uint16_t messageId, const uint8_t* token, uint8_t tokenLen,
+                             int32_t observe, uint16_t contentFormat, uint32_t block,
+                             bool withPayload) {
+    uint8_t* buf = txBuffer;
+    const size_t cap = sizeof(txBuffer);
+
+    buf[0] = (COAP_VERSION << 6) | ((uint8_t)type << 4) | tokenLen;
+    buf[1] = code;
+    buf[2] = messageId >> 8;
+    buf[3] = messageId & 0xFF;
+    if (tokenLen > 0) {
+        memcpy(buf + 4, token, tokenLen);
+    }
+
+    size_t pos = 4 + tokenLen;
+    uint16_t lastNumber = 0;
+
+    if (observe >= 0) {
+        pos = putOptionUint(buf, cap, pos, lastNumber, OPT_OBSERVE, (uint32_t)observe);
+    }
+
+    const uint8_t* body = nullptr;
+    size_t bodyLen = 0;
+
+    if (withPayload && pos > 0) {
+        pos = putOptionUint(buf, cap, pos, lastNumber, OPT_CONTENT_FORMAT, contentFormat);
+
+        // Readings are fresh until the next read cycle
+        if (pos > 0) {
+            pos = putOptionUint(buf, cap, pos, lastNumber, OPT_MAX_AGE,
+                                configManager.getSystemConfig().readInterval);
+        }
+
+        uint8_t szx = block & 0x07;
+        uint32_t num = block >> 4;
+        size_t blockSize = (size_t)1 << (szx + 4);
+        size_t offset = num * blockSize;
+
+        body = _payload + offset;
+        bodyLen = _payloadLen - offset;
+
+        // Split into blocks only when needed (or when the client asked)
+        if (num > 0 || bodyLen > blockSize) {
+            bool more = bodyLen > blockSize;
+            if (more) {
+                bodyLen = blockSize;
+            }
+            if (pos > 0) {
+                pos = putOptionUint(buf, cap, pos, lastNumber, OPT_BLOCK2,
+                                    (num << 4) | (more ? 0x08 : 0) | szx);
+            }
+            if (pos > 0 && num == 0) {
+                pos = putOptionUint(buf, cap, pos, lastNumber, OPT_SIZE2, _payloadLen);
+            }
+        }
+    }
+
+    if (pos == 0 || pos + 1 + bodyLen > cap) {
+        Serial.println(F("[CoAP] Response too large"));
+        return false;
+    }
+
+    if (bodyLen > 0) {
+        buf[pos++] = COAP_PAYLOAD_MARKER;
+        memcpy(buf + pos, body, bodyLen);
+        pos += bodyLen;
+    }
+
+    struct sockaddr_in dest;
+    memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = port;
+    dest.sin_addr.s_addr = addr;
+
+    int sent = lwip_sendto(_socket, buf, pos, 0, (struct sockaddr*)&dest, sizeof(dest));
+    if (sent != (int)pos) {
+        DEBUG_PRINTF("[CoAP] Send failed (errno %d)\n", errno);
+        return false;
+    }
+    return true;
+}
+
+void CoapServer::sendEmpty(uint32_t addr, uint16_t port, CoapType type, uint16_t messageId) {
+    sendMessage(addr, port, type, COAP_CODE_EMPTY, messageId, nullptr, 0, -1, 0, 0, false);
+}
@@ -0,0 +1,212 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * CoAP Server Header
+ *
+ * Lightweight CoAP (RFC 7252) server for constrained polling clients:
+ * - GET /sensors, /sensors/{index|address}, /status, /.well-known/core
+ * - CBOR payloads built from the same JSON snapshot as the REST API
+ * - Observe (RFC 7641): registered clients are notified when readings change
+ * - Block2 (RFC 7959) for representations larger than one datagram
+ */
+
+#ifndef COAP_SERVER_H
+#define COAP_SERVER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+// ============================================================================
+// Protocol Constants
+// ============================================================================
+
+enum class CoapType : uint8_t {
+    CON = 0,
+    NON = 1,
+    ACK = 2,
+    RST = 3
+};
+
+// Codes are class.detail packed as (class << 5) | detail
+constexpr uint8_t COAP_CODE_EMPTY = 0x00;
+constexpr uint8_t COAP_CODE_GET = 0x01;
+constexpr uint8_t COAP_CODE_CONTENT = 0x45;             // 2.05
+constexpr uint8_t COAP_CODE_BAD_REQUEST = 0x80;         // 4.00
+constexpr uint8_t COAP_CODE_BAD_OPTION = 0x82;          // 4.02
+constexpr uint8_t COAP_CODE_NOT_FOUND = 0x84;           // 4.04
+constexpr uint8_t COAP_CODE_METHOD_NOT_ALLOWED = 0x85;  // 4.05
+constexpr uint8_t COAP_CODE_NOT_ACCEPTABLE = 0x86;      // 4.06
+constexpr uint8_t COAP_CODE_INTERNAL_ERROR = 0xA0;      // 5.00
+
+enum class CoapResource : uint8_t {
+    NONE,
+    SENSORS,
+    SENSOR,
+    STATUS,
+    DISCOVERY
+};
+
+/**
+ * Parsed request (only the options this server understands)
+ */
+struct CoapRequest {
+    CoapType type;
+    uint8_t code;
+    uint16_t messageId;
+    uint8_t token[8];
+    uint8_t tokenLen;
+    char path[2][24];           // First two Uri-Path segments
+    uint8_t pathCount;
+    bool hasObserve;
+    uint32_t observe;
+    bool hasAccept;
+    uint16_t accept;
+    bool hasBlock2;
+    uint32_t block2;
+    bool badOption;             // Unrecognized critical option
+};
+
+/**
+ * Observe registration
+ */
+struct CoapObserver {
+    bool active;
+    uint32_t addr;              // Client address (network byte order)
+    uint16_t port;              // Client port (network byte order)
+    uint8_t token[8];
+    uint8_t tokenLen;
+    CoapResource resource;
+    uint8_t sensorIndex;
+    char sensorAddress[SENSOR_ADDR_STR_LEN];    // Re-resolves sensorIndex after a rescan
+    uint32_t stateHash;         // Hash of the last notified readings
+    uint16_t lastMessageId;     // Message ID of the last notification
+    bool awaitingAck;           // A CON notification is outstanding
+    uint32_t confirmSentMs;     // When the outstanding CON was sent
+    uint8_t sinceConfirmable;   // Notifications since the last CON
+};
+
+// ============================================================================
+// CoapServer Class
+// ============================================================================
+
+class CoapServer {
+public:
+    /**
+     * Constructor
+     */
+    CoapServer();
+
+    /**
+     * Update server (call in main loop)
+     * Handles pending requests and sends Observe notifications
+     */
+    void update();
+
+    /**
+     * Apply changed configuration on next update
+     * Safe to call from async web handlers
+     */
+    void reconfigure() { _reconfigureRequested = true; }
+
+    /**
+     * Check if the server socket is open
+     */
+    bool isActive() const { return _socket >= 0; }
+
+    /**
+     * Get number of requests handled
+     */
+    uint32_t getRequestCount() const { return _requestCount; }
+
+    /**
+     * Get number of notifications sent
+     */
+    uint32_t getNotifyCount() const { return _notifyCount; }
+
+    /**
+     * Get number of active Observe registrations
+     */
+    uint8_t getObserverCount() const;
+
+private:
+    int _socket;
+    uint8_t* _payload;                  // Rendered representation
+    size_t _payloadLen;
+    CoapResource _payloadResource;      // What _payload currently holds
+    uint8_t _payloadIndex;
+    uint32_t _payloadGeneration;
+    uint16_t _nextMessageId;
+    uint32_t _observeSequence;
+    uint32_t _lastGeneration;
+    uint32_t _requestCount;
+    uint32_t _notifyCount;
+    CoapObserver _observers[COAP_MAX_OBSERVERS];
+    volatile bool _reconfigureRequested;
+
+    bool openSocket();
+    void closeSocket();
+
+    /**
+     * Receive and answer all queued datagrams
+     */
+    void pollRequests();
+
+    /**
+     * Parse a datagram into a request
+     * @return false if the message is malformed
+     */
+    bool parseRequest(const uint8_t* data, size_t len, CoapRequest& req);
+
+    /**
+     * Answer one request
+     */
+    void handleRequest(const CoapRequest& req, uint32_t addr, uint16_t port);
+
+    /**
+     * Map Uri-Path to a resource
+     * @return CoapResource::NONE if unknown
+     */
+    CoapResource resolve(const CoapRequest& req, uint8_t& sensorIndex);
+
+    /**
+     * Render a resource into _payload
+     * @return false if rendering failed
+     */
+    bool render(CoapResource resource, uint8_t sensorIndex);
+
+    /**
+     * Hash of the readings a resource depends on (change detection)
+     */
+    uint32_t stateHash(CoapResource resource, uint8_t sensorIndex);
+
+    /**
+     * Send notifications to observers whose resource changed
+     */
+    void notifyObservers();
+
+    CoapObserver* findObserver(uint32_t addr, uint16_t port, const uint8_t* token, uint8_t tokenLen);
+    CoapObserver* addObserver(const CoapRequest& req, uint32_t addr, uint16_t port,
+                              CoapResource resource, uint8_t sensorIndex);
+
+    /**
+     * Build and send a response or notification
+     * @param observe Observe option value, or -1 for none
+     * @param block Block2 value to send from _payload (num << 4 | szx)
+     * @param withPayload Attach _payload (false for error responses)
+     * @return true if the datagram was sent
+     */
+    bool sendMessage(uint32_t addr, uint16_t port, CoapType type, uint8_t code,
+                     uint16_t messageId, const uint8_t* token, uint8_t tokenLen,
+                     int32_t observe, uint16_t contentFormat, uint32_t block, bool withPayload);
+
+    /**
+     * Send an empty ACK/RST
+     */
+    void sendEmpty(uint32_t addr, uint16_t port, CoapType type, uint16_t messageId);
+};
+
+// Global CoAP server instance
+extern CoapServer coapServer;
+
+#endif // COAP_SERVER_H
@@ -38,6 +38,31 @@
 // DS18B20 OneWire bus pin
 constexpr uint8_t ONEWIRE_PIN = 13;  // GPIO13 - Connect all DS18B20 data pins here
 
+// ONEWIRE_USE_RMT is set via build_flags in platformio.ini
+// Set to 1 to drive the bus with the RMT peripheral instead of bit-banging
+// it with interrupts disabled (falls back to bit-banging if RMT setup fails
+// or a parasite-powered sensor is found)
+#ifndef ONEWIRE_USE_RMT
+#define ONEWIRE_USE_RMT 0
+#endif
+
+// RMT channels for the bus (the RX channel uses two memory blocks)
+constexpr uint8_t ONEWIRE_RMT_TX_CHANNEL = 0;
+constexpr uint8_t ONEWIRE_RMT_RX_CHANNEL = 2;
+
+// MAX31855 thermocouple converters on the HSPI bus (read-only, no MOSI)
+// One chip-select pin per converter; -1 = none fitted
+constexpr int8_t PROBE_SPI_SCK_PIN = 26;
+constexpr int8_t PROBE_SPI_MISO_PIN = 25;
+constexpr int8_t MAX31855_CS_PINS[] = {-1};
+
+// SIMULATE_SENSORS is set via build_flags in platformio.ini
+// Set to 1 to add simulated probes (no hardware needed), which follow a
+// slow sine wave, mimic each probe type's resolution and inject read errors
+#ifndef SIMULATE_SENSORS
+#define SIMULATE_SENSORS 0
+#endif
+
 // Status LED pin (not available on TTGO T-Display, display used instead)
 constexpr uint8_t LED_PIN = 2;
 
@@ -62,9 +87,53 @@ constexpr uint8_t SENSOR_ADDR_STR_LEN = 17;
 // 12-bit = 0.0625°C resolution, ~750ms conversion time
 constexpr uint8_t SENSOR_RESOLUTION = 12;
 
+// Simulated probes (SIMULATE_SENSORS): OneWire devices (at most 8) and
+// MAX31855 chips, conversion time (ms) and one corrupted transfer in
+// every SIMULATED_ERROR_EVERY
+constexpr uint8_t SIMULATED_SENSOR_COUNT = 3;
+constexpr uint8_t SIMULATED_THERMOCOUPLE_COUNT = 2;
+constexpr uint16_t SIMULATED_CONVERSION_MS = 100;
+constexpr uint16_t SIMULATED_ERROR_EVERY = 50;
+
+// Polling a powered OneWire bus for conversion done (ms between polls,
+// starting at half the worst-case conversion time)
+constexpr uint16_t DS18X20_READY_POLL_MS = 20;
+
+// ROM searches per update() during a background rescan (~15 ms each)
+constexpr uint8_t DISCOVERY_STEPS_PER_UPDATE = 2;
+
+// Restarts of a discovery pass cut short by a bus error (CRC, lost
+// presence) before it is abandoned and the sensor table left as it was
+constexpr uint8_t DISCOVERY_MAX_RESTARTS = 3;
+
+// Hardware alarm mode: default read cycles between reads of an in-range
+// sensor (out-of-range sensors are found by Alarm Search every cycle)
+constexpr uint8_t DEFAULT_IN_RANGE_READ_EVERY = 6;
+
+// Default EMA smoothing weight of a new reading, in 1/256 (64 = 0.25)
+constexpr uint8_t DEFAULT_FILTER_ALPHA = 64;
+
+// Immediate scratchpad re-reads after a presence or CRC failure: per sensor,
+// and for the whole read cycle (bounds the time one cycle can spend on retries)
+constexpr uint8_t READ_MAX_RETRIES = 2;
+constexpr uint8_t READ_RETRY_BUDGET = 6;
+
+// Bus diagnostics: error rate (0..1, over the last 32 reads of a sensor)
+// at which the sensor is listed on the display ALERTS page
+constexpr float BUS_ERROR_RATE_WARN = 0.05f;
+
 // Invalid temperature marker
 constexpr float TEMP_INVALID = -127.0f;
 
+// Virtual (computed) sensors share the MAX_SENSORS slots with physical ones
+constexpr uint8_t MAX_VIRTUAL_SENSORS = 4;
+
+// Maximum number of input sensors per virtual sensor
+constexpr uint8_t VIRTUAL_SENSOR_MAX_INPUTS = 4;
+
+// Heat flow of water per L/min and Kelvin (kW): 4.186 kJ/(kg*K) / 60 s
+constexpr float WATER_HEAT_FLOW_KW_PER_LPM_K = 0.06977f;
+
 // ============================================================================
 // WiFi Configuration
 // ============================================================================
@@ -99,6 +168,174 @@ constexpr uint32_t MQTT_RECONNECT_INTERVAL = 5000;
 // MQTT keep alive (seconds)
 constexpr uint16_t MQTT_KEEP_ALIVE = 60;
 
+// Bus diagnostics publish interval (ms)
+constexpr uint32_t MQTT_DIAGNOSTICS_INTERVAL = 60000;
+
+// ============================================================================
+// UDP Telemetry Configuration
+// ============================================================================
+
+// Default multicast group and port for LAN telemetry datagrams
+// 239.255.0.0/16 is the organization-local scope (not routed off-site)
+constexpr char UDP_TELEMETRY_DEFAULT_GROUP[] = "239.255.77.77";
+constexpr uint16_t UDP_TELEMETRY_DEFAULT_PORT = 47700;
+
+// ============================================================================
+// Hub Mode Configuration
+// ============================================================================
+
+// Remote sensors not heard from within this time are marked disconnected (s)
+constexpr uint16_t HUB_DEFAULT_TIMEOUT_S = 60;
+
+// Peer stations tracked for loss and status reporting
+constexpr uint8_t HUB_MAX_PEERS = 8;
+
+// Datagrams handled per update() call (bounds time spent in the main loop)
+constexpr uint8_t HUB_MAX_DATAGRAMS_PER_UPDATE = 8;
+
+// ============================================================================
+// Sensor Ingestion Configuration
+// ============================================================================
+
+// External sensors not heard from within this time are marked disconnected (s)
+// Battery satellites report rarely, so this is longer than the hub timeout
+constexpr uint16_t INGEST_DEFAULT_TIMEOUT_S = 900;
+
+// Largest accepted message (bytes, HTTP body or MQTT payload)
+constexpr size_t INGEST_MAX_MESSAGE_SIZE = 512;
+
+// Readings accepted per message
+constexpr uint8_t INGEST_MAX_READINGS = MAX_SENSORS;
+
+// Readings waiting to be applied by the main loop
+constexpr uint8_t INGEST_QUEUE_SIZE = 2 * MAX_SENSORS;
+
+// ============================================================================
+// CoAP Server Configuration
+// ============================================================================
+
+// Default CoAP UDP port (RFC 7252)
+constexpr uint16_t COAP_DEFAULT_PORT = 5683;
+
+// Maximum number of Observe registrations
+constexpr uint8_t COAP_MAX_OBSERVERS = 8;
+
+// Encoded representation buffer (bytes, split into blocks when larger)
+constexpr size_t COAP_PAYLOAD_BUFFER_SIZE = 3072;
+
+// Block2 size exponent: block size = 2^(SZX+4), 6 = 1024 bytes
+constexpr uint8_t COAP_BLOCK_SZX = 6;
+
+// Every Nth notification is confirmable to check the observer is alive
+constexpr uint8_t COAP_OBSERVE_CON_INTERVAL = 16;
+
+// Observers that do not acknowledge a CON notification within this time
+// are removed (ms, RFC 7252 MAX_TRANSMIT_WAIT)
+constexpr uint32_t COAP_OBSERVE_ACK_TIMEOUT_MS = 93000;
+
+// ============================================================================
+// mDNS Advertisement
+// ============================================================================
+
+// Service advertised for fleet discovery (_tempmon._tcp)
+constexpr char MDNS_SERVICE_NAME[] = "tempmon";
+
+// The generation TXT record changes every read cycle: re-announce it at
+// most this often (sensor and alarm counts are announced on change)
+constexpr uint32_t MDNS_GENERATION_INTERVAL_MS = 60000;
+
+// Retry interval after the responder failed to start (ms)
+constexpr uint32_t MDNS_RETRY_INTERVAL_MS = 30000;
+
+// ============================================================================
+// InfluxDB Export Configuration
+// ============================================================================
+
+// Default measurement name for exported readings
+constexpr char INFLUX_DEFAULT_MEASUREMENT[] = "temperature";
+
+// Default batch window (seconds)
+constexpr uint16_t INFLUX_DEFAULT_BATCH_WINDOW = 30;
+
+// Line-protocol buffer size (bytes, two buffers: filling + in flight)
+// ~100 bytes per line: holds ~4 minutes of 10 sensors at 2s interval
+constexpr size_t INFLUX_BUFFER_SIZE = 4096;
+
+// HTTP request timeout (ms)
+constexpr uint32_t INFLUX_HTTP_TIMEOUT_MS = 10000;
+
+// Retry backoff after a failed POST (ms, doubles per failure)
+constexpr uint32_t INFLUX_RETRY_MIN_MS = 5000;
+constexpr uint32_t INFLUX_RETRY_MAX_MS = 300000;
+
+// ============================================================================
+// Webhook Notification Configuration
+// ============================================================================
+
+// Maximum number of webhook endpoints
+constexpr uint8_t MAX_WEBHOOKS = 3;
+
+// Endpoint URL, Authorization header and body template maximum lengths
+constexpr uint8_t WEBHOOK_URL_MAX_LEN = 160;
+constexpr uint8_t WEBHOOK_AUTH_MAX_LEN = 100;
+constexpr uint16_t WEBHOOK_TEMPLATE_MAX_LEN = 320;
+
+// Default minimum interval between POSTs to one endpoint (seconds)
+constexpr uint16_t WEBHOOK_DEFAULT_MIN_INTERVAL = 10;
+
+// Event types an endpoint can subscribe to (bitmask)
+constexpr uint8_t WEBHOOK_EVENT_ALARM = 0x01;
+constexpr uint8_t WEBHOOK_EVENT_CLEAR = 0x02;
+
+// Pending deliveries (event x endpoint); oldest is dropped when full
+constexpr uint8_t NOTIFY_QUEUE_SIZE = 16;
+
+// Rendered request body buffer (bytes)
+constexpr size_t NOTIFY_BODY_MAX_LEN = 768;
+
+// Delivery attempts before an event is given up
+constexpr uint8_t NOTIFY_MAX_ATTEMPTS = 6;
+
+// HTTP request timeout (ms)
+constexpr uint32_t NOTIFY_HTTP_TIMEOUT_MS = 5000;
+
+// Retry backoff after a failed POST (ms, doubles per attempt)
+constexpr uint32_t NOTIFY_RETRY_MIN_MS = 5000;
+constexpr uint32_t NOTIFY_RETRY_MAX_MS = 300000;
+
+// ============================================================================
+// Battery (Deep Sleep) Mode Configuration
+// ============================================================================
+
+// SIMULATE_DEEP_SLEEP is set via build_flags in platformio.ini
+// Set to 1 to run the wake cycle in a loop with delay() instead of powering
+// down, so sampling, flushing and the duty-cycle metrics can be traced on serial
+#ifndef SIMULATE_DEEP_SLEEP
+#define SIMULATE_DEEP_SLEEP 0
+#endif
+
+// Default time asleep between wakes (seconds)
+constexpr uint16_t DEFAULT_SLEEP_INTERVAL = 300;
+
+// Default number of wakes between WiFi flushes
+constexpr uint8_t DEFAULT_SLEEP_FLUSH_EVERY = 12;
+
+// Samples buffered in RTC memory (one per wake, oldest overwritten when full)
+constexpr uint16_t SLEEP_BUFFER_SAMPLES = 96;
+
+// Normal operation after power-on before the first sleep (ms), so the
+// device can still be configured over the web UI
+constexpr uint32_t SLEEP_CONFIG_WINDOW_MS = 300000;
+
+// Longest a wake waits for a sensor conversion (ms)
+constexpr uint32_t SLEEP_READ_TIMEOUT_MS = 2000;
+
+// Longest a flush waits for WiFi and MQTT (ms)
+constexpr uint32_t SLEEP_FLUSH_TIMEOUT_MS = 20000;
+
+// Samples per MQTT batch message (keeps messages within the client buffer)
+constexpr uint8_t SLEEP_SAMPLES_PER_MESSAGE = 6;
+
 // ============================================================================
 // Web Server Configuration
 // ============================================================================
@@ -106,6 +343,17 @@ constexpr uint16_t MQTT_KEEP_ALIVE = 60;
 // Web server port
 constexpr uint16_t WEB_SERVER_PORT = 80;
 
+// JSON responses at least this large are gzipped for clients that accept
+// it (0 = never); the encoder needs ~5KB plus the output while it runs
+constexpr size_t HTTP_GZIP_MIN_SIZE = 1024;
+
+// Long-poll on /api/sensors?since=: longest hold and most held at once
+constexpr uint16_t LONGPOLL_MAX_WAIT_S = 25;
+constexpr uint8_t LONGPOLL_MAX_WAITERS = 4;
+
+// Extra RX timeout on a held long-poll connection beyond its wait (s)
+constexpr uint16_t LONGPOLL_RX_MARGIN_S = 15;
+
 // ============================================================================
 // Timing Configuration
 // ============================================================================
@@ -145,6 +393,33 @@ constexpr float DEFAULT_THRESHOLD_HIGH = 80.0f;
 // Threshold hysteresis to prevent rapid alarm toggling
 constexpr float THRESHOLD_HYSTERESIS = 1.0f;
 
+// Default alarm entry/exit delays in seconds (0 = react to the first sample)
+constexpr uint16_t DEFAULT_ALARM_ENTRY_DELAY = 0;
+constexpr uint16_t DEFAULT_ALARM_EXIT_DELAY = 0;
+
+// Upper bound for configurable alarm delays (seconds)
+constexpr uint16_t ALARM_DELAY_MAX = 3600;
+
+// ============================================================================
+// Alarm Rule Configuration
+// ============================================================================
+
+// Maximum number of alarm rules
+constexpr uint8_t MAX_ALARM_RULES = 8;
+
+// Rule name and expression maximum lengths
+constexpr uint8_t ALARM_RULE_NAME_MAX_LEN = 24;
+constexpr uint8_t ALARM_RULE_EXPR_MAX_LEN = 96;
+
+// Compiled rule limits (bound the per-cycle evaluation cost)
+constexpr uint8_t ALARM_RULE_MAX_CODE = 64;        // Bytecode bytes
+constexpr uint8_t ALARM_RULE_MAX_REFS = 4;         // Distinct sensors referenced
+constexpr uint8_t ALARM_RULE_MAX_TIMERS = 4;       // "for" durations
+constexpr uint8_t ALARM_RULE_STACK_DEPTH = 8;
+
+// Window over which rate() is measured (reported per minute)
+constexpr uint32_t ALARM_RULE_RATE_WINDOW_MS = 60000;
+
 // ============================================================================
 // File Paths (SPIFFS)
 // ============================================================================
@@ -158,6 +433,10 @@ constexpr char CONFIG_FILE_PATH[] = "/config.json";
 constexpr char NTP_SERVER[] = "pool.ntp.org";
 constexpr long NTP_UTC_OFFSET = 0;  // UTC offset in seconds
 
+// The clock counts as synchronised once time() is past 2020-09-13;
+// before the first NTP sync it counts up from 0 at boot
+constexpr time_t MIN_VALID_EPOCH = 1600000000;
+
 // ============================================================================
 // Version Information
 // ============================================================================
@@ -11,6 +11,38 @@ constexpr const char* PREFS_NS = "tempmon";
 constexpr const char* PREFS_KEY = "cfg";
 constexpr uint32_t CFG_MAGIC = 0x544D4346; // 'TMCF'
 constexpr uint16_t CFG_VERSION = 1;
+
+constexpr uint32_t SECTION_MAGIC = 0x54534543; // 'TSEC'
+constexpr const char* SECTION_KEY_UDP = "udp";
+constexpr uint16_t SECTION_VERSION_UDP = 1;
+constexpr const char* SECTION_KEY_COAP = "coap";
+constexpr uint16_t SECTION_VERSION_COAP = 1;
+constexpr const char* SECTION_KEY_INFLUX = "influx";
+constexpr uint16_t SECTION_VERSION_INFLUX = 1;
+constexpr const char* SECTION_KEY_VIRTUAL = "virtual";
+constexpr uint16_t SECTION_VERSION_VIRTUAL = 1;
+constexpr const char* SECTION_KEY_RULES = "rules";
+constexpr uint16_t SECTION_VERSION_RULES = 1;
+constexpr const char* SECTION_KEY_ALARM = "alarm";
+constexpr uint16_t SECTION_VERSION_ALARM = 1;
+constexpr const char* SECTION_KEY_WEBHOOKS = "webhooks";
+constexpr uint16_t SECTION_VERSION_WEBHOOKS = 1;
+constexpr const char* SECTION_KEY_POWER = "power";
+constexpr uint16_t SECTION_VERSION_POWER = 1;
+constexpr const char* SECTION_KEY_BUS = "bus";
+constexpr uint16_t SECTION_VERSION_BUS = 1;
+constexpr const char* SECTION_KEY_FILTER = "filter";
+constexpr uint16_t SECTION_VERSION_FILTER = 1;
+constexpr const char* SECTION_KEY_HUB = "hub";
+constexpr uint16_t SECTION_VERSION_HUB = 1;
+constexpr const char* SECTION_KEY_INGEST = "ingest";
+constexpr uint16_t SECTION_VERSION_INGEST = 1;
+
+struct SectionHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+};
 }
 
 // Global instance
@@ -60,11 +92,17 @@ bool ConfigManager::begin() {
         }
     }
     
+    loadSections();
+    
     return true;
 }
 
 bool ConfigManager::load() {
-    return loadFromNVS();
+    if (!loadFromNVS()) {
+        return false;
+    }
+    loadSections();
+    return true;
 }
 
 bool ConfigManager::save() {
@@ -75,9 +113,30 @@ void ConfigManager::resetToDefaults() {
     _wifiConfig = WiFiConfig();
     _mqttConfig = MQTTConfig();
     _systemConfig = SystemConfig();
+    _udpConfig = UdpTelemetryConfig();
+    _hubConfig = HubConfig();
+    _ingestConfig = IngestConfig();
+    _coapConfig = CoapConfig();
+    _influxConfig = InfluxConfig();
+    _powerConfig = PowerConfig();
+    _busConfig = BusConfig();
+    
+    for (uint8_t i = 0; i < MAX_WEBHOOKS; i++) {
+        _webhooks[i] = WebhookConfig();
+    }
+    
+    for (uint8_t i = 0; i < MAX_VIRTUAL_SENSORS; i++) {
+        _virtualSensors[i] = VirtualSensorDef();
+    }
+    
+    for (uint8_t i = 0; i < MAX_ALARM_RULES; i++) {
+        _alarmRules[i] = AlarmRuleDef();
+    }
     
     for (uint8_t i = 0; i < MAX_SENSORS; i++) {
         _sensorConfigs[i] = SensorConfig();
+        _sensorAlarmConfigs[i] = SensorAlarmConfig();
+        _sensorFilterConfigs[i] = SensorFilterConfig();
     }
     
     _isDirty = true;
@@ -138,6 +197,11 @@ bool ConfigManager::saveToNVS() {
         Serial.println(F("[ConfigManager] Failed to write NVS config"));
         return false;
     }
+    
+    if (!saveSections()) {
+        Serial.println(F("[ConfigManager] Failed to write NVS config sections"));
+        return false;
+    }
 
     Serial.println(F("[ConfigManager] Configuration saved to NVS"));
     _isDirty = false;
@@ -173,6 +237,121 @@ bool ConfigManager::loadLegacyFromSPIFFS() {
     return true;
 }
 
+bool ConfigManager::loadSection(const char* key, uint16_t version, void* data, size_t size) {
+    if (!_initialized || !_prefsOpen || !key || !data) {
+        return false;
+    }
+    
+    size_t len = _prefs.getBytesLength(key);
+    if (len != sizeof(SectionHeader) + size) {
+        return false;
+    }
+    
+    uint8_t* buffer = (uint8_t*)malloc(len);
+    if (!buffer) {
+        return false;
+    }
+    
+    bool ok = false;
+    if (_prefs.getBytes(key, buffer, len) == len) {
+        SectionHeader header;
+        memcpy(&header, buffer, sizeof(header));
+        if (header.magic == SECTION_MAGIC && header.version == version && header.size == size) {
+            memcpy(data, buffer + sizeof(header), size);
+            ok = true;
+        }
+    }
+    
+    free(buffer);
+    return ok;
+}
+
+bool ConfigManager::saveSection(const char* key, uint16_t version, const void* data, size_t size) {
+    if (!_initialized || !_prefsOpen || !key || !data || size > UINT16_MAX) {
+        return false;
+    }
+    
+    size_t len = sizeof(SectionHeader) + size;
+    uint8_t* buffer = (uint8_t*)malloc(len);
+    if (!buffer) {
+        return false;
+    }
+    
+    SectionHeader header{SECTION_MAGIC, version, (uint16_t)size};
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), data, size);
+    
+    size_t written = _prefs.putBytes(key, buffer, len);
+    free(buffer);
+    return written == len;
+}
+
+void ConfigManager::loadSections() {
+    // Missing or outdated sections fall back to defaults individually
+    if (!loadSection(SECTION_KEY_UDP, SECTION_VERSION_UDP, &_udpConfig, sizeof(_udpConfig))) {
+        _udpConfig = UdpTelemetryConfig();
+    }
+    if (!loadSection(SECTION_KEY_HUB, SECTION_VERSION_HUB, &_hubConfig, sizeof(_hubConfig))) {
+        _hubConfig = HubConfig();
+    }
+    if (!loadSection(SECTION_KEY_INGEST, SECTION_VERSION_INGEST, &_ingestConfig, sizeof(_ingestConfig))) {
+        _ingestConfig = IngestConfig();
+    }
+    if (!loadSection(SECTION_KEY_COAP, SECTION_VERSION_COAP, &_coapConfig, sizeof(_coapConfig))) {
+        _coapConfig = CoapConfig();
+    }
+    if (!loadSection(SECTION_KEY_INFLUX, SECTION_VERSION_INFLUX, &_influxConfig, sizeof(_influxConfig))) {
+        _influxConfig = InfluxConfig();
+    }
+    if (!loadSection(SECTION_KEY_VIRTUAL, SECTION_VERSION_VIRTUAL, _virtualSensors, sizeof(_virtualSensors))) {
+        for (uint8_t i = 0; i < MAX_VIRTUAL_SENSORS; i++) {
+            _virtualSensors[i] = VirtualSensorDef();
+        }
+    }
+    if (!loadSection(SECTION_KEY_RULES, SECTION_VERSION_RULES, _alarmRules, sizeof(_alarmRules))) {
+        for (uint8_t i = 0; i < MAX_ALARM_RULES; i++) {
+            _alarmRules[i] = AlarmRuleDef();
+        }
+    }
+    if (!loadSection(SECTION_KEY_ALARM, SECTION_VERSION_ALARM, _sensorAlarmConfigs, sizeof(_sensorAlarmConfigs))) {
+        for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+            _sensorAlarmConfigs[i] = SensorAlarmConfig();
+        }
+    }
+    if (!loadSection(SECTION_KEY_FILTER, SECTION_VERSION_FILTER, _sensorFilterConfigs, sizeof(_sensorFilterConfigs))) {
+        for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+            _sensorFilterConfigs[i] = SensorFilterConfig();
+        }
+    }
+    if (!loadSection(SECTION_KEY_POWER, SECTION_VERSION_POWER, &_powerConfig, sizeof(_powerConfig))) {
+        _powerConfig = PowerConfig();
+    }
+    if (!loadSection(SECTION_KEY_BUS, SECTION_VERSION_BUS, &_busConfig, sizeof(_busConfig))) {
+        _busConfig = BusConfig();
+    }
+    if (!loadSection(SECTION_KEY_WEBHOOKS, SECTION_VERSION_WEBHOOKS, _webhooks, sizeof(_webhooks))) {
+        for (uint8_t i = 0; i < MAX_WEBHOOKS; i++) {
+            _webhooks[i] = WebhookConfig();
+        }
+    }
+}
+
+bool ConfigManager::saveSections() {
+    bool ok = saveSection(SECTION_KEY_UDP, SECTION_VERSION_UDP, &_udpConfig, sizeof(_udpConfig));
+    ok &= saveSection(SECTION_KEY_HUB, SECTION_VERSION_HUB, &_hubConfig, sizeof(_hubConfig));
+    ok &= saveSection(SECTION_KEY_INGEST, SECTION_VERSION_INGEST, &_ingestConfig, sizeof(_ingestConfig));
+    ok &= saveSection(SECTION_KEY_COAP, SECTION_VERSION_COAP, &_coapConfig, sizeof(_coapConfig));
+    ok &= saveSection(SECTION_KEY_INFLUX, SECTION_VERSION_INFLUX, &_influxConfig, sizeof(_influxConfig));
+    ok &= saveSection(SECTION_KEY_VIRTUAL, SECTION_VERSION_VIRTUAL, _virtualSensors, sizeof(_virtualSensors));
+    ok &= saveSection(SECTION_KEY_RULES, SECTION_VERSION_RULES, _alarmRules, sizeof(_alarmRules));
+    ok &= saveSection(SECTION_KEY_ALARM, SECTION_VERSION_ALARM, _sensorAlarmConfigs, sizeof(_sensorAlarmConfigs));
+    ok &= saveSection(SECTION_KEY_FILTER, SECTION_VERSION_FILTER, _sensorFilterConfigs, sizeof(_sensorFilterConfigs));
+    ok &= saveSection(SECTION_KEY_WEBHOOKS, SECTION_VERSION_WEBHOOKS, _webhooks, sizeof(_webhooks));
+    ok &= saveSection(SECTION_KEY_POWER, SECTION_VERSION_POWER, &_powerConfig, sizeof(_powerConfig));
+    ok &= saveSection(SECTION_KEY_BUS, SECTION_VERSION_BUS, &_busConfig, sizeof(_busConfig));
+    return ok;
+}
+
 SensorConfig* ConfigManager::getSensorConfig(uint8_t index) {
     if (index >= MAX_SENSORS) {
         return nullptr;
@@ -217,6 +396,68 @@ const SensorConfig* ConfigManager::getSensorConfigByAddress(const char* address)
     return nullptr;
 }
 
+SensorAlarmConfig* ConfigManager::getSensorAlarmConfig(const char* address) {
+    SensorConfig* config = getSensorConfigByAddress(address);
+    return config ? &_sensorAlarmConfigs[config - _sensorConfigs] : nullptr;
+}
+
+const SensorAlarmConfig* ConfigManager::getSensorAlarmConfig(const char* address) const {
+    const SensorConfig* config = getSensorConfigByAddress(address);
+    return config ? &_sensorAlarmConfigs[config - _sensorConfigs] : nullptr;
+}
+
+SensorFilterConfig* ConfigManager::getSensorFilterConfig(const char* address) {
+    SensorConfig* config = getSensorConfigByAddress(address);
+    return config ? &_sensorFilterConfigs[config - _sensorConfigs] : nullptr;
+}
+
+const SensorFilterConfig* ConfigManager::getSensorFilterConfig(const char* address) const {
+    const SensorConfig* config = getSensorConfigByAddress(address);
+    return config ? &_sensorFilterConfigs[config - _sensorConfigs] : nullptr;
+}
+
+VirtualSensorDef* ConfigManager::getVirtualSensorDef(uint8_t slot) {
+    if (slot >= MAX_VIRTUAL_SENSORS) {
+        return nullptr;
+    }
+    return &_virtualSensors[slot];
+}
+
+const VirtualSensorDef* ConfigManager::getVirtualSensorDef(uint8_t slot) const {
+    if (slot >= MAX_VIRTUAL_SENSORS) {
+        return nullptr;
+    }
+    return &_virtualSensors[slot];
+}
+
+WebhookConfig* ConfigManager::getWebhookConfig(uint8_t slot) {
+    if (slot >= MAX_WEBHOOKS) {
+        return nullptr;
+    }
+    return &_webhooks[slot];
+}
+
+const WebhookConfig* ConfigManager::getWebhookConfig(uint8_t slot) const {
+    if (slot >= MAX_WEBHOOKS) {
+        return nullptr;
+    }
+    return &_webhooks[slot];
+}
+
+AlarmRuleDef* ConfigManager::getAlarmRuleDef(uint8_t slot) {
+    if (slot >= MAX_ALARM_RULES) {
+        return nullptr;
+    }
+    return &_alarmRules[slot];
+}
+
+const AlarmRuleDef* ConfigManager::getAlarmRuleDef(uint8_t slot) const {
+    if (slot >= MAX_ALARM_RULES) {
+        return nullptr;
+    }
+    return &_alarmRules[slot];
+}
+
 SensorConfig* ConfigManager::findOrCreateSensorConfig(const char* address) {
     // First, try to find existing config
     SensorConfig* existing = getSensorConfigByAddress(address);
@@ -234,6 +475,8 @@ SensorConfig* ConfigManager::findOrCreateSensorConfig(const char* address) {
             snprintf(_sensorConfigs[i].name, SENSOR_NAME_MAX_LEN, "Sensor %d", i + 1);
             
             _sensorConfigs[i].isConfigured = true;
+            _sensorAlarmConfigs[i] = SensorAlarmConfig();
+            _sensorFilterConfigs[i] = SensorFilterConfig();
             _isDirty = true;
             
             return &_sensorConfigs[i];
@@ -244,6 +487,16 @@ SensorConfig* ConfigManager::findOrCreateSensorConfig(const char* address) {
     return nullptr;
 }
 
+void ConfigManager::removeSensorConfig(const char* address) {
+    SensorConfig* config = getSensorConfigByAddress(address);
+    if (config) {
+        _sensorAlarmConfigs[config - _sensorConfigs] = SensorAlarmConfig();
+        _sensorFilterConfigs[config - _sensorConfigs] = SensorFilterConfig();
+        *config = SensorConfig();
+        _isDirty = true;
+    }
+}
+
 uint8_t ConfigManager::getConfiguredSensorCount() const {
     uint8_t count = 0;
     for (uint8_t i = 0; i < MAX_SENSORS; i++) {
@@ -287,13 +540,99 @@ void ConfigManager::toJson(JsonDocument& doc) const {
     mqtt["publishThreshold"] = _mqttConfig.publishThreshold;
     mqtt["publishInterval"] = _mqttConfig.publishInterval;
     
+    // UDP telemetry configuration
+    JsonObject udp = doc["udp"].to<JsonObject>();
+    udp["enabled"] = _udpConfig.enabled;
+    udp["group"] = _udpConfig.group;
+    udp["port"] = _udpConfig.port;
+    udp["ttl"] = _udpConfig.ttl;
+    
+    // Hub mode configuration
+    JsonObject hub = doc["hub"].to<JsonObject>();
+    hub["enabled"] = _hubConfig.enabled;
+    hub["timeout"] = _hubConfig.timeout;
+    
+    // Sensor ingestion configuration
+    JsonObject ingest = doc["ingest"].to<JsonObject>();
+    ingest["enabled"] = _ingestConfig.enabled;
+    ingest["timeout"] = _ingestConfig.timeout;
+    
+    // CoAP server configuration
+    JsonObject coap = doc["coap"].to<JsonObject>();
+    coap["enabled"] = _coapConfig.enabled;
+    coap["port"] = _coapConfig.port;
+    
+    // InfluxDB export configuration
+    JsonObject influx = doc["influx"].to<JsonObject>();
+    influx["enabled"] = _influxConfig.enabled;
+    influx["url"] = _influxConfig.url;
+    influx["token"] = _influxConfig.token;
+    influx["measurement"] = _influxConfig.measurement;
+    influx["batchWindow"] = _influxConfig.batchWindow;
+    influx["gzip"] = _influxConfig.gzip;
+    
+    // Battery mode configuration
+    JsonObject power = doc["power"].to<JsonObject>();
+    power["batteryMode"] = _powerConfig.batteryMode;
+    power["sleepInterval"] = _powerConfig.sleepInterval;
+    power["flushEvery"] = _powerConfig.flushEvery;
+    
+    // OneWire bus configuration
+    JsonObject bus = doc["bus"].to<JsonObject>();
+    bus["hardwareAlarms"] = _busConfig.hardwareAlarms;
+    bus["inRangeReadEvery"] = _busConfig.inRangeReadEvery;
+    
+    // Webhook endpoints (slot position is significant)
+    JsonArray webhooks = doc["webhooks"].to<JsonArray>();
+    for (uint8_t i = 0; i < MAX_WEBHOOKS; i++) {
+        const WebhookConfig& hook = _webhooks[i];
+        JsonObject obj = webhooks.add<JsonObject>();
+        obj["enabled"] = hook.enabled;
+        obj["url"] = hook.url;
+        obj["auth"] = hook.auth;
+        obj["template"] = hook.bodyTemplate;
+        obj["minInterval"] = hook.minInterval;
+        obj["events"] = hook.events;
+    }
+    
     // Sensor configurations
     JsonArray sensors = doc["sensors"].to<JsonArray>();
     for (uint8_t i = 0; i < MAX_SENSORS; i++) {
         if (_sensorConfigs[i].isConfigured) {
             JsonObject sensor = sensors.add<JsonObject>();
             sensorConfigToJson(_sensorConfigs[i], sensor);
+            sensor["entryDelay"] = _sensorAlarmConfigs[i].entryDelay;
+            sensor["exitDelay"] = _sensorAlarmConfigs[i].exitDelay;
+            sensor["latch"] = _sensorAlarmConfigs[i].latch;
+            sensor["filter"] = sensorFilterTypeToString(_sensorFilterConfigs[i].type);
+            sensor["filterAlpha"] = _sensorFilterConfigs[i].alpha;
+        }
+    }
+    
+    // Virtual sensor definitions (slot position is significant)
+    JsonArray virtuals = doc["virtual"].to<JsonArray>();
+    for (uint8_t i = 0; i < MAX_VIRTUAL_SENSORS; i++) {
+        const VirtualSensorDef& def = _virtualSensors[i];
+        JsonObject obj = virtuals.add<JsonObject>();
+        obj["enabled"] = def.enabled;
+        obj["op"] = virtualSensorOpToString(def.op);
+        JsonArray inputs = obj["inputs"].to<JsonArray>();
+        for (uint8_t k = 0; k < def.inputCount; k++) {
+            inputs.add(def.inputs[k]);
         }
+        obj["flowRate"] = def.flowRate;
+    }
+    
+    // Alarm rules (slot position is significant)
+    JsonArray rules = doc["rules"].to<JsonArray>();
+    for (uint8_t i = 0; i < MAX_ALARM_RULES; i++) {
+        const AlarmRuleDef& def = _alarmRules[i];
+        JsonObject obj = rules.add<JsonObject>();
+        obj["enabled"] = def.enabled;
+        obj["name"] = def.name;
+        obj["target"] = def.target;
+        obj["severity"] = alarmRuleSeverityToString(def.severity);
+        obj["expression"] = def.expression;
     }
 }
 
@@ -350,10 +689,98 @@ bool ConfigManager::fromJson(const JsonDocument& doc) {
         _mqttConfig.publishInterval = mqtt["publishInterval"] | 10;
     }
     
+    // UDP telemetry configuration
+    if (doc["udp"].is<JsonObjectConst>()) {
+        JsonObjectConst udp = doc["udp"];
+        
+        _udpConfig.enabled = udp["enabled"] | false;
+        strlcpy(_udpConfig.group, udp["group"] | UDP_TELEMETRY_DEFAULT_GROUP, sizeof(_udpConfig.group));
+        _udpConfig.port = udp["port"] | UDP_TELEMETRY_DEFAULT_PORT;
+        _udpConfig.ttl = udp["ttl"] | 1;
+    }
+    
+    // Hub mode configuration
+    if (doc["hub"].is<JsonObjectConst>()) {
+        JsonObjectConst hub = doc["hub"];
+        
+        _hubConfig.enabled = hub["enabled"] | false;
+        _hubConfig.timeout = hub["timeout"] | HUB_DEFAULT_TIMEOUT_S;
+    }
+    
+    // Sensor ingestion configuration
+    if (doc["ingest"].is<JsonObjectConst>()) {
+        JsonObjectConst ingest = doc["ingest"];
+        
+        _ingestConfig.enabled = ingest["enabled"] | false;
+        _ingestConfig.timeout = ingest["timeout"] | INGEST_DEFAULT_TIMEOUT_S;
+    }
+    
+    // CoAP server configuration
+    if (doc["coap"].is<JsonObjectConst>()) {
+        JsonObjectConst coap = doc["coap"];
+        
+        _coapConfig.enabled = coap["enabled"] | false;
+        _coapConfig.port = coap["port"] | COAP_DEFAULT_PORT;
+    }
+    
+    // InfluxDB export configuration
+    if (doc["influx"].is<JsonObjectConst>()) {
+        JsonObjectConst influx = doc["influx"];
+        
+        _influxConfig.enabled = influx["enabled"] | false;
+        strlcpy(_influxConfig.url, influx["url"] | "", sizeof(_influxConfig.url));
+        strlcpy(_influxConfig.token, influx["token"] | "", sizeof(_influxConfig.token));
+        strlcpy(_influxConfig.measurement, influx["measurement"] | INFLUX_DEFAULT_MEASUREMENT,
+                sizeof(_influxConfig.measurement));
+        _influxConfig.batchWindow = influx["batchWindow"] | INFLUX_DEFAULT_BATCH_WINDOW;
+        _influxConfig.gzip = influx["gzip"] | true;
+    }
+    
+    // Battery mode configuration
+    if (doc["power"].is<JsonObjectConst>()) {
+        JsonObjectConst power = doc["power"];
+        
+        _powerConfig.batteryMode = power["batteryMode"] | false;
+        _powerConfig.sleepInterval = power["sleepInterval"] | DEFAULT_SLEEP_INTERVAL;
+        _powerConfig.flushEvery = power["flushEvery"] | DEFAULT_SLEEP_FLUSH_EVERY;
+    }
+    
+    // OneWire bus configuration
+    if (doc["bus"].is<JsonObjectConst>()) {
+        JsonObjectConst bus = doc["bus"];
+        
+        _busConfig.hardwareAlarms = bus["hardwareAlarms"] | false;
+        _busConfig.inRangeReadEvery = bus["inRangeReadEvery"] | DEFAULT_IN_RANGE_READ_EVERY;
+        if (_busConfig.inRangeReadEvery == 0) {
+            _busConfig.inRangeReadEvery = 1;
+        }
+    }
+    
+    // Webhook endpoints
+    if (doc["webhooks"].is<JsonArrayConst>()) {
+        JsonArrayConst webhooks = doc["webhooks"];
+        uint8_t slot = 0;
+        
+        for (JsonObjectConst obj : webhooks) {
+            if (slot >= MAX_WEBHOOKS) break;
+            
+            WebhookConfig& hook = _webhooks[slot++];
+            hook = WebhookConfig();
+            hook.enabled = obj["enabled"] | false;
+            strlcpy(hook.url, obj["url"] | "", sizeof(hook.url));
+            strlcpy(hook.auth, obj["auth"] | "", sizeof(hook.auth));
+            strlcpy(hook.bodyTemplate, obj["template"] | "", sizeof(hook.bodyTemplate));
+            hook.minInterval = obj["minInterval"] | WEBHOOK_DEFAULT_MIN_INTERVAL;
+            hook.events = obj["events"] | (WEBHOOK_EVENT_ALARM | WEBHOOK_EVENT_CLEAR);
+        }
+    }
+    
     // Sensor configurations
     // Reset all sensors first
     for (uint8_t i = 0; i < MAX_SENSORS; i++) {
         _sensorConfigs[i] = SensorConfig();
+        _sensorAlarmConfigs[i] = SensorAlarmConfig();
+        _sensorFilterConfigs[i] = SensorFilterConfig();
     }
     
     if (doc["sensors"].is<JsonArrayConst>()) {
@@ -363,10 +790,62 @@ bool ConfigManager::fromJson(const JsonDocument& doc) {
         for (JsonObjectConst sensor : sensors) {
             if (idx >= MAX_SENSORS) break;
             sensorConfigFromJson(_sensorConfigs[idx], sensor);
+            _sensorAlarmConfigs[idx].entryDelay = sensor["entryDelay"] | DEFAULT_ALARM_ENTRY_DELAY;
+            _sensorAlarmConfigs[idx].exitDelay = sensor["exitDelay"] | DEFAULT_ALARM_EXIT_DELAY;
+            _sensorAlarmConfigs[idx].latch = sensor["latch"] | false;
+            if (!sensorFilterTypeFromString(sensor["filter"] | "none", _sensorFilterConfigs[idx].type)) {
+                _sensorFilterConfigs[idx].type = SensorFilterType::NONE;
+            }
+            _sensorFilterConfigs[idx].alpha = sensor["filterAlpha"] | DEFAULT_FILTER_ALPHA;
+            if (_sensorFilterConfigs[idx].alpha == 0) {
+                _sensorFilterConfigs[idx].alpha = DEFAULT_FILTER_ALPHA;
+            }
             idx++;
         }
     }
     
+    // Virtual sensor definitions
+    if (doc["virtual"].is<JsonArrayConst>()) {
+        JsonArrayConst virtuals = doc["virtual"];
+        uint8_t slot = 0;
+        
+        for (JsonObjectConst obj : virtuals) {
+            if (slot >= MAX_VIRTUAL_SENSORS) break;
+            
+            VirtualSensorDef& def = _virtualSensors[slot++];
+            def = VirtualSensorDef();
+            def.enabled = obj["enabled"] | false;
+            if (!virtualSensorOpFromString(obj["op"] | "", def.op)) {
+                def.enabled = false;
+            }
+            for (JsonVariantConst input : obj["inputs"].as<JsonArrayConst>()) {
+                if (def.inputCount >= VIRTUAL_SENSOR_MAX_INPUTS) break;
+                strlcpy(def.inputs[def.inputCount++], input | "", SENSOR_ADDR_STR_LEN);
+            }
+            def.flowRate = obj["flowRate"] | 0.0f;
+        }
+    }
+    
+    // Alarm rules (compiled by SensorManager on load)
+    if (doc["rules"].is<JsonArrayConst>()) {
+        JsonArrayConst rules = doc["rules"];
+        uint8_t slot = 0;
+        
+        for (JsonObjectConst obj : rules) {
+            if (slot >= MAX_ALARM_RULES) break;
+            
+            AlarmRuleDef& def = _alarmRules[slot++];
+            def = AlarmRuleDef();
+            def.enabled = obj["enabled"] | false;
+            if (!alarmRuleSeverityFromString(obj["severity"] | "", def.severity)) {
+                def.enabled = false;
+            }
+            strlcpy(def.name, obj["name"] | "", ALARM_RULE_NAME_MAX_LEN);
+            strlcpy(def.target, obj["target"] | "", SENSOR_ADDR_STR_LEN);
+            strlcpy(def.expression, obj["expression"] | "", ALARM_RULE_EXPR_MAX_LEN);
+        }
+    }
+    
     return true;
 }
 
@@ -396,3 +875,76 @@ void ConfigManager::sensorConfigFromJson(SensorConfig& config, JsonObjectConst o
     config.alertEnabled = obj["alertEnabled"] | true;
     config.isConfigured = true;
 }
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+const char* virtualSensorOpToString(VirtualSensorOp op) {
+    switch (op) {
+        case VirtualSensorOp::DIFF:      return "diff";
+        case VirtualSensorOp::MEAN:      return "mean";
+        case VirtualSensorOp::MIN:       return "min";
+        case VirtualSensorOp::MAX:       return "max";
+        case VirtualSensorOp::HEAT_FLOW: return "heat_flow";
+        default:                         return "unknown";
+    }
+}
+
+bool virtualSensorOpFromString(const char* str, VirtualSensorOp& op) {
+    static const VirtualSensorOp ops[] = {
+        VirtualSensorOp::DIFF, VirtualSensorOp::MEAN, VirtualSensorOp::MIN,
+        VirtualSensorOp::MAX, VirtualSensorOp::HEAT_FLOW
+    };
+    for (VirtualSensorOp candidate : ops) {
+        if (strcmp(str, virtualSensorOpToString(candidate)) == 0) {
+            op = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* alarmRuleSeverityToString(AlarmRuleSeverity severity) {
+    switch (severity) {
+        case AlarmRuleSeverity::ABOVE_HIGH: return "high";
+        case AlarmRuleSeverity::BELOW_LOW:  return "low";
+        default:                            return "unknown";
+    }
+}
+
+bool alarmRuleSeverityFromString(const char* str, AlarmRuleSeverity& severity) {
+    if (strcmp(str, "high") == 0) {
+        severity = AlarmRuleSeverity::ABOVE_HIGH;
+        return true;
+    }
+    if (strcmp(str, "low") == 0) {
+        severity = AlarmRuleSeverity::BELOW_LOW;
+        return true;
+    }
+    return false;
+}
+
+const char* sensorFilterTypeToString(SensorFilterType type) {
+    switch (type) {
+        case SensorFilterType::NONE:    return "none";
+        case SensorFilterType::EMA:     return "ema";
+        case SensorFilterType::MEDIAN3: return "median3";
+        case SensorFilterType::MEDIAN5: return "median5";
+        default:                        return "unknown";
+    }
+}
+
+bool sensorFilterTypeFromString(const char* str, SensorFilterType& type) {
+    static const SensorFilterType types[] = {
+        SensorFilterType::NONE, SensorFilterType::EMA,
+        SensorFilterType::MEDIAN3, SensorFilterType::MEDIAN5
+    };
+    for (SensorFilterType candidate : types) {
+        if (strcmp(str, sensorFilterTypeToString(candidate)) == 0) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -44,6 +44,108 @@ struct SensorConfig {
     }
 };
 
+/**
+ * Per-sensor alarm timing and latching
+ * Stored in its own section at the same slot index as the SensorConfig,
+ * so the main configuration blob layout stays unchanged.
+ */
+struct SensorAlarmConfig {
+    uint16_t entryDelay;                 // Seconds a threshold/rule condition must hold before alarming
+    uint16_t exitDelay;                  // Seconds back in range before the alarm clears
+    bool latch;                          // Alarm stays active until acknowledged
+    
+    SensorAlarmConfig() :
+        entryDelay(DEFAULT_ALARM_ENTRY_DELAY),
+        exitDelay(DEFAULT_ALARM_EXIT_DELAY),
+        latch(false) {
+    }
+};
+
+/**
+ * Per-sensor smoothing filter
+ */
+enum class SensorFilterType : uint8_t {
+    NONE,           // Every reading used as-is
+    EMA,            // Exponential moving average
+    MEDIAN3,        // Median of the last 3 readings
+    MEDIAN5         // Median of the last 5 readings
+};
+
+/**
+ * Per-sensor smoothing
+ * Stored in its own section at the same slot index as the SensorConfig.
+ */
+struct SensorFilterConfig {
+    SensorFilterType type;
+    uint8_t alpha;                       // EMA weight of a new reading in 1/256 (1..255)
+    
+    SensorFilterConfig() :
+        type(SensorFilterType::NONE),
+        alpha(DEFAULT_FILTER_ALPHA) {
+    }
+};
+
+/**
+ * Virtual sensor operation
+ */
+enum class VirtualSensorOp : uint8_t {
+    DIFF,           // inputs[0] - inputs[1]
+    MEAN,           // Average of available inputs
+    MIN,            // Minimum of available inputs
+    MAX,            // Maximum of available inputs
+    HEAT_FLOW       // flowRate * (inputs[0] - inputs[1]) in kW
+};
+
+/**
+ * Virtual sensor definition
+ * Evaluated once per read cycle from calibrated input temperatures.
+ * Thresholds, name and calibration live in the regular SensorConfig
+ * keyed by the sensor's synthetic address.
+ */
+struct VirtualSensorDef {
+    bool enabled;
+    VirtualSensorOp op;
+    uint8_t inputCount;
+    char inputs[VIRTUAL_SENSOR_MAX_INPUTS][SENSOR_ADDR_STR_LEN];  // Input sensor addresses
+    float flowRate;                     // HEAT_FLOW only: water flow in L/min
+    
+    VirtualSensorDef() :
+        enabled(false),
+        op(VirtualSensorOp::DIFF),
+        inputCount(0),
+        flowRate(0.0f) {
+        memset(inputs, 0, sizeof(inputs));
+    }
+};
+
+/**
+ * Alarm state raised on the target sensor while a rule holds
+ */
+enum class AlarmRuleSeverity : uint8_t {
+    ABOVE_HIGH,     // Same alarm as the high threshold ("high")
+    BELOW_LOW       // Same alarm as the low threshold ("low")
+};
+
+/**
+ * Alarm rule definition
+ * The expression is compiled to bytecode when loaded (see alarm_rules.h).
+ */
+struct AlarmRuleDef {
+    bool enabled;
+    AlarmRuleSeverity severity;
+    char name[ALARM_RULE_NAME_MAX_LEN];
+    char target[SENSOR_ADDR_STR_LEN];           // Sensor whose alarm state the rule drives
+    char expression[ALARM_RULE_EXPR_MAX_LEN];
+    
+    AlarmRuleDef() :
+        enabled(false),
+        severity(AlarmRuleSeverity::ABOVE_HIGH) {
+        name[0] = '\0';
+        target[0] = '\0';
+        expression[0] = '\0';
+    }
+};
+
 /**
  * WiFi configuration
  */
@@ -114,6 +216,133 @@ struct SystemConfig {
     }
 };
 
+/**
+ * UDP multicast telemetry configuration
+ */
+struct UdpTelemetryConfig {
+    bool enabled;
+    char group[16];             // Multicast group address
+    uint16_t port;              // Destination UDP port
+    uint8_t ttl;                // Multicast TTL (1 = local segment only)
+    
+    UdpTelemetryConfig() :
+        enabled(false),
+        port(UDP_TELEMETRY_DEFAULT_PORT),
+        ttl(1) {
+        strcpy(group, UDP_TELEMETRY_DEFAULT_GROUP);
+    }
+};
+
+/**
+ * Hub mode configuration
+ * Peer datagrams arrive on the UDP telemetry group and port
+ */
+struct HubConfig {
+    bool enabled;
+    uint16_t timeout;           // Seconds without a reading before a remote sensor disconnects
+    
+    HubConfig() :
+        enabled(false),
+        timeout(HUB_DEFAULT_TIMEOUT_S) {
+    }
+};
+
+/**
+ * External sensor ingestion configuration (POST /api/ingest, MQTT cmd/ingest)
+ */
+struct IngestConfig {
+    bool enabled;
+    uint16_t timeout;           // Seconds without a reading before an external sensor disconnects
+    
+    IngestConfig() :
+        enabled(false),
+        timeout(INGEST_DEFAULT_TIMEOUT_S) {
+    }
+};
+
+/**
+ * CoAP server configuration
+ */
+struct CoapConfig {
+    bool enabled;
+    uint16_t port;              // UDP port to listen on
+    
+    CoapConfig() :
+        enabled(false),
+        port(COAP_DEFAULT_PORT) {
+    }
+};
+
+/**
+ * InfluxDB line-protocol export configuration
+ */
+struct InfluxConfig {
+    bool enabled;
+    char url[160];              // Write endpoint (v1 /write?db= or v2 /api/v2/write?org=&bucket=)
+    char token[100];            // API token (v2) or "user:password" (v1), empty = none
+    char measurement[32];       // Measurement name
+    uint16_t batchWindow;       // Seconds between batch POSTs
+    bool gzip;                  // Compress request body
+    
+    InfluxConfig() :
+        enabled(false),
+        batchWindow(INFLUX_DEFAULT_BATCH_WINDOW),
+        gzip(true) {
+        url[0] = '\0';
+        token[0] = '\0';
+        strcpy(measurement, INFLUX_DEFAULT_MEASUREMENT);
+    }
+};
+
+/**
+ * Battery (deep sleep) mode configuration
+ */
+struct PowerConfig {
+    bool batteryMode;           // Sleep between samples, WiFi only to flush
+    uint16_t sleepInterval;     // Seconds asleep between wakes
+    uint8_t flushEvery;         // Wakes between WiFi/MQTT flushes
+    
+    PowerConfig() :
+        batteryMode(false),
+        sleepInterval(DEFAULT_SLEEP_INTERVAL),
+        flushEvery(DEFAULT_SLEEP_FLUSH_EVERY) {
+    }
+};
+
+/**
+ * OneWire bus options
+ */
+struct BusConfig {
+    bool hardwareAlarms;        // Program TH/TL, find out-of-range sensors by Alarm Search
+    uint8_t inRangeReadEvery;   // Hardware alarm mode: cycles between reads of in-range sensors
+    
+    BusConfig() :
+        hardwareAlarms(false),
+        inRangeReadEvery(DEFAULT_IN_RANGE_READ_EVERY) {
+    }
+};
+
+/**
+ * Webhook notification endpoint
+ */
+struct WebhookConfig {
+    bool enabled;
+    char url[WEBHOOK_URL_MAX_LEN];          // http:// or https:// endpoint
+    char auth[WEBHOOK_AUTH_MAX_LEN];        // Authorization header value, empty = none
+    char bodyTemplate[WEBHOOK_TEMPLATE_MAX_LEN];  // JSON body with {{placeholders}}, empty = default
+    uint16_t minInterval;                   // Minimum seconds between POSTs (rate limit)
+    uint8_t events;                         // WEBHOOK_EVENT_* mask
+    
+    WebhookConfig() :
+        enabled(false),
+        minInterval(WEBHOOK_DEFAULT_MIN_INTERVAL),
+        events(WEBHOOK_EVENT_ALARM | WEBHOOK_EVENT_CLEAR) {
+        url[0] = '\0';
+        auth[0] = '\0';
+        bodyTemplate[0] = '\0';
+    }
+};
+
 // ============================================================================
 // ConfigManager Class
 // ============================================================================
@@ -161,6 +390,72 @@ public:
     SystemConfig& getSystemConfig() { return _systemConfig; }
     const SystemConfig& getSystemConfig() const { return _systemConfig; }
     
+    /**
+     * Get UDP telemetry configuration
+     */
+    UdpTelemetryConfig& getUdpTelemetryConfig() { return _udpConfig; }
+    const UdpTelemetryConfig& getUdpTelemetryConfig() const { return _udpConfig; }
+    
+    /**
+     * Get hub mode configuration
+     */
+    HubConfig& getHubConfig() { return _hubConfig; }
+    const HubConfig& getHubConfig() const { return _hubConfig; }
+    
+    /**
+     * Get sensor ingestion configuration
+     */
+    IngestConfig& getIngestConfig() { return _ingestConfig; }
+    const IngestConfig& getIngestConfig() const { return _ingestConfig; }
+    
+    /**
+     * Get CoAP server configuration
+     */
+    CoapConfig& getCoapConfig() { return _coapConfig; }
+    const CoapConfig& getCoapConfig() const { return _coapConfig; }
+    
+    /**
+     * Get InfluxDB export configuration
+     */
+    InfluxConfig& getInfluxConfig() { return _influxConfig; }
+    const InfluxConfig& getInfluxConfig() const { return _influxConfig; }
+    
+    /**
+     * Get battery mode configuration
+     */
+    PowerConfig& getPowerConfig() { return _powerConfig; }
+    const PowerConfig& getPowerConfig() const { return _powerConfig; }
+    
+    /**
+     * Get OneWire bus configuration
+     */
+    BusConfig& getBusConfig() { return _busConfig; }
+    const BusConfig& getBusConfig() const { return _busConfig; }
+    
+    /**
+     * Get webhook endpoint configuration
+     * @param slot Endpoint slot (0 to MAX_WEBHOOKS-1)
+     * @return Pointer to configuration or nullptr if slot invalid
+     */
+    WebhookConfig* getWebhookConfig(uint8_t slot);
+    const WebhookConfig* getWebhookConfig(uint8_t slot) const;
+    
+    /**
+     * Get virtual sensor definition
+     * @param slot Virtual sensor slot (0 to MAX_VIRTUAL_SENSORS-1)
+     * @return Pointer to definition or nullptr if slot invalid
+     */
+    VirtualSensorDef* getVirtualSensorDef(uint8_t slot);
+    const VirtualSensorDef* getVirtualSensorDef(uint8_t slot) const;
+    
+    /**
+     * Get alarm rule definition
+     * @param slot Rule slot (0 to MAX_ALARM_RULES-1)
+     * @return Pointer to definition or nullptr if slot invalid
+     */
+    AlarmRuleDef* getAlarmRuleDef(uint8_t slot);
+    const AlarmRuleDef* getAlarmRuleDef(uint8_t slot) const;
+    
     /**
      * Get sensor configuration by index
      * @param index Sensor index (0 to MAX_SENSORS-1)
@@ -177,6 +472,22 @@ public:
     SensorConfig* getSensorConfigByAddress(const char* address);
     const SensorConfig* getSensorConfigByAddress(const char* address) const;
     
+    /**
+     * Get alarm timing for a configured sensor
+     * @param address Sensor address as hex string
+     * @return Pointer to alarm config or nullptr if sensor not configured
+     */
+    SensorAlarmConfig* getSensorAlarmConfig(const char* address);
+    const SensorAlarmConfig* getSensorAlarmConfig(const char* address) const;
+    
+    /**
+     * Get smoothing filter for a configured sensor
+     * @param address Sensor address as hex string
+     * @return Pointer to filter config or nullptr if sensor not configured
+     */
+    SensorFilterConfig* getSensorFilterConfig(const char* address);
+    const SensorFilterConfig* getSensorFilterConfig(const char* address) const;
+    
     /**
      * Find or create sensor configuration for an address
      * @param address Sensor address as hex string
@@ -184,6 +495,12 @@ public:
      */
     SensorConfig* findOrCreateSensorConfig(const char* address);
     
+    /**
+     * Remove sensor configuration for an address (frees the slot)
+     * @param address Sensor address as hex string
+     */
+    void removeSensorConfig(const char* address);
+    
     /**
      * Get the number of configured sensors
      */
@@ -217,6 +534,24 @@ public:
      */
     bool fromJson(const JsonDocument& doc);
     
+    /**
+     * Load a standalone config section from NVS
+     * Sections keep subsystem settings outside the main config blob, so adding
+     * a feature never invalidates the stored WiFi/MQTT/sensor configuration.
+     * @param key NVS key (max 15 chars)
+     * @param version Section layout version
+     * @param data Destination buffer
+     * @param size Size of the destination buffer
+     * @return true if a section with matching size and version was loaded
+     */
+    bool loadSection(const char* key, uint16_t version, void* data, size_t size);
+    
+    /**
+     * Save a standalone config section to NVS
+     * @return true if saved successfully
+     */
+    bool saveSection(const char* key, uint16_t version, const void* data, size_t size);
+    
 private:
     struct PersistentConfigBlob {
         uint32_t magic;
@@ -232,6 +567,18 @@ private:
     MQTTConfig _mqttConfig;
     SystemConfig _systemConfig;
     SensorConfig _sensorConfigs[MAX_SENSORS];
+    SensorAlarmConfig _sensorAlarmConfigs[MAX_SENSORS];     // Parallel to _sensorConfigs
+    SensorFilterConfig _sensorFilterConfigs[MAX_SENSORS];   // Parallel to _sensorConfigs
+    UdpTelemetryConfig _udpConfig;
+    HubConfig _hubConfig;
+    IngestConfig _ingestConfig;
+    CoapConfig _coapConfig;
+    InfluxConfig _influxConfig;
+    WebhookConfig _webhooks[MAX_WEBHOOKS];
+    PowerConfig _powerConfig;
+    BusConfig _busConfig;
+    VirtualSensorDef _virtualSensors[MAX_VIRTUAL_SENSORS];
+    AlarmRuleDef _alarmRules[MAX_ALARM_RULES];
     bool _isDirty;
     bool _initialized;
 
@@ -241,6 +588,8 @@ private:
     bool loadFromNVS();
     bool saveToNVS();
     bool loadLegacyFromSPIFFS();
+    void loadSections();
+    bool saveSections();
     
     /**
      * Serialize sensor config to JSON
@@ -256,4 +605,37 @@ private:
 // Global configuration manager instance
 extern ConfigManager configManager;
 
+/**
+ * Get virtual sensor operation as string
+ */
+const char* virtualSensorOpToString(VirtualSensorOp op);
+
+/**
+ * Parse virtual sensor operation from string
+ * @return true if the string names a known operation
+ */
+bool virtualSensorOpFromString(const char* str, VirtualSensorOp& op);
+
+/**
+ * Get alarm rule severity as string
+ */
+const char* alarmRuleSeverityToString(AlarmRuleSeverity severity);
+
+/**
+ * Parse alarm rule severity from string
+ * @return true if the string names a known severity
+ */
+bool alarmRuleSeverityFromString(const char* str, AlarmRuleSeverity& severity);
+
+/**
+ * Get sensor filter type as string
+ */
+const char* sensorFilterTypeToString(SensorFilterType type);
+
+/**
+ * Parse sensor filter type from string
+ * @return true if the string names a known filter
+ */
+bool sensorFilterTypeFromString(const char* str, SensorFilterType& type);
+
 #endif // CONFIG_MANAGER_H
@@ -581,14 +581,20 @@ void DisplayManager::drawAlertsPage() {
         return;
     }
     
-    // Count alerts
+    // Count alerts: alarm states, then probes with a high bus error rate
+    // (shown before they fail outright)
     uint8_t alertCount = 0;
+    uint8_t busWarnings = 0;
     for (uint8_t i = 0; i < sensorManager->getSensorCount(); i++) {
         const SensorData* sensor = sensorManager->getSensorData(i);
-        if (sensor != nullptr && sensor->alarmState != AlarmState::NORMAL) {
+        if (sensor == nullptr) continue;
+        if (sensor->alarmState != AlarmState::NORMAL) {
             alertCount++;
+        } else if (hasBusWarning(sensor)) {
+            busWarnings++;
         }
     }
+    alertCount += busWarnings;
     
     if (alertCount == 0) {
         tft.setTextDatum(MC_DATUM);
@@ -638,6 +644,33 @@ void DisplayManager::drawAlertsPage() {
         shown++;
     }
     
+    for (uint8_t i = 0; i < sensorManager->getSensorCount() && shown < 3; i++) {
+        const SensorData* sensor = sensorManager->getSensorData(i);
+        if (sensor == nullptr || sensor->alarmState != AlarmState::NORMAL ||
+            !hasBusWarning(sensor)) continue;
+        
+        String sensorName = String("Sensor ") + String(i + 1);
+        const SensorConfig* cfg = configManager.getSensorConfigByAddress(sensor->addressStr);
+        if (cfg != nullptr) {
+            sensorName = cfg->name;
+        }
+        if (sensorName.length() > 10) {
+            sensorName = sensorName.substring(0, 8) + "..";
+        }
+        
+        tft.setTextDatum(TL_DATUM);
+        tft.setTextColor(COLOR_TEMP_WARN, COLOR_BG);
+        tft.drawString(sensorName.c_str(), 8, y, 2);
+        
+        char rateStr[16];
+        snprintf(rateStr, sizeof(rateStr), "BUS %d%%", (int)(sensor->diag.errorRate() * 100.0f + 0.5f));
+        tft.setTextDatum(TR_DATUM);
+        tft.drawString(rateStr, DISPLAY_WIDTH - 8, y, 2);
+        
+        y += lineHeight;
+        shown++;
+    }
+    
     // Show count if more alerts - position above bottom bar
     if (alertCount > 3) {
         tft.setTextDatum(MC_DATUM);
@@ -649,6 +682,13 @@ void DisplayManager::drawAlertsPage() {
 #endif
 }
 
+bool DisplayManager::hasBusWarning(const SensorData* sensor) {
+    // A few reads are needed before the rate means anything
+    return sensor->source == SensorSource::PHYSICAL &&
+           sensor->diag.windowCount >= 8 &&
+           sensor->diag.errorRate() >= BUS_ERROR_RATE_WARN;
+}
+
 uint16_t DisplayManager::getTemperatureColor(float temp, float low, float high) {
     if (temp < low) return COLOR_TEMP_COLD;
     if (temp > high) return COLOR_TEMP_ALERT;
@@ -132,6 +132,7 @@ private:
     // Helper methods
     uint16_t getTemperatureColor(float temp, float low, float high);
     uint16_t getAlarmColor(AlarmState state);
+    bool hasBusWarning(const SensorData* sensor);
 };
 
 // Global instance
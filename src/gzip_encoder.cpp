@@ -0,0 +1,394 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Gzip Encoder Implementation
+ *
+ * Emits a single fixed-Huffman deflate block (RFC 1951 BTYPE=01) wrapped
+ * in a minimal gzip member.
+ */
+
+#include "gzip_encoder.h"
+
+namespace {
+
+constexpr uint16_t WINDOW_MASK = GZIP_WINDOW_SIZE - 1;
+constexpr uint16_t BUFFER_SIZE = GZIP_WINDOW_SIZE * 2;
+constexpr uint16_t HASH_SIZE = 512;
+constexpr uint16_t NIL = 0xFFFF;
+constexpr uint16_t MIN_MATCH = 3;
+constexpr uint16_t MAX_MATCH = 258;
+
+// Length codes 257..285: base length and extra bits
+const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// Distance codes 0..29: base distance and extra bits
+const uint16_t DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+const uint8_t DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Nibble-wise CRC-32 table (64 bytes instead of 1KB)
+const uint32_t CRC_NIBBLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+inline uint16_t hash3(const uint8_t* p) {
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (uint16_t)((v * 2654435761u) >> 23);  // 9 bits
+}
+
+struct BufferSink {
+    uint8_t* out;
+    size_t cap;
+    size_t len;
+};
+
+bool bufferSinkWrite(void* ctx, const uint8_t* data, size_t len) {
+    BufferSink* sink = static_cast<BufferSink*>(ctx);
+    if (sink->len + len > sink->cap) {
+        return false;
+    }
+    memcpy(sink->out + sink->len, data, len);
+    sink->len += len;
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor / Destructor
+// ============================================================================
+
+GzipEncoder::GzipEncoder() :
+    _ws(nullptr),
+    _sink(nullptr),
+    _ctx(nullptr),
+    _pos(0),
+    _len(0),
+    _outLen(0),
+    _bitBuf(0),
+    _bitCount(0),
+    _crc(0),
+    _bytesIn(0),
+    _bytesOut(0),
+    _error(false) {
+}
+
+GzipEncoder::~GzipEncoder() {
+    end();
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+bool GzipEncoder::begin(GzipSink sink, void* ctx) {
+    end();
+
+    _ws = static_cast<Workspace*>(malloc(sizeof(Workspace)));
+    if (!_ws) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < HASH_SIZE; i++) {
+        _ws->head[i] = NIL;
+    }
+    for (uint16_t i = 0; i < GZIP_WINDOW_SIZE; i++) {
+        _ws->prev[i] = NIL;
+    }
+
+    _sink = sink;
+    _ctx = ctx;
+    _pos = 0;
+    _len = 0;
+    _outLen = 0;
+    _bitBuf = 0;
+    _bitCount = 0;
+    _crc = 0;
+    _bytesIn = 0;
+    _bytesOut = 0;
+    _error = false;
+
+    // gzip header: magic, deflate, no flags, no mtime, no xfl, OS unknown
+    static const uint8_t header[10] = { 0x1F, 0x8B, 0x08, 0, 0, 0, 0, 0, 0, 0xFF };
+    for (uint8_t i = 0; i < sizeof(header); i++) {
+        putByte(header[i]);
+    }
+
+    // Single final block with fixed Huffman codes
+    putBits(1, 1);
+    putBits(1, 2);
+
+    return true;
+}
+
+bool GzipEncoder::write(const uint8_t* data, size_t len) {
+    if (!_ws || _error) {
+        return false;
+    }
+
+    _crc = crc32(_crc, data, len);
+    _bytesIn += len;
+
+    while (len > 0) {
+        if (_len == BUFFER_SIZE) {
+            slideWindow();
+        }
+
+        size_t chunk = BUFFER_SIZE - _len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(_ws->window + _len, data, chunk);
+        _len += chunk;
+        data += chunk;
+        len -= chunk;
+
+        compressPending(false);
+    }
+
+    return !_error;
+}
+
+bool GzipEncoder::finish() {
+    if (!_ws || _error) {
+        end();
+        return false;
+    }
+
+    compressPending(true);
+
+    // End of block
+    putHuffman(0, 7);
+    flushBits();
+
+    // gzip trailer: CRC-32 and input size, little-endian
+    for (uint8_t i = 0; i < 4; i++) {
+        putByte((uint8_t)(_crc >> (8 * i)));
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        putByte((uint8_t)(_bytesIn >> (8 * i)));
+    }
+    flushOutput();
+
+    bool ok = !_error;
+    end();
+    return ok;
+}
+
+void GzipEncoder::end() {
+    if (_ws) {
+        free(_ws);
+        _ws = nullptr;
+    }
+}
+
+size_t GzipEncoder::compress(const uint8_t* in, size_t inLen, uint8_t* out, size_t outCap) {
+    BufferSink sink = { out, outCap, 0 };
+    GzipEncoder encoder;
+
+    if (!encoder.begin(bufferSinkWrite, &sink)) {
+        return 0;
+    }
+    if (!encoder.write(in, inLen) || !encoder.finish()) {
+        return 0;
+    }
+    return sink.len;
+}
+
+uint32_t GzipEncoder::crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+        crc = (crc >> 4) ^ CRC_NIBBLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// LZ77
+// ============================================================================
+
+void GzipEncoder::compressPending(bool flush) {
+    while (_pos < _len && !_error) {
+        uint16_t avail = _len - _pos;
+
+        // Keep a full lookahead unless this is the final flush
+        if (!flush && avail < MAX_MATCH) {
+            break;
+        }
+
+        uint16_t distance = 0;
+        uint16_t length = findMatch(_pos, avail, distance);
+
+        if (length >= MIN_MATCH) {
+            putMatch(length, distance);
+            for (uint16_t i = 0; i < length; i++) {
+                insertHash(_pos++);
+            }
+        } else {
+            putLiteral(_ws->window[_pos]);
+            insertHash(_pos++);
+        }
+    }
+}
+
+void GzipEncoder::slideWindow() {
+    memmove(_ws->window, _ws->window + GZIP_WINDOW_SIZE, BUFFER_SIZE - GZIP_WINDOW_SIZE);
+    _pos -= GZIP_WINDOW_SIZE;
+    _len -= GZIP_WINDOW_SIZE;
+
+    for (uint16_t i = 0; i < HASH_SIZE; i++) {
+        uint16_t p = _ws->head[i];
+        _ws->head[i] = (p != NIL && p >= GZIP_WINDOW_SIZE) ? p - GZIP_WINDOW_SIZE : NIL;
+    }
+    for (uint16_t i = 0; i < GZIP_WINDOW_SIZE; i++) {
+        uint16_t p = _ws->prev[i];
+        _ws->prev[i] = (p != NIL && p >= GZIP_WINDOW_SIZE) ? p - GZIP_WINDOW_SIZE : NIL;
+    }
+}
+
+void GzipEncoder::insertHash(uint16_t pos) {
+    if (pos + MIN_MATCH > _len) {
+        return;
+    }
+    uint16_t h = hash3(_ws->window + pos);
+    _ws->prev[pos & WINDOW_MASK] = _ws->head[h];
+    _ws->head[h] = pos;
+}
+
+uint16_t GzipEncoder::findMatch(uint16_t pos, uint16_t avail, uint16_t& distance) {
+    if (avail < MIN_MATCH) {
+        return 0;
+    }
+
+    uint16_t maxLen = avail < MAX_MATCH ? avail : MAX_MATCH;
+    const uint8_t* cur = _ws->window + pos;
+    uint16_t candidate = _ws->head[hash3(cur)];
+    uint16_t bestLen = 0;
+    uint8_t chain = GZIP_MAX_CHAIN;
+
+    while (candidate != NIL && chain-- > 0) {
+        // Chain entries can be stale after the prev[] slot was reused
+        if (candidate >= pos || pos - candidate > GZIP_WINDOW_SIZE) {
+            break;
+        }
+
+        const uint8_t* ref = _ws->window + candidate;
+        if (ref[bestLen] == cur[bestLen] && ref[0] == cur[0]) {
+            uint16_t n = 0;
+            while (n < maxLen && ref[n] == cur[n]) {
+                n++;
+            }
+            if (n > bestLen) {
+                bestLen = n;
+                distance = pos - candidate;
+                if (n == maxLen) {
+                    break;
+                }
+            }
+        }
+
+        candidate = _ws->prev[candidate & WINDOW_MASK];
+    }
+
+    return bestLen;
+}
+
+// ============================================================================
+// Bit Output
+// ============================================================================
+
+void GzipEncoder::putBits(uint32_t value, uint8_t count) {
+    _bitBuf |= value << _bitCount;
+    _bitCount += count;
+    while (_bitCount >= 8) {
+        putByte((uint8_t)_bitBuf);
+        _bitBuf >>= 8;
+        _bitCount -= 8;
+    }
+}
+
+void GzipEncoder::putHuffman(uint16_t code, uint8_t length) {
+    // Huffman codes are packed most-significant bit first
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    putBits(reversed, length);
+}
+
+void GzipEncoder::putLiteral(uint8_t value) {
+    if (value < 144) {
+        putHuffman(0x30 + value, 8);
+    } else {
+        putHuffman(0x190 + (value - 144), 9);
+    }
+}
+
+void GzipEncoder::putMatch(uint16_t length, uint16_t distance) {
+    uint8_t lc = 28;
+    while (LENGTH_BASE[lc] > length) {
+        lc--;
+    }
+    uint16_t symbol = 257 + lc;
+    if (symbol < 280) {
+        putHuffman(symbol - 256, 7);
+    } else {
+        putHuffman(0xC0 + (symbol - 280), 8);
+    }
+    if (LENGTH_EXTRA[lc]) {
+        putBits(length - LENGTH_BASE[lc], LENGTH_EXTRA[lc]);
+    }
+
+    uint8_t dc = 29;
+    while (DIST_BASE[dc] > distance) {
+        dc--;
+    }
+    putHuffman(dc, 5);
+    if (DIST_EXTRA[dc]) {
+        putBits(distance - DIST_BASE[dc], DIST_EXTRA[dc]);
+    }
+}
+
+void GzipEncoder::putByte(uint8_t value) {
+    _ws->out[_outLen++] = value;
+    if (_outLen == sizeof(_ws->out)) {
+        flushOutput();
+    }
+}
+
+void GzipEncoder::flushBits() {
+    if (_bitCount > 0) {
+        putByte((uint8_t)_bitBuf);
+    }
+    _bitBuf = 0;
+    _bitCount = 0;
+}
+
+void GzipEncoder::flushOutput() {
+    if (_outLen == 0 || _error) {
+        _outLen = 0;
+        return;
+    }
+    if (!_sink(_ctx, _ws->out, _outLen)) {
+        _error = true;
+    }
+    _bytesOut += _outLen;
+    _outLen = 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Gzip Encoder Header
+ *
+ * Small-footprint streaming gzip (RFC 1952) encoder:
+ * - LZ77 with a 1KB sliding window and bounded hash-chain search
+ * - Fixed Huffman codes only (no tree construction, no large tables)
+ * - ~5KB of heap while active, released by end()
+ *
+ * Compression ratio is lower than zlib, but JSON and line protocol are
+ * repetitive enough that payloads typically shrink to 20-35%.
+ */
+
+#ifndef GZIP_ENCODER_H
+#define GZIP_ENCODER_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// Encoder Limits
+// ============================================================================
+
+// Sliding window size (must be a power of two, <= 32768)
+constexpr uint16_t GZIP_WINDOW_SIZE = 1024;
+
+// Maximum hash-chain candidates examined per position (bounds CPU time)
+constexpr uint8_t GZIP_MAX_CHAIN = 8;
+
+// Worst-case output for an input of n bytes (9-bit literals + header/trailer)
+constexpr size_t gzipMaxCompressedSize(size_t n) {
+    return n + (n / 8) + 32;
+}
+
+/**
+ * Output callback
+ * @param ctx User context passed to begin()
+ * @param data Compressed bytes
+ * @param len Number of bytes
+ * @return false to abort encoding
+ */
+typedef bool (*GzipSink)(void* ctx, const uint8_t* data, size_t len);
+
+// ============================================================================
+// GzipEncoder Class
+// ============================================================================
+
+class GzipEncoder {
+public:
+    GzipEncoder();
+    ~GzipEncoder();
+
+    /**
+     * Start a new gzip stream
+     * Allocates the working buffers and writes the gzip header
+     * @param sink Output callback
+     * @param ctx Context passed to the sink
+     * @return true if ready to accept data
+     */
+    bool begin(GzipSink sink, void* ctx);
+
+    /**
+     * Compress more input
+     * @return false on sink or allocation failure
+     */
+    bool write(const uint8_t* data, size_t len);
+
+    /**
+     * Flush remaining data and write the gzip trailer
+     * @return true if the stream was completed successfully
+     */
+    bool finish();
+
+    /**
+     * Release working buffers (called automatically by finish())
+     */
+    void end();
+
+    /**
+     * Get number of uncompressed bytes consumed
+     */
+    uint32_t getBytesIn() const { return _bytesIn; }
+
+    /**
+     * Get number of compressed bytes produced
+     */
+    uint32_t getBytesOut() const { return _bytesOut; }
+
+    /**
+     * Compress a complete buffer into a caller-provided output buffer
+     * @param in Input data
+     * @param inLen Input length
+     * @param out Output buffer
+     * @param outCap Output buffer capacity
+     * @return Compressed size, or 0 if the output did not fit or on error
+     */
+    static size_t compress(const uint8_t* in, size_t inLen, uint8_t* out, size_t outCap);
+
+    /**
+     * Update a CRC-32 (IEEE 802.3, as used by gzip)
+     */
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+private:
+    struct Workspace {
+        uint8_t window[GZIP_WINDOW_SIZE * 2];   // History + lookahead
+        uint16_t head[512];                     // Hash bucket -> newest position
+        uint16_t prev[GZIP_WINDOW_SIZE];        // Position -> previous in chain
+        uint8_t out[64];                        // Output staging buffer
+    };
+
+    Workspace* _ws;
+    GzipSink _sink;
+    void* _ctx;
+    uint16_t _pos;          // Next position to encode
+    uint16_t _len;          // Bytes held in window
+    uint8_t _outLen;
+    uint32_t _bitBuf;
+    uint8_t _bitCount;
+    uint32_t _crc;
+    uint32_t _bytesIn;
+    uint32_t _bytesOut;
+    bool _error;
+
+    void compressPending(bool flush);
+    void slideWindow();
+    void insertHash(uint16_t pos);
+    uint16_t findMatch(uint16_t pos, uint16_t avail, uint16_t& distance);
+
+    void putBits(uint32_t value, uint8_t count);
+    void putHuffman(uint16_t code, uint8_t length);
+    void putLiteral(uint8_t value);
+    void putMatch(uint16_t length, uint16_t distance);
+    void putByte(uint8_t value);
+    void flushBits();
+    void flushOutput();
+};
+
+#endif // GZIP_ENCODER_H
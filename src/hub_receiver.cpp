@@ -0,0 +1,225 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Hub Receiver Implementation
+ */
+
+#include "hub_receiver.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+#include "udp_telemetry.h"
+#include "wifi_manager.h"
+
+// Global instance
+HubReceiver hubReceiver;
+
+// Largest datagram a peer sends (any excess is truncated and rejected)
+constexpr size_t RX_BUFFER_SIZE = UDP_TELEMETRY_MAX_SIZE + 1;
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+HubReceiver::HubReceiver() :
+    _socket(-1),
+    _groupAddr(0),
+    _datagramCount(0),
+    _readingCount(0),
+    _invalidCount(0),
+    _droppedCount(0),
+    _reconfigureRequested(false) {
+    memset(_deviceId, 0, sizeof(_deviceId));
+    memset(_peers, 0, sizeof(_peers));
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void HubReceiver::update() {
+    const HubConfig& config = configManager.getHubConfig();
+
+    // Handle reconfigure request from web handlers (thread-safe)
+    if (_reconfigureRequested) {
+        _reconfigureRequested = false;
+        closeSocket();
+    }
+
+    // Also runs while stopped, so remote sensors never show stale values
+    sensorManager.expirePushedSensors(SensorSource::REMOTE, (uint32_t)config.timeout * 1000);
+
+    if (!config.enabled || !wifiManager.isConnected()) {
+        if (_socket >= 0) {
+            closeSocket();
+        }
+        return;
+    }
+
+    if (_socket < 0 && !openSocket()) {
+        return;
+    }
+
+    pollDatagrams();
+}
+
+uint8_t HubReceiver::getPeerCount() const {
+    uint32_t timeout = (uint32_t)configManager.getHubConfig().timeout * 1000;
+    uint32_t now = millis();
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < HUB_MAX_PEERS; i++) {
+        if (_peers[i].active && now - _peers[i].lastSeen < timeout) {
+            count++;
+        }
+    }
+    return count;
+}
+
+const HubPeer* HubReceiver::getPeer(uint8_t index) const {
+    if (index >= HUB_MAX_PEERS || !_peers[index].active) {
+        return nullptr;
+    }
+    return &_peers[index];
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+bool HubReceiver::openSocket() {
+    const UdpTelemetryConfig& udp = configManager.getUdpTelemetryConfig();
+
+    IPAddress group;
+    if (!group.fromString(udp.group) || group[0] < 224 || group[0] > 239) {
+        Serial.printf("[Hub] Invalid multicast group: %s\n", udp.group);
+        return false;
+    }
+    _groupAddr = (uint32_t)group;
+
+    _socket = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket < 0) {
+        Serial.println(F("[Hub] Failed to create socket"));
+        return false;
+    }
+
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(udp.port);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (lwip_bind(_socket, (struct sockaddr*)&local, sizeof(local)) < 0) {
+        Serial.printf("[Hub] Failed to bind port %u (errno %d)\n", udp.port, errno);
+        closeSocket();
+        return false;
+    }
+
+    struct ip_mreq membership;
+    membership.imr_multiaddr.s_addr = _groupAddr;
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (lwip_setsockopt(_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+        Serial.printf("[Hub] Failed to join %s (errno %d)\n", udp.group, errno);
+        closeSocket();
+        return false;
+    }
+
+    // Datagrams are polled from the main loop
+    int flags = lwip_fcntl(_socket, F_GETFL, 0);
+    lwip_fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
+
+    // Our own telemetry is looped back to the group
+    WiFi.macAddress(_deviceId);
+
+    Serial.printf("[Hub] Listening for peers on %s:%u\n", udp.group, udp.port);
+    return true;
+}
+
+void HubReceiver::closeSocket() {
+    if (_socket < 0) {
+        return;
+    }
+
+    struct ip_mreq membership;
+    membership.imr_multiaddr.s_addr = _groupAddr;
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    lwip_setsockopt(_socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, &membership, sizeof(membership));
+
+    lwip_close(_socket);
+    _socket = -1;
+}
+
+void HubReceiver::pollDatagrams() {
+    uint8_t buffer[RX_BUFFER_SIZE];
+
+    for (uint8_t i = 0; i < HUB_MAX_DATAGRAMS_PER_UPDATE; i++) {
+        int len = lwip_recvfrom(_socket, buffer, sizeof(buffer), 0, nullptr, nullptr);
+        if (len <= 0) {
+            break;
+        }
+        handleDatagram(buffer, (size_t)len);
+    }
+}
+
+void HubReceiver::handleDatagram(const uint8_t* data, size_t len) {
+    UdpTelemetryHeader header;
+    if (!parseUdpTelemetryHeader(data, len, header)) {
+        _invalidCount++;
+        return;
+    }
+
+    if (memcmp(header.deviceId, _deviceId, sizeof(_deviceId)) == 0) {
+        return;
+    }
+
+    trackPeer(header.deviceId, header.sequence);
+    _datagramCount++;
+
+    for (uint8_t i = 0; i < header.count; i++) {
+        UdpTelemetryReading reading;
+        float temp = readUdpTelemetryReading(data, i, reading);
+
+        // Synthetic addresses are only unique within their station
+        if (!qualifyUdpTelemetryAddress(header.deviceId, reading.address)) {
+            continue;
+        }
+
+        if (sensorManager.pushReading(reading.address, SensorSource::REMOTE, temp) < 0) {
+            _droppedCount++;
+        } else {
+            _readingCount++;
+        }
+    }
+}
+
+void HubReceiver::trackPeer(const uint8_t* deviceId, uint32_t sequence) {
+    HubPeer* peer = nullptr;
+    HubPeer* oldest = &_peers[0];
+
+    for (uint8_t i = 0; i < HUB_MAX_PEERS && !peer; i++) {
+        HubPeer& slot = _peers[i];
+        if (slot.active && memcmp(slot.deviceId, deviceId, sizeof(slot.deviceId)) == 0) {
+            peer = &slot;
+        } else if (!slot.active || (oldest->active && slot.lastSeen < oldest->lastSeen)) {
+            oldest = &slot;
+        }
+    }
+
+    if (!peer) {
+        // New peer takes a free slot, else the one silent the longest
+        peer = oldest;
+        memset(peer, 0, sizeof(*peer));
+        memcpy(peer->deviceId, deviceId, sizeof(peer->deviceId));
+        peer->active = true;
+
+        Serial.printf("[Hub] New peer %02X:%02X:%02X:%02X:%02X:%02X\n",
+            deviceId[0], deviceId[1], deviceId[2], deviceId[3], deviceId[4], deviceId[5]);
+    } else if (sequence > peer->lastSequence + 1) {
+        peer->lost += sequence - peer->lastSequence - 1;
+    }
+    // A lower sequence means the peer restarted: nothing was lost
+
+    peer->lastSequence = sequence;
+    peer->lastSeen = millis();
+    peer->datagrams++;
+}
@@ -0,0 +1,135 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Hub Receiver Header
+ *
+ * Hub mode: listens for the UDP telemetry datagrams of peer stations and
+ * merges their readings into the local sensor table as remote sensors.
+ * Remote sensors then appear in /api/sensors and are published over this
+ * station's single MQTT connection like local ones:
+ * - Same group, port and datagram format as UdpTelemetry
+ * - Own datagrams and peers' virtual sensors are ignored
+ * - Remote sensors disconnect after the configured timeout
+ */
+
+#ifndef HUB_RECEIVER_H
+#define HUB_RECEIVER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+/**
+ * Peer station seen by the hub
+ */
+struct HubPeer {
+    uint8_t deviceId[6];            // Peer MAC address
+    uint32_t lastSequence;          // Sequence of the last datagram
+    uint32_t lastSeen;              // millis() of the last datagram
+    uint32_t datagrams;             // Datagrams received
+    uint32_t lost;                  // Datagrams missed (sequence gaps)
+    bool active;                    // Slot in use
+};
+
+// ============================================================================
+// HubReceiver Class
+// ============================================================================
+
+class HubReceiver {
+public:
+    /**
+     * Constructor
+     */
+    HubReceiver();
+
+    /**
+     * Update receiver (call in main loop)
+     * Handles pending datagrams and expires silent remote sensors
+     */
+    void update();
+
+    /**
+     * Apply changed configuration on next update
+     * Safe to call from async web handlers
+     */
+    void reconfigure() { _reconfigureRequested = true; }
+
+    /**
+     * Check if the receive socket is open
+     */
+    bool isActive() const { return _socket >= 0; }
+
+    /**
+     * Get number of valid peer datagrams received
+     */
+    uint32_t getDatagramCount() const { return _datagramCount; }
+
+    /**
+     * Get number of readings applied to remote sensors
+     */
+    uint32_t getReadingCount() const { return _readingCount; }
+
+    /**
+     * Get number of malformed datagrams dropped
+     */
+    uint32_t getInvalidCount() const { return _invalidCount; }
+
+    /**
+     * Get number of readings dropped because the sensor table is full
+     */
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+    /**
+     * Get number of peers heard from within the timeout
+     */
+    uint8_t getPeerCount() const;
+
+    /**
+     * Get peer slot
+     * @param index Slot (0 to HUB_MAX_PEERS-1)
+     * @return Peer or nullptr if the slot is unused
+     */
+    const HubPeer* getPeer(uint8_t index) const;
+
+private:
+    int _socket;
+    uint32_t _groupAddr;                // Group address (network byte order)
+    uint32_t _datagramCount;
+    uint32_t _readingCount;
+    uint32_t _invalidCount;
+    uint32_t _droppedCount;
+    uint8_t _deviceId[6];
+    HubPeer _peers[HUB_MAX_PEERS];
+    volatile bool _reconfigureRequested;
+
+    /**
+     * Open the socket and join the telemetry group
+     * @return true if socket is ready
+     */
+    bool openSocket();
+
+    /**
+     * Leave the group and close the socket
+     */
+    void closeSocket();
+
+    /**
+     * Receive and apply pending datagrams
+     */
+    void pollDatagrams();
+
+    /**
+     * Validate one datagram and push its readings
+     */
+    void handleDatagram(const uint8_t* data, size_t len);
+
+    /**
+     * Record a datagram from a peer (sequence gaps count as lost)
+     */
+    void trackPeer(const uint8_t* deviceId, uint32_t sequence);
+};
+
+// Global hub receiver instance
+extern HubReceiver hubReceiver;
+
+#endif // HUB_RECEIVER_H
@@ -0,0 +1,410 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * InfluxDB Exporter Implementation
+ */
+
+#include "influx_exporter.h"
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <sys/time.h>
+#include <new>
+#include "gzip_encoder.h"
+#include "wifi_manager.h"
+
+// Global instance
+InfluxExporter influxExporter;
+
+namespace {
+
+struct InfluxSendTaskArgs {
+    InfluxExporter* self;
+    InfluxConfig config;                // Snapshot, web handlers may edit the live copy
+};
+
+/**
+ * Append src to dst with line-protocol escaping of the given characters
+ */
+size_t appendEscaped(char* dst, size_t cap, size_t pos, const char* src, const char* special) {
+    while (*src && pos + 2 < cap) {
+        if (strchr(special, *src)) {
+            dst[pos++] = '\\';
+        }
+        dst[pos++] = *src++;
+    }
+    dst[pos] = '\0';
+    return pos;
+}
+
+uint16_t countLines(const char* buffer, size_t len) {
+    uint16_t lines = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (buffer[i] == '\n') {
+            lines++;
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+InfluxExporter::InfluxExporter() :
+    _active(nullptr),
+    _pending(nullptr),
+    _activeLen(0),
+    _pendingLen(0),
+    _task(nullptr),
+    _sending(false),
+    _sendOk(false),
+    _sendRejected(false),
+    _lastStatus(0),
+    _lastWireBytes(0),
+    _lastGeneration(0),
+    _batchStart(0),
+    _retryAt(0),
+    _failures(0),
+    _batchCount(0),
+    _lineCount(0),
+    _bytesSent(0),
+    _errorCount(0),
+    _droppedCount(0),
+    _flushRequested(false),
+    _reconfigureRequested(false) {
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void InfluxExporter::update() {
+    const InfluxConfig& config = configManager.getInfluxConfig();
+
+    // Collect result of a finished send task
+    if (_task && !_sending) {
+        _task = nullptr;
+        completeSend();
+    }
+
+    // Handle reconfigure request from web handlers (thread-safe)
+    if (_reconfigureRequested) {
+        _reconfigureRequested = false;
+        _failures = 0;
+        _retryAt = millis();
+        _flushRequested = true;
+    }
+
+    if (!config.enabled) {
+        if (!_sending) {
+            freeBuffers();
+        }
+        return;
+    }
+
+    if (!allocateBuffers()) {
+        return;
+    }
+
+    // Record each completed read cycle, even while offline (store-and-forward)
+    uint32_t generation = sensorManager.getReadGeneration();
+    if (generation != _lastGeneration) {
+        _lastGeneration = generation;
+        appendReadings();
+    }
+
+    if (_sending || config.url[0] == '\0' || !wifiManager.isConnected()) {
+        return;
+    }
+    if (_activeLen == 0 && _pendingLen == 0) {
+        _batchStart = millis();
+        return;
+    }
+    if ((int32_t)(millis() - _retryAt) < 0) {
+        return;
+    }
+
+    uint32_t window = (uint32_t)(config.batchWindow > 0 ? config.batchWindow : 1) * 1000UL;
+    bool windowElapsed = (millis() - _batchStart) >= window;
+    bool nearlyFull = _activeLen >= (INFLUX_BUFFER_SIZE * 3) / 4;
+
+    if (windowElapsed || nearlyFull || _flushRequested) {
+        _flushRequested = false;
+        startSend();
+    }
+}
+
+// ============================================================================
+// Batch Buffers
+// ============================================================================
+
+bool InfluxExporter::allocateBuffers() {
+    if (_active && _pending) {
+        return true;
+    }
+
+    _active = static_cast<char*>(malloc(INFLUX_BUFFER_SIZE));
+    _pending = static_cast<char*>(malloc(INFLUX_BUFFER_SIZE));
+    if (!_active || !_pending) {
+        Serial.println(F("[Influx] Failed to allocate batch buffers"));
+        freeBuffers();
+        return false;
+    }
+
+    _activeLen = 0;
+    _pendingLen = 0;
+    _batchStart = millis();
+    _lastGeneration = sensorManager.getReadGeneration();
+    return true;
+}
+
+void InfluxExporter::freeBuffers() {
+    if (_activeLen + _pendingLen > 0) {
+        _droppedCount += countLines(_active, _activeLen) + countLines(_pending, _pendingLen);
+    }
+    free(_active);
+    free(_pending);
+    _active = nullptr;
+    _pending = nullptr;
+    _activeLen = 0;
+    _pendingLen = 0;
+}
+
+void InfluxExporter::appendReadings() {
+    // Lines are only timestamped by us; without a synchronised clock a
+    // batched or retried line would be stored at the wrong time
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < MIN_VALID_EPOCH) {
+        return;
+    }
+    uint64_t timestampMs = (uint64_t)tv.tv_sec * 1000ULL + tv.tv_usec / 1000;
+
+    const InfluxConfig& config = configManager.getInfluxConfig();
+    const SystemConfig& sysConfig = configManager.getSystemConfig();
+
+    // measurement,device=..,sensor=..,name=.. value=21.50,alarm="normal" 1700000000000
+    char line[320];
+
+    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        if (!data || !data->connected || data->temperature == TEMP_INVALID) {
+            continue;
+        }
+
+        const SensorConfig* sensorConfig = configManager.getSensorConfigByAddress(data->addressStr);
+
+        size_t pos = appendEscaped(line, sizeof(line), 0, config.measurement, ", ");
+        pos += snprintf(line + pos, sizeof(line) - pos, ",device=");
+        pos = appendEscaped(line, sizeof(line), pos, sysConfig.deviceName, ",= ");
+        pos += snprintf(line + pos, sizeof(line) - pos, ",sensor=%s", data->addressStr);
+        if (sensorConfig && sensorConfig->name[0] != '\0') {
+            pos += snprintf(line + pos, sizeof(line) - pos, ",name=");
+            pos = appendEscaped(line, sizeof(line), pos, sensorConfig->name, ",= ");
+        }
+
+        int written = snprintf(line + pos, sizeof(line) - pos,
+            " value=%.2f,alarm=\"%s\" %llu\n",
+            data->temperature,
+            alarmStateToString(data->alarmState),
+            (unsigned long long)timestampMs);
+        if (written <= 0 || pos + written >= sizeof(line)) {
+            continue;
+        }
+
+        appendLine(line, pos + written);
+    }
+}
+
+void InfluxExporter::appendLine(const char* line, size_t len) {
+    if (len > INFLUX_BUFFER_SIZE) {
+        _droppedCount++;
+        return;
+    }
+
+    if (INFLUX_BUFFER_SIZE - _activeLen < len) {
+        // A retained batch holds the oldest data: discard from it first,
+        // then shift our oldest lines behind it to make room
+        if (!_sending && _pendingLen > 0) {
+            _droppedCount += dropOldest(_pending, _pendingLen, len);
+            mergeIntoPending();
+        }
+        if (INFLUX_BUFFER_SIZE - _activeLen < len) {
+            _droppedCount += dropOldest(_active, _activeLen, len);
+        }
+    }
+
+    memcpy(_active + _activeLen, line, len);
+    _activeLen += len;
+}
+
+uint16_t InfluxExporter::dropOldest(char* buffer, size_t& len, size_t needed) {
+    size_t cut = 0;
+    uint16_t lines = 0;
+
+    while (cut < len && INFLUX_BUFFER_SIZE - (len - cut) < needed) {
+        const char* nl = static_cast<const char*>(memchr(buffer + cut, '\n', len - cut));
+        cut = nl ? (size_t)(nl - buffer) + 1 : len;
+        lines++;
+    }
+
+    if (cut > 0) {
+        memmove(buffer, buffer + cut, len - cut);
+        len -= cut;
+    }
+    return lines;
+}
+
+void InfluxExporter::mergeIntoPending() {
+    size_t space = INFLUX_BUFFER_SIZE - _pendingLen;
+    size_t n = _activeLen < space ? _activeLen : space;
+
+    // Only move complete lines
+    while (n > 0 && _active[n - 1] != '\n') {
+        n--;
+    }
+    if (n == 0) {
+        return;
+    }
+
+    memcpy(_pending + _pendingLen, _active, n);
+    _pendingLen += n;
+    memmove(_active, _active + n, _activeLen - n);
+    _activeLen -= n;
+}
+
+// ============================================================================
+// Sending
+// ============================================================================
+
+void InfluxExporter::startSend() {
+    if (_pendingLen == 0) {
+        char* tmp = _pending;
+        _pending = _active;
+        _active = tmp;
+        _pendingLen = _activeLen;
+        _activeLen = 0;
+    } else {
+        // Retrying a failed batch: carry newer lines along if they fit
+        mergeIntoPending();
+    }
+    _batchStart = millis();
+
+    InfluxSendTaskArgs* args = new (std::nothrow) InfluxSendTaskArgs{this, configManager.getInfluxConfig()};
+    if (!args) {
+        Serial.println(F("[Influx] Out of memory starting send task"));
+        return;
+    }
+
+    _sending = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(sendThunk, "influx_send", 8192, args, 1, &_task, 0);
+    if (ok != pdPASS) {
+        delete args;
+        _sending = false;
+        _task = nullptr;
+        Serial.println(F("[Influx] Failed to start send task"));
+    }
+}
+
+void InfluxExporter::completeSend() {
+    uint16_t lines = countLines(_pending, _pendingLen);
+
+    if (_sendOk) {
+        _batchCount++;
+        _lineCount += lines;
+        _bytesSent += _lastWireBytes;
+        _pendingLen = 0;
+        _failures = 0;
+        DEBUG_PRINTF("[Influx] Sent %u lines (%u bytes)\n", lines, _lastWireBytes);
+        return;
+    }
+
+    _errorCount++;
+
+    if (_sendRejected) {
+        // Malformed or oversized batch, retrying would fail forever
+        Serial.printf("[Influx] Batch rejected (HTTP %d), dropping %u lines\n", _lastStatus, lines);
+        _droppedCount += lines;
+        _pendingLen = 0;
+        _failures = 0;
+        return;
+    }
+
+    // Keep the batch and retry with exponential backoff
+    if (_failures < 16) {
+        _failures++;
+    }
+    uint32_t backoff = INFLUX_RETRY_MIN_MS << (_failures - 1);
+    if (backoff > INFLUX_RETRY_MAX_MS || _failures > 10) {
+        backoff = INFLUX_RETRY_MAX_MS;
+    }
+    _retryAt = millis() + backoff;
+
+    Serial.printf("[Influx] POST failed (%d), retrying in %lus\n", _lastStatus, backoff / 1000);
+}
+
+void InfluxExporter::sendThunk(void* arg) {
+    InfluxSendTaskArgs* args = reinterpret_cast<InfluxSendTaskArgs*>(arg);
+    InfluxExporter* self = args->self;
+    self->runSendTask(args->config);
+    delete args;
+    self->_sending = false;
+    vTaskDelete(nullptr);
+}
+
+void InfluxExporter::runSendTask(const InfluxConfig& config) {
+    // InfluxDB defaults to nanosecond precision, our timestamps are ms
+    String url = config.url;
+    if (url.indexOf("precision=") < 0) {
+        url += (url.indexOf('?') < 0) ? "?precision=ms" : "&precision=ms";
+    }
+
+    uint8_t* body = reinterpret_cast<uint8_t*>(_pending);
+    size_t bodyLen = _pendingLen;
+    uint8_t* compressed = nullptr;
+
+    if (config.gzip) {
+        size_t cap = gzipMaxCompressedSize(_pendingLen);
+        compressed = static_cast<uint8_t*>(malloc(cap));
+        size_t n = compressed ? GzipEncoder::compress(body, bodyLen, compressed, cap) : 0;
+        if (n > 0) {
+            body = compressed;
+            bodyLen = n;
+        }
+    }
+
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    bool https = url.startsWith("https://");
+    if (https) {
+        secureClient.setInsecure();
+    }
+
+    HTTPClient http;
+    http.setTimeout(INFLUX_HTTP_TIMEOUT_MS);
+    http.setReuse(false);
+
+    int code;
+    if (http.begin(https ? secureClient : plainClient, url)) {
+        http.addHeader("Content-Type", "text/plain; charset=utf-8");
+        if (body == compressed) {
+            http.addHeader("Content-Encoding", "gzip");
+        }
+        if (config.token[0] != '\0') {
+            http.addHeader("Authorization", String("Token ") + config.token);
+        }
+        code = http.POST(body, bodyLen);
+        http.end();
+    } else {
+        code = -1;
+    }
+
+    free(compressed);
+
+    _lastStatus = code;
+    _lastWireBytes = bodyLen;
+    _sendOk = code >= 200 && code < 300;
+    _sendRejected = code == 400 || code == 413 || code == 422;
+}
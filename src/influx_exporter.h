@@ -0,0 +1,162 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * InfluxDB Exporter Header
+ *
+ * Pushes readings to InfluxDB (v1 or v2 write API) as line protocol:
+ * - Lines are batched over a configurable window
+ * - Optional gzip request body
+ * - HTTP POST runs in a background task, never blocking the main loop
+ * - Store-and-forward: failed batches are kept and retried with backoff;
+ *   when the bounded buffers are full the oldest lines are dropped
+ */
+
+#ifndef INFLUX_EXPORTER_H
+#define INFLUX_EXPORTER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+// ============================================================================
+// InfluxExporter Class
+// ============================================================================
+
+class InfluxExporter {
+public:
+    /**
+     * Constructor
+     */
+    InfluxExporter();
+
+    /**
+     * Update exporter (call in main loop)
+     * Appends new readings to the batch and starts a POST when the window elapses
+     */
+    void update();
+
+    /**
+     * Apply changed configuration and send the current batch immediately
+     * Safe to call from async web handlers
+     */
+    void reconfigure() { _reconfigureRequested = true; }
+
+    /**
+     * Check if a POST is currently in flight
+     */
+    bool isSending() const { return _sending; }
+
+    /**
+     * Get number of successfully delivered batches
+     */
+    uint32_t getBatchCount() const { return _batchCount; }
+
+    /**
+     * Get number of delivered lines
+     */
+    uint32_t getLineCount() const { return _lineCount; }
+
+    /**
+     * Get number of bytes sent on the wire (after compression)
+     */
+    uint32_t getBytesSent() const { return _bytesSent; }
+
+    /**
+     * Get number of failed POST attempts
+     */
+    uint32_t getErrorCount() const { return _errorCount; }
+
+    /**
+     * Get number of lines discarded (buffer overflow or rejected by server)
+     */
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+    /**
+     * Get number of bytes waiting to be delivered
+     */
+    size_t getBufferedBytes() const { return _activeLen + _pendingLen; }
+
+    /**
+     * Get HTTP status (or negative HTTPClient error) of the last attempt
+     */
+    int getLastStatus() const { return _lastStatus; }
+
+private:
+    char* _active;                      // Batch being filled by update()
+    char* _pending;                     // Batch owned by the send task while _sending
+    size_t _activeLen;
+    size_t _pendingLen;
+
+    TaskHandle_t _task;
+    volatile bool _sending;
+    volatile bool _sendOk;
+    volatile bool _sendRejected;        // Server refused the data (4xx), do not retry
+    volatile int _lastStatus;
+    volatile uint32_t _lastWireBytes;
+
+    uint32_t _lastGeneration;
+    uint32_t _batchStart;
+    uint32_t _retryAt;
+    uint8_t _failures;
+
+    uint32_t _batchCount;
+    uint32_t _lineCount;
+    uint32_t _bytesSent;
+    uint32_t _errorCount;
+    uint32_t _droppedCount;
+    bool _flushRequested;
+    volatile bool _reconfigureRequested;
+
+    /**
+     * Allocate the batch buffers
+     * @return true if buffers are available
+     */
+    bool allocateBuffers();
+
+    /**
+     * Free the batch buffers (only when no send is in flight)
+     */
+    void freeBuffers();
+
+    /**
+     * Append one line per connected sensor to the active batch
+     */
+    void appendReadings();
+
+    /**
+     * Append a single line, dropping the oldest buffered lines if needed
+     */
+    void appendLine(const char* line, size_t len);
+
+    /**
+     * Remove whole lines from the front of a buffer
+     * @return number of lines removed
+     */
+    uint16_t dropOldest(char* buffer, size_t& len, size_t needed);
+
+    /**
+     * Move whole lines from the active batch onto the end of a retained
+     * pending batch, keeping lines in chronological order
+     */
+    void mergeIntoPending();
+
+    /**
+     * Handle the outcome of a finished send task
+     */
+    void completeSend();
+
+    /**
+     * Move the active batch into the pending buffer and start the send task
+     */
+    void startSend();
+
+    static void sendThunk(void* arg);
+    void runSendTask(const InfluxConfig& config);
+};
+
+// Global InfluxDB exporter instance
+extern InfluxExporter influxExporter;
+
+#endif // INFLUX_EXPORTER_H
@@ -30,6 +30,15 @@
 #include "web_server.h"
 #include "display_manager.h"
 #include "ota_manager.h"
+#include "udp_telemetry.h"
+#include "hub_receiver.h"
+#include "sensor_ingest.h"
+#include "influx_exporter.h"
+#include "coap_server.h"
+#include "mdns_advertiser.h"
+#include "notification_manager.h"
+#include "sleep_manager.h"
+#include "boot_metrics.h"
 
 // ============================================================================
 // Global State
@@ -39,6 +48,11 @@ static uint32_t lastStatusPrint = 0;
 static uint32_t lastLedToggle = 0;
 static bool ledState = false;
 
+// Sensor discovery runs in a boot task while the main task starts the display
+static TaskHandle_t sensorBootTask = nullptr;
+static volatile bool sensorBootDone = false;
+static bool sensorsFound = false;
+
 #ifdef USE_DISPLAY
 static uint32_t lastButton1State = HIGH;
 static uint32_t lastButton2State = HIGH;
@@ -77,6 +91,9 @@ void onAlarmStateChange(uint8_t sensorIndex, AlarmState oldState,
         mqttClient.publishAlarm(sensorIndex, newState, temperature);
     }
     
+    // Queue webhook notifications (delivered in the background)
+    notificationManager.notifyAlarm(sensorIndex, oldState, newState, temperature);
+    
     // Send WebSocket notification
     char message[64];
     if (newState == AlarmState::ABOVE_HIGH) {
@@ -124,6 +141,10 @@ void onSensorConnectionChange(uint8_t sensorIndex, bool connected) {
 void onWiFiStateChange(WiFiState oldState, WiFiState newState) {
     if (newState == WiFiState::CONNECTED) {
         Serial.println(F("[MAIN] WiFi connected, starting services..."));
+        bootMetrics.mark(BootStage::WIFI_CONNECTED);
+        
+        // Sync clock (exported readings carry absolute timestamps)
+        configTime(configManager.getSystemConfig().utcOffset * 3600L, 0, NTP_SERVER);
         
         // Initialize MQTT
         mqttClient.begin();
@@ -217,6 +238,49 @@ void printStatus() {
     Serial.println(F("====================================\n"));
 }
 
+// ============================================================================
+// Staged Boot
+// ============================================================================
+
+/**
+ * Boot task: OneWire bus search and first conversion (core 0)
+ */
+void sensorBootThunk(void* param) {
+    sensorsFound = sensorManager.begin();
+    bootMetrics.mark(BootStage::SENSORS_READY);
+    sensorBootDone = true;
+    vTaskDelete(nullptr);
+}
+
+/**
+ * Start sensor discovery in the background (inline if no task can be created)
+ */
+void startSensorDiscovery() {
+    BaseType_t created = xTaskCreatePinnedToCore(
+        sensorBootThunk, "sensor_boot", 8192, nullptr, 1, &sensorBootTask, 0);
+    
+    if (created != pdPASS) {
+        Serial.println(F("[MAIN] Boot task unavailable, discovering sensors inline"));
+        sensorBootTask = nullptr;
+        sensorBootThunk(nullptr);
+    }
+}
+
+/**
+ * Wait for sensor discovery to finish
+ * Anything that reads sensor data (web server, loop) must start after this
+ */
+void waitForSensorDiscovery() {
+    if (!sensorBootTask) {
+        return;     // Ran inline
+    }
+    
+    while (!sensorBootDone) {
+        delay(5);
+    }
+    sensorBootTask = nullptr;
+}
+
 // ============================================================================
 // Setup
 // ============================================================================
@@ -224,7 +288,16 @@ void printStatus() {
 void setup() {
     // Initialize serial
     Serial.begin(115200);
-    delay(1000);
+    
+    // Initialize configuration manager first: battery mode decides what starts
+    bool configOk = configManager.begin();
+    bootMetrics.mark(BootStage::CONFIG_LOADED);
+    
+    // Battery-mode timer wakes only sample the sensors and sleep again
+    if (sleepManager.isBatteryWake()) {
+        sensorManager.setAlarmCallback(onAlarmStateChange);
+        sleepManager.runWakeCycles();   // Does not return
+    }
     
     Serial.println(F("\n"));
     Serial.println(F("╔════════════════════════════════════════╗"));
@@ -240,6 +313,22 @@ void setup() {
     // Initialize LED pin
     pinMode(LED_PIN, OUTPUT);
     digitalWrite(LED_PIN, LOW);
+    
+    if (!configOk) {
+        Serial.println(F("[MAIN] ERROR: Failed to initialize configuration!"));
+    }
+    
+    // Stage 1: the slow subsystems overlap -
+    // sensor discovery in a boot task, WiFi association in the WiFi driver,
+    // display init on this task
+    Serial.println(F("[MAIN] Initializing sensors..."));
+    sensorManager.setAlarmCallback(onAlarmStateChange);
+    sensorManager.setConnectionCallback(onSensorConnectionChange);
+    startSensorDiscovery();
+    
+    Serial.println(F("[MAIN] Initializing WiFi..."));
+    wifiManager.setStateCallback(onWiFiStateChange);
+    wifiManager.begin();
 
 #ifdef USE_DISPLAY
     // Initialize buttons
@@ -249,32 +338,20 @@ void setup() {
     // Initialize display
     Serial.println(F("[MAIN] Initializing display..."));
     displayManager.begin();
+    bootMetrics.mark(BootStage::DISPLAY_READY);
     Serial.printf("[MAIN] After display: %u bytes free\n", ESP.getFreeHeap());
 #endif
     
-    // Initialize configuration manager (loads from SPIFFS)
-    Serial.println(F("[MAIN] Initializing configuration..."));
-    if (!configManager.begin()) {
-        Serial.println(F("[MAIN] ERROR: Failed to initialize configuration!"));
-    }
-    
-    // Initialize sensor manager
-    Serial.println(F("[MAIN] Initializing sensors..."));
-    sensorManager.setAlarmCallback(onAlarmStateChange);
-    sensorManager.setConnectionCallback(onSensorConnectionChange);
-    
-    if (!sensorManager.begin()) {
+    // Stage 2: everything below reads sensor data
+    waitForSensorDiscovery();
+    if (!sensorsFound) {
         Serial.println(F("[MAIN] WARNING: No sensors found at startup"));
     }
     
-    // Initialize WiFi manager
-    Serial.println(F("[MAIN] Initializing WiFi..."));
-    wifiManager.setStateCallback(onWiFiStateChange);
-    wifiManager.begin();
-    
     // Initialize web server (works in both AP and STA mode)
     Serial.println(F("[MAIN] Initializing web server..."));
     webServer.begin();
+    bootMetrics.mark(BootStage::WEB_READY);
     Serial.printf("[MAIN] After web server: %u bytes free\n", ESP.getFreeHeap());
     
     // Initialize OTA manager only if not in AP mode (requires internet connection)
@@ -293,6 +370,7 @@ void setup() {
 #endif
     
     // Print initial status
+    bootMetrics.mark(BootStage::SETUP_DONE);
     Serial.println(F("\n[MAIN] Initialization complete!"));
     Serial.println(F("[MAIN] Access the dashboard at:"));
     
@@ -319,6 +397,24 @@ void loop() {
     // Update sensor manager (handles reading and alarms)
     sensorManager.update();
     
+    // Broadcast new readings to LAN listeners (UDP multicast)
+    udpTelemetry.update();
+    
+    // Merge peer station readings as remote sensors (hub mode)
+    hubReceiver.update();
+    
+    // Apply readings from satellite devices (REST / MQTT ingestion)
+    sensorIngest.update();
+    
+    // Batch readings and push to InfluxDB (POST runs in background task)
+    influxExporter.update();
+    
+    // Deliver queued webhook notifications (POST runs in background task)
+    notificationManager.update();
+    
+    // Enter battery mode once the configuration window has passed
+    sleepManager.update();
+    
     // Update MQTT client (handles publishing)
     if (wifiManager.isConnected()) {
         mqttClient.update();
@@ -327,6 +423,12 @@ void loop() {
     // Update web server (handles WebSocket updates)
     webServer.update();
     
+    // Answer CoAP requests and push Observe notifications
+    coapServer.update();
+    
+    // Advertise the station and its summary over mDNS
+    mdnsAdvertiser.update();
+    
     // Handle OTA updates (GitHub releases only)
     if (wifiManager.isConnected() && configManager.getSystemConfig().otaEnabled) {
         otaManager.update(); // Daily background check for GitHub releases
@@ -0,0 +1,122 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * mDNS Advertiser Implementation
+ */
+
+#include "mdns_advertiser.h"
+#include <ESPmDNS.h>
+#include "wifi_manager.h"
+
+// Global instance
+MdnsAdvertiser mdnsAdvertiser;
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+MdnsAdvertiser::MdnsAdvertiser() :
+    _active(false),
+    _lastAttempt(0),
+    _lastGenerationUpdate(0),
+    _txtUpdates(0),
+    _sensorCount(-1),
+    _alarmCount(-1),
+    _generation(0) {
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void MdnsAdvertiser::update() {
+    if (!wifiManager.isConnected()) {
+        if (_active) {
+            stop();
+        }
+        return;
+    }
+
+    if (!_active) {
+        if (_lastAttempt != 0 && millis() - _lastAttempt < MDNS_RETRY_INTERVAL_MS) {
+            return;
+        }
+        if (!start()) {
+            _lastAttempt = millis();
+            if (_lastAttempt == 0) {
+                _lastAttempt = 1;
+            }
+        }
+        return;
+    }
+
+    // Counts are what scanners act on: announce them as soon as they change
+    uint8_t sensors = sensorManager.getSensorCount();
+    if (sensors != _sensorCount) {
+        _sensorCount = sensors;
+        setTxt("sensors", sensors);
+    }
+
+    uint8_t alarms = sensorManager.getAlarmCount();
+    if (alarms != _alarmCount) {
+        _alarmCount = alarms;
+        setTxt("alarms", alarms);
+    }
+
+    // Each TXT change is multicast to the whole LAN: rate-limit the
+    // generation, which changes every read cycle
+    uint32_t generation = sensorManager.getReadGeneration();
+    if (generation != _generation && millis() - _lastGenerationUpdate >= MDNS_GENERATION_INTERVAL_MS) {
+        _generation = generation;
+        _lastGenerationUpdate = millis();
+        setTxt("gen", generation);
+    }
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+bool MdnsAdvertiser::start() {
+    String hostname = wifiManager.getHostname();
+    if (!MDNS.begin(hostname.c_str())) {
+        Serial.println(F("[mDNS] Failed to start responder"));
+        return false;
+    }
+
+    if (!MDNS.addService(MDNS_SERVICE_NAME, "tcp", WEB_SERVER_PORT)) {
+        Serial.println(F("[mDNS] Failed to add service"));
+        MDNS.end();
+        return false;
+    }
+
+    _active = true;
+    _lastAttempt = 0;
+
+    _sensorCount = sensorManager.getSensorCount();
+    _alarmCount = sensorManager.getAlarmCount();
+    _generation = sensorManager.getReadGeneration();
+    _lastGenerationUpdate = millis();
+
+    MDNS.addServiceTxt(MDNS_SERVICE_NAME, "tcp", "fw", FIRMWARE_VERSION);
+    setTxt("sensors", _sensorCount);
+    setTxt("alarms", _alarmCount);
+    setTxt("gen", _generation);
+
+    Serial.printf("[mDNS] Advertising _%s._tcp as %s.local\n", MDNS_SERVICE_NAME, hostname.c_str());
+    return true;
+}
+
+void MdnsAdvertiser::stop() {
+    MDNS.end();
+    _active = false;
+    _sensorCount = -1;
+    _alarmCount = -1;
+    Serial.println(F("[mDNS] Stopped"));
+}
+
+void MdnsAdvertiser::setTxt(const char* key, uint32_t value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%lu", (unsigned long)value);
+    MDNS.addServiceTxt(MDNS_SERVICE_NAME, "tcp", key, text);
+    _txtUpdates++;
+}
@@ -0,0 +1,78 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * mDNS Advertiser Header
+ *
+ * Advertises the station as _tempmon._tcp so fleet tooling can find it
+ * without scanning subnets. TXT records carry a summary that scanners can
+ * read without any HTTP request:
+ * - fw: firmware version
+ * - sensors: number of sensors
+ * - alarms: number of sensors in alarm
+ * - gen: read generation (re-announced at most every
+ *   MDNS_GENERATION_INTERVAL_MS)
+ */
+
+#ifndef MDNS_ADVERTISER_H
+#define MDNS_ADVERTISER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_manager.h"
+
+// ============================================================================
+// MdnsAdvertiser Class
+// ============================================================================
+
+class MdnsAdvertiser {
+public:
+    /**
+     * Constructor
+     */
+    MdnsAdvertiser();
+
+    /**
+     * Update advertisement (call in main loop)
+     * Starts the responder once WiFi is connected and refreshes TXT records
+     */
+    void update();
+
+    /**
+     * Check if the service is being advertised
+     */
+    bool isActive() const { return _active; }
+
+    /**
+     * Get number of TXT record updates announced
+     */
+    uint32_t getTxtUpdateCount() const { return _txtUpdates; }
+
+private:
+    bool _active;
+    uint32_t _lastAttempt;              // millis() of the last failed start
+    uint32_t _lastGenerationUpdate;     // millis() the gen record was last set
+    uint32_t _txtUpdates;
+    int16_t _sensorCount;               // Last announced values (-1 = none)
+    int16_t _alarmCount;
+    uint32_t _generation;
+
+    /**
+     * Start the responder and add the service with its TXT records
+     * @return true if advertising
+     */
+    bool start();
+
+    /**
+     * Stop the responder
+     */
+    void stop();
+
+    /**
+     * Set a numeric TXT record
+     */
+    void setTxt(const char* key, uint32_t value);
+};
+
+// Global mDNS advertiser instance
+extern MdnsAdvertiser mdnsAdvertiser;
+
+#endif // MDNS_ADVERTISER_H
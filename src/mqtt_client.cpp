@@ -6,6 +6,8 @@
 #include "mqtt_client.h"
 #include <ArduinoJson.h>
 #include "wifi_manager.h"
+#include "boot_metrics.h"
+#include "sensor_ingest.h"
 
 // Global instance
 MQTTClient mqttClient;
@@ -13,6 +15,11 @@ MQTTClient mqttClient;
 // Static callback wrapper
 static MQTTClient* _mqttInstance = nullptr;
 
+// Heat-flow virtual sensors report power instead of temperature
+static bool isHeatFlowSensor(uint8_t sensorIndex) {
+    return strcmp(sensorManager.getUnit(sensorIndex), "kW") == 0;
+}
+
 // ============================================================================
 // Constructor
 // ============================================================================
@@ -21,8 +28,10 @@ MQTTClient::MQTTClient() :
     _client(_wifiClient),
     _lastConnectAttempt(0),
     _lastPublishTime(0),
+    _lastDiagnosticsTime(0),
     _publishCount(0),
     _haDiscoveryPublished(false),
+    _haDiscoveryCount(0),
     _reconnectRequested(false),
     _otaInProgress(false) {
     _lastError[0] = '\0';
@@ -46,6 +55,9 @@ void MQTTClient::begin() {
     
     // Buffer size for larger messages (HA discovery payloads can be 600+ bytes)
     _client.setBufferSize(1024);
+    
+    // Connect on the next update instead of after a full reconnect interval
+    _lastConnectAttempt = millis() - MQTT_RECONNECT_INTERVAL;
 }
 
 void MQTTClient::setOtaMode(bool enabled) {
@@ -95,8 +107,10 @@ void MQTTClient::update() {
     // Process incoming messages
     _client.loop();
     
-    // Publish Home Assistant discovery once connected
-    if (!_haDiscoveryPublished) {
+    // Publish Home Assistant discovery once connected, and again when
+    // sensors are added (hot-plugged probes, hub peers)
+    if (!_haDiscoveryPublished || _haDiscoveryCount != sensorManager.getSensorCount()) {
+        _haDiscoveryCount = sensorManager.getSensorCount();
         publishHADiscovery();
         _haDiscoveryPublished = true;
     }
@@ -115,6 +129,11 @@ void MQTTClient::update() {
             _lastPublishTime = now;
         }
     }
+    
+    if (now - _lastDiagnosticsTime >= MQTT_DIAGNOSTICS_INTERVAL) {
+        publishDiagnostics();
+        _lastDiagnosticsTime = now;
+    }
 }
 
 bool MQTTClient::isEnabled() const {
@@ -184,7 +203,11 @@ void MQTTClient::publishSensorTemperature(uint8_t sensorIndex) {
     JsonDocument doc;
     doc["temperature"] = round(data->temperature * 100) / 100.0;
     doc["raw_temperature"] = round(data->rawTemperature * 100) / 100.0;
-    doc["unit"] = configManager.getSystemConfig().celsiusUnits ? "C" : "F";
+    if (isHeatFlowSensor(sensorIndex)) {
+        doc["unit"] = "kW";
+    } else {
+        doc["unit"] = configManager.getSystemConfig().celsiusUnits ? "C" : "F";
+    }
     doc["alarm"] = alarmStateToString(data->alarmState);
     doc["connected"] = data->connected;
     
@@ -199,6 +222,7 @@ void MQTTClient::publishSensorTemperature(uint8_t sensorIndex) {
     if (_client.publish(topic, payload)) {
         _publishCount++;
         _lastPublishedTemp[sensorIndex] = data->temperature;
+        bootMetrics.mark(BootStage::FIRST_PUBLISH);
     } else {
         strcpy(_lastError, "Failed to publish temperature");
         Serial.printf("[MQTT] Failed to publish to %s\n", topic);
@@ -223,6 +247,9 @@ void MQTTClient::publishAlarm(uint8_t sensorIndex, AlarmState state, float tempe
     doc["alarm"] = alarmStateToString(state);
     doc["temperature"] = round(temperature * 100) / 100.0;
     doc["timestamp"] = millis() / 1000;
+    if (data) {
+        doc["acknowledged"] = data->alarmAcknowledged;
+    }
     
     if (config) {
         doc["name"] = config->name;
@@ -243,6 +270,111 @@ void MQTTClient::publishAlarm(uint8_t sensorIndex, AlarmState state, float tempe
     }
 }
 
+void MQTTClient::publishDiagnostics() {
+    if (!_client.connected()) {
+        return;
+    }
+    
+    const MQTTConfig& mqttConfig = configManager.getMQTTConfig();
+    const SystemConfig& sysConfig = configManager.getSystemConfig();
+    
+    char topic[128];
+    snprintf(topic, sizeof(topic), "%s/%s/%s",
+        mqttConfig.topicPrefix,
+        sysConfig.deviceName,
+        TOPIC_DIAGNOSTICS
+    );
+    
+    BusDiagnostics bus = sensorManager.getBusDiagnostics();
+    
+    JsonDocument doc;
+    doc["backend"] = bus.backend;
+    doc["conversions"] = bus.conversions;
+    doc["reads"] = bus.reads;
+    doc["crcErrors"] = bus.crcErrors;
+    doc["presenceErrors"] = bus.presenceErrors;
+    doc["rangeErrors"] = bus.rangeErrors;
+    doc["retries"] = bus.retries;
+    doc["recovered"] = bus.recovered;
+    doc["skippedReads"] = bus.skippedReads;
+    doc["errorRate"] = roundf(bus.errorRate * 1000.0f) / 1000.0f;
+    doc["maxLatencyUs"] = bus.maxLatencyUs;
+    
+    char payload[256];
+    serializeJson(doc, payload, sizeof(payload));
+    
+    if (_client.publish(topic, payload)) {
+        _publishCount++;
+    } else {
+        strcpy(_lastError, "Failed to publish diagnostics");
+        return;
+    }
+    
+    // Per-sensor health (topic next to the sensor's temperature)
+    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        if (!data || data->source != SensorSource::PHYSICAL) {
+            continue;
+        }
+        
+        const SensorDiagnostics& diag = data->diag;
+        
+        buildSensorTopic(topic, sizeof(topic), i, TOPIC_DIAGNOSTICS);
+        
+        JsonDocument sensorDoc;
+        sensorDoc["address"] = data->addressStr;
+        sensorDoc["reads"] = diag.reads;
+        sensorDoc["crcErrors"] = diag.crcErrors;
+        sensorDoc["presenceErrors"] = diag.presenceErrors;
+        sensorDoc["rangeErrors"] = diag.rangeErrors;
+        sensorDoc["retries"] = diag.retries;
+        sensorDoc["recovered"] = diag.recovered;
+        sensorDoc["errorRate"] = roundf(diag.errorRate() * 1000.0f) / 1000.0f;
+        sensorDoc["latencyUs"] = diag.lastLatencyUs;
+        sensorDoc["maxLatencyUs"] = diag.maxLatencyUs;
+        
+        serializeJson(sensorDoc, payload, sizeof(payload));
+        
+        if (_client.publish(topic, payload)) {
+            _publishCount++;
+        }
+    }
+}
+
+bool MQTTClient::publishBatch(const char* payload) {
+    if (!_client.connected()) {
+        return false;
+    }
+    
+    const MQTTConfig& mqttConfig = configManager.getMQTTConfig();
+    const SystemConfig& sysConfig = configManager.getSystemConfig();
+    
+    char topic[128];
+    snprintf(topic, sizeof(topic), "%s/%s/%s",
+        mqttConfig.topicPrefix,
+        sysConfig.deviceName,
+        TOPIC_BATCH
+    );
+    
+    if (_client.publish(topic, payload)) {
+        _publishCount++;
+        return true;
+    }
+    strcpy(_lastError, "Failed to publish batch");
+    return false;
+}
+
+bool MQTTClient::connectNow() {
+    if (_otaInProgress || !isEnabled() || !wifiManager.isConnected()) {
+        return false;
+    }
+    if (_client.connected()) {
+        return true;
+    }
+    _lastConnectAttempt = millis();
+    return connect();
+}
+
 void MQTTClient::publishStatus(bool online) {
     if (!_client.connected() && online) {
         return;
@@ -428,6 +560,16 @@ void MQTTClient::buildSensorTopic(char* buffer, size_t bufferSize,
 }
 
 void MQTTClient::messageCallback(char* topic, byte* payload, unsigned int length) {
+    // Ingestion payloads are binary: hand them over before text handling
+    if (strstr(topic, "/cmd/ingest")) {
+        uint8_t accepted;
+        IngestStatus status = sensorIngest.submit(payload, length, accepted);
+        if (status != IngestStatus::OK) {
+            Serial.printf("[MQTT] Ingest message rejected (%u bytes, status %d)\n", length, (int)status);
+        }
+        return;
+    }
+    
     if (_mqttInstance) {
         // Null-terminate payload
         char message[256];
@@ -456,6 +598,17 @@ void MQTTClient::handleMessage(const char* topic, const char* payload) {
             Serial.printf("[MQTT] Calibration triggered with reference: %.2f\n", refTemp);
         }
     }
+    else if (strstr(topic, "/cmd/ack")) {
+        // Acknowledge alarms: sensor index, or all active alarms if empty
+        if (payload[0] != '\0') {
+            sensorManager.acknowledgeAlarm(atoi(payload));
+        } else {
+            for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+                sensorManager.acknowledgeAlarm(i);
+            }
+        }
+        Serial.println(F("[MQTT] Alarm acknowledge requested"));
+    }
     else if (strstr(topic, "/cmd/rescan")) {
         // Rescan sensors
         sensorManager.requestRescan();
@@ -523,8 +676,13 @@ void MQTTClient::publishHADiscoverySensor(uint8_t sensorIndex) {
     doc["unique_id"] = uniqueId;
     doc["state_topic"] = stateTopic;
     doc["value_template"] = "{{ value_json.temperature }}";
-    doc["unit_of_measurement"] = sysConfig.celsiusUnits ? "°C" : "°F";
-    doc["device_class"] = "temperature";
+    if (isHeatFlowSensor(sensorIndex)) {
+        doc["unit_of_measurement"] = "kW";
+        doc["device_class"] = "power";
+    } else {
+        doc["unit_of_measurement"] = sysConfig.celsiusUnits ? "°C" : "°F";
+        doc["device_class"] = "temperature";
+    }
     doc["state_class"] = "measurement";
     
     // Device info - all sensors share the same device (the ESP32 hardware)
@@ -32,6 +32,8 @@ constexpr char TOPIC_TEMPERATURE[] = "temperature";
 constexpr char TOPIC_ALARM[] = "alarm";
 constexpr char TOPIC_COMMAND[] = "cmd";
 constexpr char TOPIC_CONFIG[] = "config";
+constexpr char TOPIC_BATCH[] = "batch";
+constexpr char TOPIC_DIAGNOSTICS[] = "diagnostics";
 
 // Home Assistant discovery prefix
 constexpr char HA_DISCOVERY_PREFIX[] = "homeassistant";
@@ -102,6 +104,25 @@ public:
      */
     void publishAlarm(uint8_t sensorIndex, AlarmState state, float temperature);
     
+    /**
+     * Publish OneWire bus diagnostics (bus summary and one message per sensor)
+     */
+    void publishDiagnostics();
+    
+    /**
+     * Publish samples buffered during battery mode
+     * @param payload JSON batch (see SleepManager)
+     * @return true if published
+     */
+    bool publishBatch(const char* payload);
+    
+    /**
+     * Connect immediately instead of waiting for update()
+     * Battery mode wakes are too short for the reconnect interval
+     * @return true if connected
+     */
+    bool connectNow();
+    
     /**
      * Publish device status (online/offline)
      * @param online true if online
@@ -135,10 +156,12 @@ private:
     
     uint32_t _lastConnectAttempt;
     uint32_t _lastPublishTime;
+    uint32_t _lastDiagnosticsTime;
     uint32_t _publishCount;
     float _lastPublishedTemp[MAX_SENSORS];
     char _lastError[64];
     bool _haDiscoveryPublished;
+    uint8_t _haDiscoveryCount;          // Sensor count when discovery was published
     volatile bool _reconnectRequested;
     volatile bool _otaInProgress;
     
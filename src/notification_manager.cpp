@@ -0,0 +1,520 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Webhook Notification Manager Implementation
+ */
+
+#include "notification_manager.h"
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <new>
+#include "wifi_manager.h"
+
+// Global instance
+NotificationManager notificationManager;
+
+namespace {
+
+struct NotifySendTaskArgs {
+    NotificationManager* self;
+    WebhookConfig config;               // Snapshot, web handlers may edit the live copy
+    char body[NOTIFY_BODY_MAX_LEN];
+};
+
+constexpr char DEFAULT_TEMPLATE[] =
+    "{\"event\":\"{{event}}\",\"device\":\"{{device}}\",\"sensor\":\"{{sensor}}\","
+    "\"address\":\"{{address}}\",\"state\":\"{{state}}\",\"previous\":\"{{previous}}\","
+    "\"value\":{{value}},\"unit\":\"{{unit}}\",\"timestamp\":{{timestamp}}}";
+
+bool isThresholdAlarm(AlarmState state) {
+    return state == AlarmState::ABOVE_HIGH || state == AlarmState::BELOW_LOW;
+}
+
+/**
+ * Append a string, escaping it for use inside a JSON string literal
+ */
+size_t appendJsonEscaped(char* out, size_t size, size_t pos, const char* src) {
+    for (; *src && pos + 1 < size; src++) {
+        unsigned char c = (unsigned char)*src;
+        if (c == '"' || c == '\\') {
+            if (pos + 2 >= size) break;
+            out[pos++] = '\\';
+            out[pos++] = (char)c;
+        } else if (c < 0x20) {
+            if (pos + 6 >= size) break;
+            pos += snprintf(out + pos, size - pos, "\\u%04x", c);
+        } else {
+            out[pos++] = (char)c;
+        }
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+size_t appendRaw(char* out, size_t size, size_t pos, const char* src) {
+    while (*src && pos + 1 < size) {
+        out[pos++] = *src++;
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+NotificationManager::NotificationManager() :
+    _nextSequence(0),
+    _inFlight(-1),
+    _droppedCount(0),
+    _errorAnnounced(0),
+    _task(nullptr),
+    _sending(false),
+    _sendOk(false),
+    _sendRetryable(false),
+    _lastStatus(0),
+    _lastLatencyMs(0),
+    _testRequests(0),
+    _reconfigureRequested(false) {
+    memset(_queue, 0, sizeof(_queue));
+    memset(_stats, 0, sizeof(_stats));
+    memset(_lastSendMs, 0, sizeof(_lastSendMs));
+    memset(_hasSent, 0, sizeof(_hasSent));
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void NotificationManager::update() {
+    // Collect result of a finished send task
+    if (_task && !_sending) {
+        _task = nullptr;
+        completeSend();
+    }
+
+    // Handle reconfigure request from web handlers (thread-safe)
+    if (_reconfigureRequested) {
+        _reconfigureRequested = false;
+        for (uint8_t i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+            Delivery& delivery = _queue[i];
+            if (!delivery.used || (int8_t)i == _inFlight) {
+                continue;
+            }
+            const WebhookConfig* config = configManager.getWebhookConfig(delivery.slot);
+            if (!config || !config->enabled || config->url[0] == '\0') {
+                delivery.used = false;
+            } else {
+                delivery.nextAttemptMs = millis();
+            }
+        }
+    }
+
+    // Queue test events requested from the web UI
+    uint32_t tests = __atomic_exchange_n(&_testRequests, 0, __ATOMIC_ACQ_REL);
+    if (tests) {
+        NotificationEvent event = {};
+        event.type = NotificationEventType::TEST;
+        event.state = AlarmState::NORMAL;
+        event.previous = AlarmState::NORMAL;
+        event.value = TEMP_INVALID;
+        time_t epoch = time(nullptr);
+        event.timestamp = epoch >= MIN_VALID_EPOCH ? (uint32_t)epoch : 0;
+        event.uptime = millis() / 1000;
+        strlcpy(event.name, "Test", sizeof(event.name));
+
+        for (uint8_t slot = 0; slot < MAX_WEBHOOKS; slot++) {
+            if (tests & (1 << slot)) {
+                enqueue(slot, event);
+            }
+        }
+    }
+
+    if (_sending || !wifiManager.isConnected()) {
+        return;
+    }
+
+    int8_t index = nextDue(millis());
+    if (index >= 0) {
+        startSend(index);
+    }
+}
+
+void NotificationManager::notifyAlarm(uint8_t sensorIndex, AlarmState oldState,
+                                      AlarmState newState, float value) {
+    NotificationEventType type;
+    uint32_t bit = 1UL << sensorIndex;
+
+    if (newState == AlarmState::NORMAL) {
+        // Sensors start in the error state, so only a recovery from an
+        // error we reported counts as a clear
+        bool wasError = oldState == AlarmState::SENSOR_ERROR && (_errorAnnounced & bit);
+        if (!isThresholdAlarm(oldState) && !wasError) {
+            return;
+        }
+        type = NotificationEventType::CLEAR;
+        _errorAnnounced &= ~bit;
+    } else {
+        type = NotificationEventType::ALARM;
+        if (newState == AlarmState::SENSOR_ERROR) {
+            _errorAnnounced |= bit;
+        } else {
+            _errorAnnounced &= ~bit;
+        }
+    }
+
+    uint8_t mask = type == NotificationEventType::ALARM ? WEBHOOK_EVENT_ALARM : WEBHOOK_EVENT_CLEAR;
+
+    NotificationEvent event = {};
+    bool prepared = false;
+
+    for (uint8_t slot = 0; slot < MAX_WEBHOOKS; slot++) {
+        const WebhookConfig* config = configManager.getWebhookConfig(slot);
+        if (!config->enabled || config->url[0] == '\0' || !(config->events & mask)) {
+            continue;
+        }
+
+        if (!prepared) {
+            prepared = true;
+            event.type = type;
+            event.state = newState;
+            event.previous = oldState;
+            event.value = value;
+            time_t epoch = time(nullptr);
+            event.timestamp = epoch >= MIN_VALID_EPOCH ? (uint32_t)epoch : 0;
+            event.uptime = millis() / 1000;
+
+            const SensorData* data = sensorManager.getSensorData(sensorIndex);
+            if (data) {
+                strlcpy(event.address, data->addressStr, sizeof(event.address));
+                const SensorConfig* sensorConfig = configManager.getSensorConfigByAddress(data->addressStr);
+                strlcpy(event.name, sensorConfig ? sensorConfig->name : data->addressStr, sizeof(event.name));
+                strlcpy(event.unit, sensorManager.getUnit(sensorIndex), sizeof(event.unit));
+            }
+        }
+
+        enqueue(slot, event);
+    }
+}
+
+bool NotificationManager::requestTest(uint8_t slot) {
+    if (slot >= MAX_WEBHOOKS) {
+        return false;
+    }
+    // Called from the AsyncTCP task while update() may be taking the mask
+    __atomic_fetch_or(&_testRequests, 1UL << slot, __ATOMIC_ACQ_REL);
+    return true;
+}
+
+const WebhookStats* NotificationManager::getStats(uint8_t slot) const {
+    if (slot >= MAX_WEBHOOKS) {
+        return nullptr;
+    }
+    return &_stats[slot];
+}
+
+uint8_t NotificationManager::getQueuedCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+        if (_queue[i].used) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t NotificationManager::getDeliveredCount() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < MAX_WEBHOOKS; i++) {
+        total += _stats[i].delivered;
+    }
+    return total;
+}
+
+uint32_t NotificationManager::getFailedCount() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < MAX_WEBHOOKS; i++) {
+        total += _stats[i].failed;
+    }
+    return total;
+}
+
+// ============================================================================
+// Queue
+// ============================================================================
+
+void NotificationManager::enqueue(uint8_t slot, const NotificationEvent& event) {
+    int8_t freeIndex = -1;
+    int8_t oldest = -1;
+
+    for (uint8_t i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+        if (!_queue[i].used) {
+            if (freeIndex < 0) {
+                freeIndex = i;
+            }
+        } else if ((int8_t)i != _inFlight &&
+                   (oldest < 0 || (int32_t)(_queue[i].sequence - _queue[oldest].sequence) < 0)) {
+            oldest = i;
+        }
+    }
+
+    if (freeIndex < 0) {
+        if (oldest < 0) {
+            _droppedCount++;
+            return;
+        }
+        Serial.printf("[Notify] Queue full, dropping %s event for webhook %u\n",
+            notificationEventToString(_queue[oldest].event.type), _queue[oldest].slot);
+        _droppedCount++;
+        freeIndex = oldest;
+    }
+
+    Delivery& delivery = _queue[freeIndex];
+    delivery.used = true;
+    delivery.slot = slot;
+    delivery.attempts = 0;
+    delivery.sequence = _nextSequence++;
+    delivery.nextAttemptMs = millis();
+    delivery.event = event;
+}
+
+int8_t NotificationManager::nextDue(uint32_t now) {
+    int8_t best = -1;
+
+    for (uint8_t i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+        const Delivery& delivery = _queue[i];
+        if (!delivery.used || (int32_t)(now - delivery.nextAttemptMs) < 0) {
+            continue;
+        }
+
+        const WebhookConfig* config = configManager.getWebhookConfig(delivery.slot);
+        uint32_t minInterval = (uint32_t)config->minInterval * 1000UL;
+        if (_hasSent[delivery.slot] && now - _lastSendMs[delivery.slot] < minInterval) {
+            continue;
+        }
+
+        if (best < 0 || (int32_t)(delivery.sequence - _queue[best].sequence) < 0) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// Sending
+// ============================================================================
+
+void NotificationManager::startSend(int8_t index) {
+    Delivery& delivery = _queue[index];
+    const WebhookConfig* config = configManager.getWebhookConfig(delivery.slot);
+
+    NotifySendTaskArgs* args = new (std::nothrow) NotifySendTaskArgs;
+    if (!args) {
+        Serial.println(F("[Notify] Out of memory starting send task"));
+        return;
+    }
+    args->self = this;
+    args->config = *config;
+
+    if (renderNotificationBody(config->bodyTemplate, delivery.event, args->body, sizeof(args->body)) == 0) {
+        // Template too long for the body buffer, retrying cannot help
+        Serial.printf("[Notify] Body for webhook %u exceeds %u bytes, dropping event\n",
+            delivery.slot, (unsigned)NOTIFY_BODY_MAX_LEN);
+        _stats[delivery.slot].failed++;
+        delivery.used = false;
+        delete args;
+        return;
+    }
+
+    _inFlight = index;
+    _lastSendMs[delivery.slot] = millis();
+    _hasSent[delivery.slot] = true;
+    if (delivery.attempts > 0) {
+        _stats[delivery.slot].retries++;
+    }
+    delivery.attempts++;
+
+    _sending = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(sendThunk, "notify_send", 8192, args, 1, &_task, 0);
+    if (ok != pdPASS) {
+        delete args;
+        _sending = false;
+        _task = nullptr;
+        _inFlight = -1;
+        delivery.attempts--;
+        Serial.println(F("[Notify] Failed to start send task"));
+    }
+}
+
+void NotificationManager::completeSend() {
+    if (_inFlight < 0) {
+        return;
+    }
+    Delivery& delivery = _queue[_inFlight];
+    _inFlight = -1;
+
+    WebhookStats& stats = _stats[delivery.slot];
+    stats.lastStatus = _lastStatus;
+    stats.lastLatencyMs = _lastLatencyMs;
+
+    if (_sendOk) {
+        stats.delivered++;
+        delivery.used = false;
+        DEBUG_PRINTF("[Notify] Webhook %u: %s delivered in %lums\n", delivery.slot,
+            notificationEventToString(delivery.event.type), (unsigned long)_lastLatencyMs);
+        return;
+    }
+
+    if (!_sendRetryable || delivery.attempts >= NOTIFY_MAX_ATTEMPTS) {
+        Serial.printf("[Notify] Webhook %u: giving up after %u attempts (%d)\n",
+            delivery.slot, delivery.attempts, _lastStatus);
+        stats.failed++;
+        delivery.used = false;
+        return;
+    }
+
+    // Retry with exponential backoff
+    uint32_t backoff = NOTIFY_RETRY_MIN_MS << (delivery.attempts - 1);
+    if (backoff > NOTIFY_RETRY_MAX_MS || delivery.attempts > 10) {
+        backoff = NOTIFY_RETRY_MAX_MS;
+    }
+    delivery.nextAttemptMs = millis() + backoff;
+
+    Serial.printf("[Notify] Webhook %u: POST failed (%d), retrying in %lus\n",
+        delivery.slot, _lastStatus, backoff / 1000);
+}
+
+void NotificationManager::sendThunk(void* arg) {
+    NotifySendTaskArgs* args = reinterpret_cast<NotifySendTaskArgs*>(arg);
+    NotificationManager* self = args->self;
+    self->runSendTask(args->config, args->body);
+    delete args;
+    self->_sending = false;
+    vTaskDelete(nullptr);
+}
+
+void NotificationManager::runSendTask(const WebhookConfig& config, const char* body) {
+    String url = config.url;
+
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    bool https = url.startsWith("https://");
+    if (https) {
+        secureClient.setInsecure();
+    }
+
+    HTTPClient http;
+    http.setTimeout(NOTIFY_HTTP_TIMEOUT_MS);
+    http.setReuse(false);
+
+    uint32_t start = millis();
+    int code;
+    if (http.begin(https ? secureClient : plainClient, url)) {
+        http.addHeader("Content-Type", "application/json");
+        if (config.auth[0] != '\0') {
+            http.addHeader("Authorization", config.auth);
+        }
+        code = http.POST(reinterpret_cast<uint8_t*>(const_cast<char*>(body)), strlen(body));
+        http.end();
+    } else {
+        code = -1;
+    }
+
+    _lastStatus = code;
+    _lastLatencyMs = millis() - start;
+    _sendOk = code >= 200 && code < 300;
+    // Client errors other than timeout/throttling will not succeed on retry
+    _sendRetryable = code < 400 || code >= 500 || code == 408 || code == 429;
+}
+
+// ============================================================================
+// Helper Functions
+// ============================================================================
+
+size_t renderNotificationBody(const char* bodyTemplate, const NotificationEvent& event,
+                              char* out, size_t outSize) {
+    const char* src = (bodyTemplate && bodyTemplate[0] != '\0') ? bodyTemplate : DEFAULT_TEMPLATE;
+    const char* deviceName = configManager.getSystemConfig().deviceName;
+    size_t pos = 0;
+    out[0] = '\0';
+
+    while (*src) {
+        const char* close = nullptr;
+        if (src[0] == '{' && src[1] == '{') {
+            close = strstr(src + 2, "}}");
+        }
+        if (!close) {
+            if (pos + 1 >= outSize) {
+                return 0;
+            }
+            out[pos++] = *src++;
+            out[pos] = '\0';
+            continue;
+        }
+
+        const char* key = src + 2;
+        size_t keyLen = close - key;
+        char number[24];
+
+        auto is = [&](const char* name) {
+            return strlen(name) == keyLen && strncmp(key, name, keyLen) == 0;
+        };
+
+        if (is("event")) {
+            pos = appendJsonEscaped(out, outSize, pos, notificationEventToString(event.type));
+        } else if (is("device")) {
+            pos = appendJsonEscaped(out, outSize, pos, deviceName);
+        } else if (is("sensor")) {
+            pos = appendJsonEscaped(out, outSize, pos, event.name);
+        } else if (is("address")) {
+            pos = appendJsonEscaped(out, outSize, pos, event.address);
+        } else if (is("state")) {
+            pos = appendJsonEscaped(out, outSize, pos, alarmStateToString(event.state));
+        } else if (is("previous")) {
+            pos = appendJsonEscaped(out, outSize, pos, alarmStateToString(event.previous));
+        } else if (is("unit")) {
+            pos = appendJsonEscaped(out, outSize, pos, event.unit);
+        } else if (is("value")) {
+            if (event.value == TEMP_INVALID) {
+                strcpy(number, "null");
+            } else {
+                snprintf(number, sizeof(number), "%.2f", event.value);
+            }
+            pos = appendRaw(out, outSize, pos, number);
+        } else if (is("timestamp")) {
+            snprintf(number, sizeof(number), "%lu", (unsigned long)event.timestamp);
+            pos = appendRaw(out, outSize, pos, number);
+        } else if (is("uptime")) {
+            snprintf(number, sizeof(number), "%lu", (unsigned long)event.uptime);
+            pos = appendRaw(out, outSize, pos, number);
+        } else {
+            // Unknown placeholder: keep it verbatim
+            size_t len = close + 2 - src;
+            if (pos + len >= outSize) {
+                return 0;
+            }
+            memcpy(out + pos, src, len);
+            pos += len;
+            out[pos] = '\0';
+        }
+
+        // Escaping stops at the buffer end, leaving no room for the terminator
+        if (pos + 1 >= outSize) {
+            return 0;
+        }
+        src = close + 2;
+    }
+
+    return pos;
+}
+
+const char* notificationEventToString(NotificationEventType type) {
+    switch (type) {
+        case NotificationEventType::ALARM: return "alarm";
+        case NotificationEventType::CLEAR: return "clear";
+        case NotificationEventType::TEST:  return "test";
+        default:                           return "unknown";
+    }
+}
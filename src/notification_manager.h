@@ -0,0 +1,197 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Webhook Notification Manager Header
+ *
+ * Delivers alarm events to HTTP endpoints (Slack/Teams/ntfy/custom):
+ * - Alarm transitions are queued in O(1) and never block the alarm path
+ * - Request bodies are rendered from per-endpoint JSON templates
+ * - POSTs run in a background task, one at a time
+ * - Failed deliveries are retried with exponential backoff; when the
+ *   bounded queue is full the oldest delivery is dropped
+ * - Per-endpoint rate limiting and delivery metrics
+ *
+ * Template placeholders (string values are JSON-escaped):
+ *   {{event}} {{device}} {{sensor}} {{address}} {{state}} {{previous}}
+ *   {{value}} {{unit}} {{timestamp}} {{uptime}}
+ */
+
+#ifndef NOTIFICATION_MANAGER_H
+#define NOTIFICATION_MANAGER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+/**
+ * Kind of notification event
+ */
+enum class NotificationEventType : uint8_t {
+    ALARM,          // Sensor entered an alarm or error state
+    CLEAR,          // Sensor returned to normal
+    TEST            // Manually triggered from the web UI
+};
+
+/**
+ * Snapshot of an alarm transition, taken when it is queued
+ */
+struct NotificationEvent {
+    NotificationEventType type;
+    AlarmState state;
+    AlarmState previous;
+    float value;                        // TEMP_INVALID if unavailable
+    uint32_t timestamp;                 // Unix time, 0 if clock not synchronised
+    uint32_t uptime;                    // Seconds since boot
+    char address[SENSOR_ADDR_STR_LEN];
+    char name[SENSOR_NAME_MAX_LEN];
+    char unit[8];
+};
+
+/**
+ * Delivery metrics of one endpoint
+ */
+struct WebhookStats {
+    uint32_t delivered;                 // Successful POSTs
+    uint32_t failed;                    // Deliveries given up
+    uint32_t retries;                   // Attempts after the first
+    int lastStatus;                     // HTTP status (or negative HTTPClient error)
+    uint32_t lastLatencyMs;             // Duration of the last POST
+};
+
+// ============================================================================
+// NotificationManager Class
+// ============================================================================
+
+class NotificationManager {
+public:
+    /**
+     * Constructor
+     */
+    NotificationManager();
+
+    /**
+     * Update manager (call in main loop)
+     * Collects finished sends and starts the next due delivery
+     */
+    void update();
+
+    /**
+     * Queue an alarm transition for all subscribed endpoints
+     * Called from the sensor alarm callback; only copies the event
+     */
+    void notifyAlarm(uint8_t sensorIndex, AlarmState oldState, AlarmState newState, float value);
+
+    /**
+     * Queue a test event for one endpoint (ignores its event mask)
+     * Safe to call from async web handlers
+     * @return false if the slot is invalid
+     */
+    bool requestTest(uint8_t slot);
+
+    /**
+     * Drop deliveries of disabled endpoints and retry the rest now
+     * Safe to call from async web handlers
+     */
+    void reconfigure() { _reconfigureRequested = true; }
+
+    /**
+     * Get delivery metrics of an endpoint
+     * @return nullptr if slot invalid
+     */
+    const WebhookStats* getStats(uint8_t slot) const;
+
+    /**
+     * Get number of deliveries waiting in the queue
+     */
+    uint8_t getQueuedCount() const;
+
+    /**
+     * Get number of deliveries dropped because the queue was full
+     */
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+    /**
+     * Sum of successful POSTs over all endpoints
+     */
+    uint32_t getDeliveredCount() const;
+
+    /**
+     * Sum of deliveries given up over all endpoints
+     */
+    uint32_t getFailedCount() const;
+
+private:
+    struct Delivery {
+        bool used;
+        uint8_t slot;                   // Endpoint
+        uint8_t attempts;
+        uint32_t sequence;              // Queue order, lowest is oldest
+        uint32_t nextAttemptMs;
+        NotificationEvent event;
+    };
+
+    Delivery _queue[NOTIFY_QUEUE_SIZE];
+    uint32_t _nextSequence;
+    int8_t _inFlight;                   // Queue index owned by the send task, -1 if none
+
+    WebhookStats _stats[MAX_WEBHOOKS];
+    uint32_t _lastSendMs[MAX_WEBHOOKS];
+    bool _hasSent[MAX_WEBHOOKS];
+    uint32_t _droppedCount;
+
+    // Sensors with an announced error, so reconnecting at boot is not a "clear"
+    uint32_t _errorAnnounced;
+
+    TaskHandle_t _task;
+    volatile bool _sending;
+    volatile bool _sendOk;
+    volatile bool _sendRetryable;
+    volatile int _lastStatus;
+    volatile uint32_t _lastLatencyMs;
+
+    uint32_t _testRequests;             // Bitmask of slots, set by web handlers (atomic access only)
+    volatile bool _reconfigureRequested;
+
+    /**
+     * Add a delivery, dropping the oldest one when the queue is full
+     */
+    void enqueue(uint8_t slot, const NotificationEvent& event);
+
+    /**
+     * Pick the oldest delivery that is due and not rate limited
+     * @return queue index or -1
+     */
+    int8_t nextDue(uint32_t now);
+
+    /**
+     * Render the body and start the send task for a delivery
+     */
+    void startSend(int8_t index);
+
+    /**
+     * Handle the outcome of a finished send task
+     */
+    void completeSend();
+
+    static void sendThunk(void* arg);
+    void runSendTask(const WebhookConfig& config, const char* body);
+};
+
+/**
+ * Render an endpoint template (or the default body) for an event
+ * @return body length, 0 if it did not fit
+ */
+size_t renderNotificationBody(const char* bodyTemplate, const NotificationEvent& event,
+                              char* out, size_t outSize);
+
+/**
+ * Get notification event type as string
+ */
+const char* notificationEventToString(NotificationEventType type);
+
+// Global notification manager instance
+extern NotificationManager notificationManager;
+
+#endif // NOTIFICATION_MANAGER_H
@@ -0,0 +1,738 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * OneWire Bus Implementation
+ */
+
+#include "onewire_bus.h"
+
+// ROM commands
+constexpr uint8_t CMD_SEARCH_ROM = 0xF0;
+constexpr uint8_t CMD_ALARM_SEARCH = 0xEC;
+constexpr uint8_t CMD_MATCH_ROM = 0x55;
+constexpr uint8_t CMD_SKIP_ROM = 0xCC;
+
+// DS18x20 function commands
+constexpr uint8_t CMD_CONVERT_T = 0x44;
+constexpr uint8_t CMD_WRITE_SCRATCHPAD = 0x4E;
+constexpr uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+constexpr uint8_t CMD_COPY_SCRATCHPAD = 0x48;
+constexpr uint8_t CMD_READ_POWER_SUPPLY = 0xB4;
+
+// Scratchpad to EEPROM copy time (ms)
+constexpr uint16_t EEPROM_COPY_MS = 10;
+
+// ============================================================================
+// OneWireBus
+// ============================================================================
+
+bool OneWireBus::search(OneWireSearch& state, DeviceAddress addr, bool alarmOnly) {
+    if (state.lastDevice || state.aborted) {
+        return false;
+    }
+    
+    // Once a device has been found more are expected, so losing the bus
+    // then is an error rather than the end of the enumeration
+    bool enumerating = state.lastDiscrepancy >= 0;
+    
+    if (!reset()) {
+        state = OneWireSearch();
+        state.aborted = enumerating;
+        return false;
+    }
+    
+    uint8_t cmd = alarmOnly ? CMD_ALARM_SEARCH : CMD_SEARCH_ROM;
+    write(&cmd, 1);
+    
+    // Each ROM bit: all devices send it and its complement, then the
+    // master picks the branch to follow (Maxim AN187)
+    int8_t lastZero = -1;
+    for (uint8_t bit = 0; bit < 64; bit++) {
+        bool idBit = readBit();
+        bool cmpBit = readBit();
+        if (idBit && cmpBit) {
+            // Nobody answered: no alarmed devices is a normal end, but the
+            // devices that sent a presence pulse must answer a ROM search
+            state = OneWireSearch();
+            state.aborted = enumerating || !alarmOnly || bit > 0;
+            return false;
+        }
+        
+        bool direction;
+        if (idBit != cmpBit) {
+            direction = idBit;
+        } else if (bit < state.lastDiscrepancy) {
+            direction = (state.rom[bit / 8] >> (bit % 8)) & 0x01;
+        } else {
+            direction = bit == state.lastDiscrepancy;
+        }
+        if (idBit == cmpBit && !direction) {
+            lastZero = bit;
+        }
+        
+        if (direction) {
+            state.rom[bit / 8] |= 1 << (bit % 8);
+        } else {
+            state.rom[bit / 8] &= ~(1 << (bit % 8));
+        }
+        writeBit(direction);
+    }
+    
+    if (crc8(state.rom, 7) != state.rom[7]) {
+        state = OneWireSearch();
+        state.aborted = true;
+        return false;
+    }
+    
+    state.lastDiscrepancy = lastZero;
+    state.lastDevice = lastZero < 0;
+    memcpy(addr, state.rom, sizeof(DeviceAddress));
+    return true;
+}
+
+bool OneWireBus::select(const DeviceAddress addr) {
+    if (!reset()) {
+        return false;
+    }
+    
+    uint8_t cmd[1 + sizeof(DeviceAddress)];
+    cmd[0] = CMD_MATCH_ROM;
+    memcpy(cmd + 1, addr, sizeof(DeviceAddress));
+    write(cmd, sizeof(cmd));
+    return true;
+}
+
+void OneWireBus::startConversion(bool parasite) {
+    reset();
+    uint8_t cmd[] = {CMD_SKIP_ROM, CMD_CONVERT_T};
+    write(cmd, sizeof(cmd), parasite);
+}
+
+bool OneWireBus::readScratchpad(const DeviceAddress addr, uint8_t* scratchpad) {
+    if (!select(addr)) {
+        return false;
+    }
+    
+    uint8_t cmd = CMD_READ_SCRATCHPAD;
+    write(&cmd, 1);
+    read(scratchpad, 9);
+    return true;
+}
+
+bool OneWireBus::writeScratchpad(const DeviceAddress addr, int8_t high, int8_t low, uint8_t config,
+                                 bool parasite) {
+    if (!select(addr)) {
+        return false;
+    }
+    
+    uint8_t cmd[] = {CMD_WRITE_SCRATCHPAD, (uint8_t)high, (uint8_t)low, config};
+    write(cmd, addr[0] == FAMILY_DS18S20 ? 3 : 4);
+    
+    // Persist, so the values survive a power cycle of the sensor
+    if (!select(addr)) {
+        return false;
+    }
+    uint8_t copy = CMD_COPY_SCRATCHPAD;
+    write(&copy, 1, parasite);
+    delay(EEPROM_COPY_MS);
+    return true;
+}
+
+bool OneWireBus::setResolution(const DeviceAddress addr, uint8_t bits, bool parasite) {
+    if (addr[0] == FAMILY_DS18S20) {
+        return true;
+    }
+    
+    uint8_t scratchpad[9];
+    if (!readScratchpad(addr, scratchpad) || crc8(scratchpad, 8) != scratchpad[8]) {
+        return false;
+    }
+    
+    if (bits < 9) {
+        bits = 9;
+    } else if (bits > 12) {
+        bits = 12;
+    }
+    uint8_t config = ((bits - 9) << 5) | 0x1F;
+    if (scratchpad[4] == config) {
+        return true;
+    }
+    return writeScratchpad(addr, (int8_t)scratchpad[2], (int8_t)scratchpad[3], config, parasite);
+}
+
+bool OneWireBus::isParasitePowered() {
+    if (!reset()) {
+        return false;
+    }
+    
+    // Parasite-powered devices pull the line low
+    uint8_t cmd[] = {CMD_SKIP_ROM, CMD_READ_POWER_SUPPLY};
+    write(cmd, sizeof(cmd));
+    return !readBit();
+}
+
+uint8_t OneWireBus::crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        uint8_t in = *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            uint8_t mix = (crc ^ in) & 0x01;
+            crc >>= 1;
+            if (mix) {
+                crc ^= 0x8C;
+            }
+            in >>= 1;
+        }
+    }
+    return crc;
+}
+
+// ============================================================================
+// GpioOneWireBus
+// ============================================================================
+
+GpioOneWireBus::GpioOneWireBus(uint8_t pin) :
+    _pin(pin),
+    _wire(pin) {
+}
+
+bool GpioOneWireBus::begin() {
+    _wire.begin(_pin);
+    return true;
+}
+
+bool GpioOneWireBus::reset() {
+    return _wire.reset() == 1;
+}
+
+void GpioOneWireBus::write(const uint8_t* data, uint8_t len, bool power) {
+    _wire.write_bytes(data, len, power);
+}
+
+void GpioOneWireBus::read(uint8_t* data, uint8_t len) {
+    _wire.read_bytes(data, len);
+}
+
+bool GpioOneWireBus::readBit() {
+    return _wire.read_bit() != 0;
+}
+
+void GpioOneWireBus::writeBit(bool bit) {
+    _wire.write_bit(bit ? 1 : 0);
+}
+
+// ============================================================================
+// RmtOneWireBus
+// ============================================================================
+
+// Standard-speed slot timing in µs (Maxim AN126), RMT clocked at 1 MHz
+constexpr uint8_t RMT_CLOCK_DIV = 80;
+constexpr uint16_t RMT_RESET_LOW_US = 480;
+constexpr uint16_t RMT_RESET_HIGH_US = 480;     // Presence pulse and recovery
+constexpr uint16_t RMT_WRITE_1_LOW_US = 6;
+constexpr uint16_t RMT_WRITE_1_HIGH_US = 64;
+constexpr uint16_t RMT_WRITE_0_LOW_US = 60;
+constexpr uint16_t RMT_WRITE_0_HIGH_US = 10;
+constexpr uint16_t RMT_READ_SAMPLE_US = 15;     // Low longer than this reads as 0
+
+// RX ends a frame after the line has been high this long (longer than
+// any high phase inside a slot sequence)
+constexpr uint16_t RMT_RX_IDLE_US = 80;
+
+// Ignore glitches shorter than this many APB ticks (80 MHz)
+constexpr uint8_t RMT_RX_FILTER_TICKS = 100;
+
+// Slots per RMT transaction (RX channel memory: two 64-item blocks)
+constexpr uint8_t RMT_MAX_SLOTS = 64;
+
+constexpr size_t RMT_RX_RING_SIZE = 1024;
+constexpr uint32_t RMT_RX_TIMEOUT_MS = 20;
+
+static rmt_item32_t rmtItem(uint16_t lowUs, uint16_t highUs) {
+    rmt_item32_t item;
+    item.level0 = 0;
+    item.duration0 = lowUs;
+    item.level1 = 1;
+    item.duration1 = highUs;
+    return item;
+}
+
+static rmt_item32_t rmtWriteSlot(bool bit) {
+    return bit ? rmtItem(RMT_WRITE_1_LOW_US, RMT_WRITE_1_HIGH_US)
+               : rmtItem(RMT_WRITE_0_LOW_US, RMT_WRITE_0_HIGH_US);
+}
+
+RmtOneWireBus::RmtOneWireBus(uint8_t pin, uint8_t txChannel, uint8_t rxChannel) :
+    _pin((gpio_num_t)pin),
+    _txChannel((rmt_channel_t)txChannel),
+    _rxChannel((rmt_channel_t)rxChannel),
+    _rxRing(nullptr),
+    _installed(false) {
+}
+
+bool RmtOneWireBus::begin() {
+    if (_installed) {
+        return true;
+    }
+    
+    rmt_config_t tx = {};
+    tx.rmt_mode = RMT_MODE_TX;
+    tx.channel = _txChannel;
+    tx.gpio_num = _pin;
+    tx.clk_div = RMT_CLOCK_DIV;
+    tx.mem_block_num = 1;
+    tx.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+    tx.tx_config.idle_output_en = true;
+    
+    if (rmt_config(&tx) != ESP_OK || rmt_driver_install(_txChannel, 0, 0) != ESP_OK) {
+        Serial.println(F("[OneWire] RMT TX channel setup failed"));
+        return false;
+    }
+    
+    rmt_config_t rx = {};
+    rx.rmt_mode = RMT_MODE_RX;
+    rx.channel = _rxChannel;
+    rx.gpio_num = _pin;
+    rx.clk_div = RMT_CLOCK_DIV;
+    rx.mem_block_num = 2;
+    rx.rx_config.filter_en = true;
+    rx.rx_config.filter_ticks_thresh = RMT_RX_FILTER_TICKS;
+    rx.rx_config.idle_threshold = RMT_RX_IDLE_US;
+    
+    if (rmt_config(&rx) != ESP_OK || rmt_driver_install(_rxChannel, RMT_RX_RING_SIZE, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(_rxChannel, &_rxRing) != ESP_OK) {
+        Serial.println(F("[OneWire] RMT RX channel setup failed"));
+        rmt_driver_uninstall(_txChannel);
+        return false;
+    }
+    
+    // Both channels share one open-drain pin. Route RX first: routing the
+    // TX output makes the pin output-only, so input and open drain are
+    // enabled again afterwards.
+    rmt_set_gpio(_rxChannel, RMT_MODE_RX, _pin, false);
+    rmt_set_gpio(_txChannel, RMT_MODE_TX, _pin, false);
+    PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[_pin]);
+    GPIO.pin[_pin].pad_driver = 1;
+    
+    _installed = true;
+    Serial.printf("[OneWire] RMT bus on GPIO%d (TX ch %d, RX ch %d)\n", _pin, _txChannel, _rxChannel);
+    return true;
+}
+
+void RmtOneWireBus::end() {
+    if (!_installed) {
+        return;
+    }
+    
+    rmt_driver_uninstall(_rxChannel);
+    rmt_driver_uninstall(_txChannel);
+    gpio_reset_pin(_pin);
+    _rxRing = nullptr;
+    _installed = false;
+}
+
+void RmtOneWireBus::transmit(const rmt_item32_t* items, uint16_t count) {
+    // Blocks this task (not the CPU) until the RMT interrupt reports the
+    // last item sent
+    rmt_write_items(_txChannel, items, count, true);
+}
+
+bool RmtOneWireBus::reset() {
+    if (!_installed) {
+        return false;
+    }
+    
+    rmt_item32_t item = rmtItem(RMT_RESET_LOW_US, RMT_RESET_HIGH_US);
+    
+    rmt_rx_start(_rxChannel, true);
+    transmit(&item, 1);
+    
+    size_t size = 0;
+    rmt_item32_t* rx = (rmt_item32_t*)xRingbufferReceive(_rxRing, &size, pdMS_TO_TICKS(RMT_RX_TIMEOUT_MS));
+    rmt_rx_stop(_rxChannel);
+    if (!rx) {
+        return false;
+    }
+    
+    // Our reset pulse is the first low phase; a presence pulse is a second
+    size_t count = size / sizeof(rmt_item32_t);
+    bool present = count >= 2 && rx[1].level0 == 0 && rx[1].duration0 > 0;
+    vRingbufferReturnItem(_rxRing, rx);
+    return present;
+}
+
+void RmtOneWireBus::write(const uint8_t* data, uint8_t len, bool power) {
+    // Open drain cannot drive the line high: parasite power is left to
+    // the GPIO backend
+    (void)power;
+    if (!_installed) {
+        return;
+    }
+    
+    rmt_item32_t items[RMT_MAX_SLOTS];
+    uint16_t count = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            items[count++] = rmtWriteSlot((data[i] >> bit) & 0x01);
+        }
+        if (count == RMT_MAX_SLOTS || i == len - 1) {
+            transmit(items, count);
+            count = 0;
+        }
+    }
+}
+
+bool RmtOneWireBus::readSlots(uint8_t* data, uint8_t count) {
+    rmt_item32_t items[RMT_MAX_SLOTS];
+    for (uint8_t i = 0; i < count; i++) {
+        items[i] = rmtWriteSlot(true);
+    }
+    memset(data, 0, (count + 7) / 8);
+    
+    rmt_rx_start(_rxChannel, true);
+    transmit(items, count);
+    
+    size_t size = 0;
+    rmt_item32_t* rx = (rmt_item32_t*)xRingbufferReceive(_rxRing, &size, pdMS_TO_TICKS(RMT_RX_TIMEOUT_MS));
+    rmt_rx_stop(_rxChannel);
+    if (!rx) {
+        memset(data, 0xFF, (count + 7) / 8);
+        return false;
+    }
+    
+    // A device sends 0 by holding the line low past the sample point
+    size_t received = size / sizeof(rmt_item32_t);
+    for (uint8_t i = 0; i < count; i++) {
+        bool zero = i < received && rx[i].level0 == 0 && rx[i].duration0 > RMT_READ_SAMPLE_US;
+        if (!zero) {
+            data[i / 8] |= 1 << (i % 8);
+        }
+    }
+    vRingbufferReturnItem(_rxRing, rx);
+    return true;
+}
+
+void RmtOneWireBus::read(uint8_t* data, uint8_t len) {
+    if (!_installed) {
+        memset(data, 0xFF, len);
+        return;
+    }
+    
+    constexpr uint8_t bytesPerFrame = RMT_MAX_SLOTS / 8;
+    for (uint8_t offset = 0; offset < len; offset += bytesPerFrame) {
+        uint8_t chunk = len - offset < bytesPerFrame ? len - offset : bytesPerFrame;
+        readSlots(data + offset, chunk * 8);
+    }
+}
+
+bool RmtOneWireBus::readBit() {
+    if (!_installed) {
+        return true;
+    }
+    
+    uint8_t bit;
+    readSlots(&bit, 1);
+    return bit & 0x01;
+}
+
+void RmtOneWireBus::writeBit(bool bit) {
+    if (!_installed) {
+        return;
+    }
+    
+    rmt_item32_t item = rmtWriteSlot(bit);
+    transmit(&item, 1);
+}
+
+// ============================================================================
+// SimulatedOneWireBus
+// ============================================================================
+
+static_assert(SIMULATED_SENSOR_COUNT <= 8, "one selection bit per simulated device");
+
+// Serial number bytes 1-2 of simulated devices; 3-5 are the station MAC
+constexpr uint8_t SIMULATED_ROM_TAG_0 = 'S';
+constexpr uint8_t SIMULATED_ROM_TAG_1 = 'I';
+
+// Period of the simulated temperature swing
+constexpr uint32_t SIMULATED_PERIOD_MS = 10 * 60 * 1000;
+
+// Power-on TH/TL and configuration (12 bits)
+constexpr int8_t DS18X20_DEFAULT_TH = 75;
+constexpr int8_t DS18X20_DEFAULT_TL = 70;
+constexpr uint8_t DS18X20_DEFAULT_CONFIG = 0x7F;
+
+/**
+ * Simulated device types, cycled through by device number; the DS1822
+ * sits below zero so negative registers are exercised too
+ */
+struct SimulatedDeviceType {
+    uint8_t family;
+    float base;                         // Mean temperature
+};
+
+static const SimulatedDeviceType SIMULATED_DEVICE_TYPES[] = {
+    {FAMILY_DS18B20, 21.0f},
+    {FAMILY_DS18S20, 4.0f},
+    {FAMILY_DS1822, -8.0f}
+};
+constexpr uint8_t SIMULATED_DEVICE_TYPE_COUNT =
+    sizeof(SIMULATED_DEVICE_TYPES) / sizeof(SIMULATED_DEVICE_TYPES[0]);
+
+SimulatedOneWireBus::SimulatedOneWireBus() :
+    _state(State::IDLE),
+    _selected(0),
+    _position(0),
+    _searchSlot(0),
+    _searchAbortBit(0),
+    _conversionStart(0),
+    _corrupt(false) {
+    memset(_match, 0, sizeof(_match));
+    memset(_devices, 0, sizeof(_devices));
+}
+
+bool SimulatedOneWireBus::begin() {
+    // Station MAC in the serial number keeps ROM codes unique across stations
+    uint64_t mac = ESP.getEfuseMac();
+    
+    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+        const SimulatedDeviceType& type = SIMULATED_DEVICE_TYPES[i % SIMULATED_DEVICE_TYPE_COUNT];
+        Device& device = _devices[i];
+        
+        device.rom[0] = type.family;
+        device.rom[1] = SIMULATED_ROM_TAG_0;
+        device.rom[2] = SIMULATED_ROM_TAG_1;
+        device.rom[3] = (uint8_t)(mac >> 24);
+        device.rom[4] = (uint8_t)(mac >> 32);
+        device.rom[5] = (uint8_t)(mac >> 40);
+        device.rom[6] = i;
+        device.rom[7] = crc8(device.rom, 7);
+        device.base = type.base;
+        
+        // Power-on scratchpad: 85 °C, EEPROM TH/TL
+        uint8_t* pad = device.scratchpad;
+        if (type.family == FAMILY_DS18S20) {
+            pad[0] = 0xAA;
+            pad[1] = 0x00;
+            pad[4] = 0xFF;
+            pad[6] = 0x0C;
+        } else {
+            pad[0] = 0x50;
+            pad[1] = 0x05;
+            pad[4] = DS18X20_DEFAULT_CONFIG;
+            pad[6] = 0x00;
+        }
+        pad[2] = (uint8_t)DS18X20_DEFAULT_TH;
+        pad[3] = (uint8_t)DS18X20_DEFAULT_TL;
+        pad[5] = 0xFF;
+        pad[7] = 0x10;
+        pad[8] = crc8(pad, 8);
+    }
+    return true;
+}
+
+bool SimulatedOneWireBus::isSimulated(const DeviceAddress addr) {
+    return addr[1] == SIMULATED_ROM_TAG_0 && addr[2] == SIMULATED_ROM_TAG_1;
+}
+
+bool SimulatedOneWireBus::reset() {
+    _state = State::ROM_COMMAND;
+    _selected = 0;
+    _position = 0;
+    
+    // Injected errors exercise CRC checks, retries and search restarts; at
+    // random, since transactions come in fixed patterns (search, then
+    // setResolution) that a fixed interval would always hit the same way
+    _corrupt = random(SIMULATED_ERROR_EVERY) == 0;
+    _searchAbortBit = (uint8_t)random(64);
+    
+    return SIMULATED_SENSOR_COUNT > 0;
+}
+
+void SimulatedOneWireBus::write(const uint8_t* data, uint8_t len, bool power) {
+    for (uint8_t n = 0; n < len; n++) {
+        uint8_t b = data[n];
+        
+        switch (_state) {
+            case State::ROM_COMMAND:
+                if (b == CMD_SKIP_ROM) {
+                    _selected = (1 << SIMULATED_SENSOR_COUNT) - 1;
+                    _state = State::FUNCTION_COMMAND;
+                } else if (b == CMD_MATCH_ROM) {
+                    _position = 0;
+                    _state = State::MATCH_ROM;
+                } else if (b == CMD_SEARCH_ROM || b == CMD_ALARM_SEARCH) {
+                    _selected = 0;
+                    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+                        if (b == CMD_SEARCH_ROM || isAlarmed(_devices[i])) {
+                            _selected |= 1 << i;
+                        }
+                    }
+                    _position = 0;
+                    _searchSlot = 0;
+                    _state = State::SEARCH;
+                } else {
+                    _state = State::IDLE;
+                }
+                break;
+                
+            case State::MATCH_ROM:
+                _match[_position++] = b;
+                if (_position == sizeof(DeviceAddress)) {
+                    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+                        if (memcmp(_devices[i].rom, _match, sizeof(DeviceAddress)) == 0) {
+                            _selected = 1 << i;
+                        }
+                    }
+                    _state = State::FUNCTION_COMMAND;
+                }
+                break;
+                
+            case State::FUNCTION_COMMAND:
+                _position = 0;
+                if (b == CMD_CONVERT_T) {
+                    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+                        if (_selected & (1 << i)) {
+                            convert(_devices[i]);
+                        }
+                    }
+                    _conversionStart = millis();
+                    _state = State::CONVERTING;
+                } else if (b == CMD_READ_SCRATCHPAD) {
+                    _state = State::READ_SCRATCHPAD;
+                } else if (b == CMD_WRITE_SCRATCHPAD) {
+                    _state = State::WRITE_SCRATCHPAD;
+                } else if (b == CMD_READ_POWER_SUPPLY) {
+                    _state = State::READ_POWER_SUPPLY;
+                } else {
+                    // Copy Scratchpad: TH/TL/config are kept as written
+                    _state = State::IDLE;
+                }
+                break;
+                
+            case State::WRITE_SCRATCHPAD:
+                // TH, TL, then configuration (not on the DS18S20)
+                for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+                    Device& device = _devices[i];
+                    if (!(_selected & (1 << i)) ||
+                        (_position == 2 && device.rom[0] == FAMILY_DS18S20)) {
+                        continue;
+                    }
+                    device.scratchpad[2 + _position] = b;
+                    device.scratchpad[8] = crc8(device.scratchpad, 8);
+                }
+                if (++_position == 3) {
+                    _state = State::IDLE;
+                }
+                break;
+                
+            default:
+                break;
+        }
+    }
+}
+
+void SimulatedOneWireBus::read(uint8_t* data, uint8_t len) {
+    int8_t device = -1;
+    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT && device < 0; i++) {
+        if (_selected == (1 << i)) {
+            device = i;
+        }
+    }
+    
+    for (uint8_t n = 0; n < len; n++) {
+        // Nobody driving the line reads as ones
+        data[n] = 0xFF;
+        if (_state == State::READ_SCRATCHPAD && device >= 0 && _position < 9) {
+            data[n] = _devices[device].scratchpad[_position++];
+            if (_corrupt && _position == 1) {
+                data[n] ^= 0x04;
+            }
+        }
+    }
+}
+
+bool SimulatedOneWireBus::searchBit(bool complement) const {
+    bool line = true;
+    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+        if (_selected & (1 << i)) {
+            bool bit = (_devices[i].rom[_position / 8] >> (_position % 8)) & 0x01;
+            line &= complement ? !bit : bit;
+        }
+    }
+    return line;
+}
+
+bool SimulatedOneWireBus::readBit() {
+    switch (_state) {
+        case State::SEARCH: {
+            // A corrupted search loses every device part way through
+            if (_corrupt && _position >= _searchAbortBit) {
+                _selected = 0;
+            }
+            bool bit = searchBit(_searchSlot == 1);
+            _searchSlot++;
+            return bit;
+        }
+            
+        case State::CONVERTING:
+            return millis() - _conversionStart >= SIMULATED_CONVERSION_MS;
+            
+        case State::READ_POWER_SUPPLY:
+            return true;        // Externally powered
+            
+        default:
+            return true;
+    }
+}
+
+void SimulatedOneWireBus::writeBit(bool bit) {
+    if (_state != State::SEARCH || _searchSlot != 2) {
+        return;
+    }
+    
+    // Devices whose ROM bit differs from the master's choice drop out
+    for (uint8_t i = 0; i < SIMULATED_SENSOR_COUNT; i++) {
+        bool romBit = (_devices[i].rom[_position / 8] >> (_position % 8)) & 0x01;
+        if (romBit != bit) {
+            _selected &= ~(1 << i);
+        }
+    }
+    
+    _searchSlot = 0;
+    if (++_position == 64) {
+        _state = State::IDLE;
+    }
+}
+
+void SimulatedOneWireBus::convert(Device& device) {
+    // Slow swing of ±2 °C, phase-shifted per device
+    uint8_t index = (uint8_t)(&device - _devices);
+    float phase = (float)(millis() % SIMULATED_PERIOD_MS) / SIMULATED_PERIOD_MS + index * 0.25f;
+    float value = device.base + 2.0f * sinf(2.0f * (float)M_PI * phase);
+    uint8_t* pad = device.scratchpad;
+    
+    if (device.rom[0] == FAMILY_DS18S20) {
+        // 0.5 °C register; COUNT_REMAIN carries the 1/16 °C remainder
+        int16_t steps = (int16_t)lroundf((value + 0.25f) * 16.0f);
+        int16_t whole = (int16_t)floorf(steps / 16.0f);
+        int16_t raw = (int16_t)(whole * 2 + ((steps - whole * 16) >= 8 ? 1 : 0));
+        pad[0] = (uint8_t)raw;
+        pad[1] = (uint8_t)(raw >> 8);
+        pad[6] = (uint8_t)(16 - (steps - whole * 16));
+    } else {
+        // Undefined low bits are zero below 12 bits of resolution
+        uint8_t bits = 9 + ((pad[4] >> 5) & 0x03);
+        int16_t raw = (int16_t)lroundf(value * 16.0f);
+        raw &= ~((1 << (12 - bits)) - 1);
+        pad[0] = (uint8_t)raw;
+        pad[1] = (uint8_t)(raw >> 8);
+    }
+    pad[8] = crc8(pad, 8);
+}
+
+bool SimulatedOneWireBus::isAlarmed(const Device& device) const {
+    // Compared with the integer part of the last reading, like the DS18B20
+    int16_t raw = (int16_t)((device.scratchpad[1] << 8) | device.scratchpad[0]);
+    int16_t whole = device.rom[0] == FAMILY_DS18S20 ? (raw >> 1) : (raw >> 4);
+    return whole >= (int8_t)device.scratchpad[2] || whole <= (int8_t)device.scratchpad[3];
+}
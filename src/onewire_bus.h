@@ -0,0 +1,285 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * OneWire Bus Header
+ *
+ * Transaction-level access to the 1-Wire bus, with swappable backends:
+ * - GpioOneWireBus: OneWire library, bit-banged with interrupts disabled
+ *   for each time slot
+ * - RmtOneWireBus: RMT peripheral; a whole transaction (reset, bytes or
+ *   read slots) is queued as RMT items and the calling task blocks until
+ *   the RMT interrupt reports it complete, so WiFi and AsyncTCP keep
+ *   running during bus traffic
+ * - SimulatedOneWireBus: DS18x20 devices without hardware
+ *   (SIMULATE_SENSORS), answering the same time slots and bytes
+ *
+ * ROM search and the DS18x20 function commands are built on the backend
+ * primitives, so all backends behave the same.
+ */
+
+#ifndef ONEWIRE_BUS_H
+#define ONEWIRE_BUS_H
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include <driver/rmt.h>
+#include "config.h"
+
+// 64-bit ROM code: family, 48-bit serial, CRC
+typedef uint8_t DeviceAddress[8];
+
+// Temperature sensor family codes
+constexpr uint8_t FAMILY_DS18B20 = 0x28;
+constexpr uint8_t FAMILY_DS1822 = 0x22;
+constexpr uint8_t FAMILY_DS18S20 = 0x10;         // Fixed resolution, no configuration register
+
+/**
+ * ROM search position, so several searches (discovery, Alarm Search) can
+ * be in progress at the same time
+ */
+struct OneWireSearch {
+    DeviceAddress rom;
+    int8_t lastDiscrepancy;
+    bool lastDevice;
+    bool aborted;                       // Ended by a bus error, not by the last device
+    
+    OneWireSearch() : lastDiscrepancy(-1), lastDevice(false), aborted(false) {
+        memset(rom, 0, sizeof(rom));
+    }
+};
+
+// ============================================================================
+// OneWireBus Class
+// ============================================================================
+
+class OneWireBus {
+public:
+    virtual ~OneWireBus() {}
+    
+    /**
+     * Prepare the pin (and peripheral)
+     * @return true if the backend is usable
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * Release the pin (and peripheral)
+     */
+    virtual void end() {}
+    
+    /**
+     * Backend name ("gpio", "rmt", "simulated")
+     */
+    virtual const char* getName() const = 0;
+    
+    /**
+     * Reset pulse
+     * @return true if at least one device answered with a presence pulse
+     */
+    virtual bool reset() = 0;
+    
+    /**
+     * Write bytes, LSB first
+     * @param power Keep the line driven high afterwards (parasite power)
+     */
+    virtual void write(const uint8_t* data, uint8_t len, bool power = false) = 0;
+    
+    /**
+     * Read bytes, LSB first
+     */
+    virtual void read(uint8_t* data, uint8_t len) = 0;
+    
+    /**
+     * Single time slots (ROM search)
+     */
+    virtual bool readBit() = 0;
+    virtual void writeBit(bool bit) = 0;
+    
+    /**
+     * Find the next device
+     * @param alarmOnly Alarm Search: only devices whose alarm flag is set
+     * @return false when no (more) devices were found
+     */
+    bool search(OneWireSearch& state, DeviceAddress addr, bool alarmOnly = false);
+    
+    // ========================================================================
+    // DS18x20 function commands
+    // ========================================================================
+    
+    /**
+     * Start a temperature conversion on all devices (Skip ROM)
+     * @param parasite Hold the line high for parasite-powered devices
+     */
+    void startConversion(bool parasite);
+    
+    /**
+     * Read a device's 9-byte scratchpad (CRC not checked)
+     * @return false if no device answered the reset
+     */
+    bool readScratchpad(const DeviceAddress addr, uint8_t* scratchpad);
+    
+    /**
+     * Write TH, TL and configuration and copy them to the device's EEPROM
+     * @return false if no device answered the reset
+     */
+    bool writeScratchpad(const DeviceAddress addr, int8_t high, int8_t low, uint8_t config,
+                         bool parasite);
+    
+    /**
+     * Set conversion resolution (9-12 bits), keeping TH/TL
+     * Writes only if the resolution differs (EEPROM wear).
+     */
+    bool setResolution(const DeviceAddress addr, uint8_t bits, bool parasite);
+    
+    /**
+     * Check if any device on the bus is parasite powered (Read Power Supply)
+     */
+    bool isParasitePowered();
+    
+    /**
+     * Dallas/Maxim CRC-8 (ROM codes, scratchpads)
+     */
+    static uint8_t crc8(const uint8_t* data, uint8_t len);
+    
+protected:
+    /**
+     * Reset and address one device (Match ROM)
+     */
+    bool select(const DeviceAddress addr);
+};
+
+// ============================================================================
+// GpioOneWireBus Class
+// ============================================================================
+
+class GpioOneWireBus : public OneWireBus {
+public:
+    explicit GpioOneWireBus(uint8_t pin);
+    
+    bool begin() override;
+    const char* getName() const override { return "gpio"; }
+    bool reset() override;
+    void write(const uint8_t* data, uint8_t len, bool power = false) override;
+    void read(uint8_t* data, uint8_t len) override;
+    bool readBit() override;
+    void writeBit(bool bit) override;
+    
+private:
+    uint8_t _pin;
+    OneWire _wire;
+};
+
+// ============================================================================
+// RmtOneWireBus Class
+// ============================================================================
+
+class RmtOneWireBus : public OneWireBus {
+public:
+    RmtOneWireBus(uint8_t pin, uint8_t txChannel, uint8_t rxChannel);
+    
+    bool begin() override;
+    void end() override;
+    const char* getName() const override { return "rmt"; }
+    bool reset() override;
+    void write(const uint8_t* data, uint8_t len, bool power = false) override;
+    void read(uint8_t* data, uint8_t len) override;
+    bool readBit() override;
+    void writeBit(bool bit) override;
+    
+private:
+    gpio_num_t _pin;
+    rmt_channel_t _txChannel;
+    rmt_channel_t _rxChannel;
+    RingbufHandle_t _rxRing;
+    bool _installed;
+    
+    /**
+     * Send read slots and decode the bits the devices returned
+     * @param count Slots (at most one RX channel's worth)
+     * @return false if nothing was received
+     */
+    bool readSlots(uint8_t* data, uint8_t count);
+    
+    /**
+     * Queue items on the TX channel and wait for them to go out
+     */
+    void transmit(const rmt_item32_t* items, uint16_t count);
+};
+
+// ============================================================================
+// SimulatedOneWireBus Class
+// ============================================================================
+
+/**
+ * SIMULATED_SENSOR_COUNT devices (DS18B20, DS18S20, DS1822 in turn) that
+ * decode the ROM and function commands written to them and answer with
+ * ROM search bits, conversion status and scratchpads, so Ds18x20Driver
+ * and OneWireBus::search run unchanged. About one transaction in every
+ * SIMULATED_ERROR_EVERY is corrupted (flipped scratchpad bit, or the
+ * devices dropping out of a ROM search).
+ */
+class SimulatedOneWireBus : public OneWireBus {
+public:
+    SimulatedOneWireBus();
+    
+    bool begin() override;
+    const char* getName() const override { return "simulated"; }
+    bool reset() override;
+    void write(const uint8_t* data, uint8_t len, bool power = false) override;
+    void read(uint8_t* data, uint8_t len) override;
+    bool readBit() override;
+    void writeBit(bool bit) override;
+    
+    /**
+     * Check if a ROM code belongs to a simulated device
+     */
+    static bool isSimulated(const DeviceAddress addr);
+    
+private:
+    /**
+     * What the devices expect next on the bus
+     */
+    enum class State : uint8_t {
+        IDLE,               // Ignoring the bus until the next reset
+        ROM_COMMAND,
+        MATCH_ROM,          // Collecting the 8 ROM bytes
+        FUNCTION_COMMAND,
+        SEARCH,             // ROM or Alarm Search time slots
+        CONVERTING,         // Read slots return 1 once done
+        READ_SCRATCHPAD,
+        WRITE_SCRATCHPAD,
+        READ_POWER_SUPPLY
+    };
+    
+    struct Device {
+        DeviceAddress rom;
+        uint8_t scratchpad[9];
+        float base;                     // Mean temperature
+    };
+    
+    Device _devices[SIMULATED_SENSOR_COUNT];
+    State _state;
+    uint8_t _selected;                  // Bit per device addressed by the ROM command
+    uint8_t _position;                  // Byte (or search bit) within the current command
+    DeviceAddress _match;
+    uint8_t _searchSlot;                // 0: ROM bit, 1: complement, 2: master's choice
+    uint8_t _searchAbortBit;            // Bit at which a corrupted search loses its devices
+    uint32_t _conversionStart;
+    bool _corrupt;                      // Current transaction gets an injected error
+    
+    /**
+     * Latch a new reading into a device's scratchpad
+     */
+    void convert(Device& device);
+    
+    /**
+     * Check if a device's alarm flag is set (reading beyond TH/TL)
+     */
+    bool isAlarmed(const Device& device) const;
+    
+    /**
+     * Wired-AND of one ROM bit (or its complement) over the searching devices
+     */
+    bool searchBit(bool complement) const;
+};
+
+#endif // ONEWIRE_BUS_H
@@ -0,0 +1,362 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sensor Driver Implementation
+ */
+
+#include "sensor_driver.h"
+
+// ============================================================================
+// SensorDriver
+// ============================================================================
+
+void SensorDriver::readBatch(const DeviceAddress* addrs, uint8_t count,
+                             float* temps, SensorReadResult* results) {
+    for (uint8_t i = 0; i < count; i++) {
+        results[i] = read(addrs[i], temps[i]);
+    }
+}
+
+// ============================================================================
+// Ds18x20Driver
+// ============================================================================
+
+// Worst case at 12 bits; DS18S20 always converts at this speed
+constexpr uint16_t DS18X20_CONVERSION_MS = 750;
+
+Ds18x20Driver::Ds18x20Driver(SimulatedOneWireBus* simulatedBus) :
+    _gpioBus(ONEWIRE_PIN),
+    _rmtBus(ONEWIRE_PIN, ONEWIRE_RMT_TX_CHANNEL, ONEWIRE_RMT_RX_CHANNEL),
+    _simulatedBus(simulatedBus),
+    _bus(&_gpioBus),
+    _parasite(false),
+    _conversionStart(0),
+    _lastPoll(0) {
+}
+
+bool Ds18x20Driver::begin() {
+    if (_simulatedBus) {
+        _bus = _simulatedBus;
+        return _bus->begin();
+    }
+    
+    _bus = &_gpioBus;
+    
+#if ONEWIRE_USE_RMT
+    if (_rmtBus.begin()) {
+        _bus = &_rmtBus;
+    } else {
+        Serial.println(F("[SensorDriver] RMT unavailable, bit-banging the bus"));
+    }
+#endif
+    
+    if (_bus == &_gpioBus) {
+        _gpioBus.begin();
+    }
+    
+    Serial.printf("[SensorDriver] OneWire backend: %s\n", _bus->getName());
+    return true;
+}
+
+void Ds18x20Driver::detectParasitePower() {
+    _parasite = _bus->isParasitePowered();
+    if (!_parasite) {
+        return;
+    }
+    
+    Serial.println(F("[SensorDriver] Parasite-powered sensor detected"));
+    if (_bus != &_gpioBus) {
+        _bus->end();
+        _bus = &_gpioBus;
+        _gpioBus.begin();
+        Serial.println(F("[SensorDriver] Switched to GPIO OneWire backend for parasite power"));
+    }
+}
+
+bool Ds18x20Driver::handles(const DeviceAddress addr) const {
+    if (addr[0] != FAMILY_DS18B20 && addr[0] != FAMILY_DS1822 && addr[0] != FAMILY_DS18S20) {
+        return false;
+    }
+    // Simulated devices share the family codes: each driver keeps to its own bus
+    return SimulatedOneWireBus::isSimulated(addr) == (_simulatedBus != nullptr);
+}
+
+const char* Ds18x20Driver::getType(const DeviceAddress addr) const {
+    switch (addr[0]) {
+        case FAMILY_DS18B20: return "ds18b20";
+        case FAMILY_DS1822:  return "ds1822";
+        case FAMILY_DS18S20: return "ds18s20";
+        default:             return "unknown";
+    }
+}
+
+void Ds18x20Driver::startDiscovery() {
+    _search = OneWireSearch();
+}
+
+bool Ds18x20Driver::discoverNext(DeviceAddress addr) {
+    // Other 1-Wire devices on the bus are skipped
+    while (_bus->search(_search, addr)) {
+        if (handles(addr)) {
+            _bus->setResolution(addr, SENSOR_RESOLUTION, _parasite);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t Ds18x20Driver::startConversion() {
+    _bus->startConversion(_parasite);
+    _conversionStart = millis();
+    _lastPoll = _conversionStart;
+    return DS18X20_CONVERSION_MS;
+}
+
+bool Ds18x20Driver::isConversionReady() {
+    uint32_t now = millis();
+    uint32_t elapsed = now - _conversionStart;
+    if (elapsed >= DS18X20_CONVERSION_MS) {
+        return true;
+    }
+    
+    // Powered probes answer read slots with 0 until all have finished;
+    // parasite-powered ones need the line held high, so they just wait
+    if (_parasite || elapsed < DS18X20_CONVERSION_MS / 2 ||
+        now - _lastPoll < DS18X20_READY_POLL_MS) {
+        return false;
+    }
+    _lastPoll = now;
+    return _bus->readBit();
+}
+
+SensorReadResult Ds18x20Driver::read(const DeviceAddress addr, float& temp) {
+    temp = TEMP_INVALID;
+    
+    uint8_t scratchPad[9];
+    if (!_bus->readScratchpad(addr, scratchPad)) {
+        return SensorReadResult::NO_PRESENCE;
+    }
+    
+    bool allZero = true;
+    for (uint8_t b = 0; b < sizeof(scratchPad); b++) {
+        allZero &= scratchPad[b] == 0;
+    }
+    if (allZero || OneWireBus::crc8(scratchPad, 8) != scratchPad[8]) {
+        return SensorReadResult::CRC_ERROR;
+    }
+    
+    int16_t raw = (int16_t)((scratchPad[1] << 8) | scratchPad[0]);
+    float value;
+    if (addr[0] == FAMILY_DS18S20) {
+        // 0.5 °C register, refined with COUNT_REMAIN / COUNT_PER_C
+        value = raw / 2.0f;
+        if (scratchPad[7] != 0) {
+            value = (raw >> 1) - 0.25f + (float)(scratchPad[7] - scratchPad[6]) / scratchPad[7];
+        }
+    } else {
+        value = raw / 16.0f;
+    }
+    
+    if (value < -55.0f || value > 125.0f) {
+        return SensorReadResult::OUT_OF_RANGE;
+    }
+    
+    temp = value;
+    return SensorReadResult::OK;
+}
+
+bool Ds18x20Driver::alarmSearch(OneWireSearch& state, DeviceAddress addr) {
+    return _bus->search(state, addr, true);
+}
+
+bool Ds18x20Driver::writeAlarmRegisters(const DeviceAddress addr, int8_t high, int8_t low) {
+    uint8_t scratchPad[9];
+    if (!_bus->readScratchpad(addr, scratchPad) ||
+        OneWireBus::crc8(scratchPad, 8) != scratchPad[8]) {
+        return false;
+    }
+    
+    // Each write also goes to the sensor's EEPROM: only write on change
+    if ((int8_t)scratchPad[2] != high || (int8_t)scratchPad[3] != low) {
+        _bus->writeScratchpad(addr, high, low, scratchPad[4], _parasite);
+    }
+    return true;
+}
+
+// ============================================================================
+// MAX31855 Sources
+// ============================================================================
+
+constexpr uint8_t MAX31855_CHIPS = sizeof(MAX31855_CS_PINS) / sizeof(MAX31855_CS_PINS[0]);
+constexpr uint32_t MAX31855_SPI_HZ = 4000000;
+
+// Conversion register bits
+constexpr uint32_t MAX31855_FAULT = 0x00010000;
+constexpr uint32_t MAX31855_SHORT_GND = 0x00000002;
+constexpr uint32_t MAX31855_OPEN_CIRCUIT = 0x00000001;
+
+SpiMax31855Source::SpiMax31855Source() :
+    _spi(HSPI) {
+}
+
+bool SpiMax31855Source::isFitted() {
+    for (uint8_t chip = 0; chip < MAX31855_CHIPS; chip++) {
+        if (MAX31855_CS_PINS[chip] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SpiMax31855Source::begin() {
+    if (!isFitted()) {
+        return false;
+    }
+    
+    for (uint8_t chip = 0; chip < MAX31855_CHIPS; chip++) {
+        if (MAX31855_CS_PINS[chip] >= 0) {
+            pinMode(MAX31855_CS_PINS[chip], OUTPUT);
+            digitalWrite(MAX31855_CS_PINS[chip], HIGH);
+        }
+    }
+    
+    // Read-only bus: no MOSI
+    _spi.begin(PROBE_SPI_SCK_PIN, PROBE_SPI_MISO_PIN, -1, -1);
+    return true;
+}
+
+uint8_t SpiMax31855Source::getChipCount() const {
+    return MAX31855_CHIPS;
+}
+
+bool SpiMax31855Source::isWired(uint8_t chip) const {
+    return chip < MAX31855_CHIPS && MAX31855_CS_PINS[chip] >= 0;
+}
+
+uint32_t SpiMax31855Source::readRaw(uint8_t chip) {
+    int8_t cs = MAX31855_CS_PINS[chip];
+    
+    _spi.beginTransaction(SPISettings(MAX31855_SPI_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(cs, LOW);
+    uint32_t raw = _spi.transfer32(0);
+    digitalWrite(cs, HIGH);
+    _spi.endTransaction();
+    
+    return raw;
+}
+
+/**
+ * Mean temperature of each simulated chip: a kiln above the int16 range
+ * of UDP telemetry, and a freezer below zero
+ */
+static const float SIMULATED_THERMOCOUPLE_BASE[] = {420.0f, -20.0f};
+constexpr uint8_t SIMULATED_THERMOCOUPLE_BASE_COUNT =
+    sizeof(SIMULATED_THERMOCOUPLE_BASE) / sizeof(SIMULATED_THERMOCOUPLE_BASE[0]);
+
+// Period of the simulated temperature swing, cold junction temperature
+constexpr uint32_t SIMULATED_THERMOCOUPLE_PERIOD_MS = 7 * 60 * 1000;
+constexpr float SIMULATED_COLD_JUNCTION = 25.0f;
+
+SimulatedMax31855Source::SimulatedMax31855Source() :
+    _reads(0) {
+}
+
+uint32_t SimulatedMax31855Source::readRaw(uint8_t chip) {
+    if (chip >= SIMULATED_THERMOCOUPLE_COUNT) {
+        return 0;       // Unwired chip select: MISO pulled low
+    }
+    
+    // Injected faults alternate between an open and a shorted thermocouple
+    _reads++;
+    if (_reads % SIMULATED_ERROR_EVERY == 0) {
+        bool open = (_reads / SIMULATED_ERROR_EVERY) % 2;
+        return MAX31855_FAULT | (open ? MAX31855_OPEN_CIRCUIT : MAX31855_SHORT_GND);
+    }
+    
+    float base = SIMULATED_THERMOCOUPLE_BASE[chip % SIMULATED_THERMOCOUPLE_BASE_COUNT];
+    float phase = (float)(millis() % SIMULATED_THERMOCOUPLE_PERIOD_MS) / SIMULATED_THERMOCOUPLE_PERIOD_MS;
+    float value = base + 5.0f * sinf(2.0f * (float)M_PI * (phase + chip * 0.5f));
+    
+    // 14-bit thermocouple value (0.25 °C) in bits 31..18, 12-bit cold
+    // junction (0.0625 °C) in bits 15..4, both two's complement
+    int32_t thermocouple = lroundf(value * 4.0f);
+    int32_t coldJunction = lroundf(SIMULATED_COLD_JUNCTION * 16.0f);
+    return ((uint32_t)(thermocouple & 0x3FFF) << 18) | ((uint32_t)(coldJunction & 0x0FFF) << 4);
+}
+
+// ============================================================================
+// Max31855Driver
+// ============================================================================
+
+// Byte 3 of simulated chip addresses, so they never match a real chip's
+constexpr uint8_t SIMULATED_ADDRESS_TAG = 'S';
+
+Max31855Driver::Max31855Driver(Max31855Source* source) :
+    _source(source),
+    _nextChip(0) {
+}
+
+void Max31855Driver::chipAddress(uint8_t chip, DeviceAddress addr) const {
+    memset(addr, 0, sizeof(DeviceAddress));
+    addr[0] = FAMILY_MAX31855;
+    addr[1] = 'T';
+    addr[2] = 'C';
+    addr[3] = _source->isSimulated() ? SIMULATED_ADDRESS_TAG : 0;
+    addr[7] = chip;
+}
+
+bool Max31855Driver::handles(const DeviceAddress addr) const {
+    return addr[0] == FAMILY_MAX31855 &&
+           addr[3] == (_source->isSimulated() ? SIMULATED_ADDRESS_TAG : 0);
+}
+
+void Max31855Driver::startDiscovery() {
+    _nextChip = 0;
+}
+
+bool Max31855Driver::discoverNext(DeviceAddress addr) {
+    while (_nextChip < _source->getChipCount()) {
+        uint8_t chip = _nextChip++;
+        if (!_source->isWired(chip)) {
+            continue;
+        }
+        
+        // A missing chip leaves MISO floating at all ones or all zeros
+        uint32_t raw = _source->readRaw(chip);
+        if (raw == 0 || raw == UINT32_MAX) {
+            continue;
+        }
+        
+        chipAddress(chip, addr);
+        return true;
+    }
+    return false;
+}
+
+uint16_t Max31855Driver::startConversion() {
+    // Converts continuously (a new result every ~100 ms)
+    return 0;
+}
+
+SensorReadResult Max31855Driver::read(const DeviceAddress addr, float& temp) {
+    temp = TEMP_INVALID;
+    
+    uint8_t chip = addr[7];
+    if (!_source->isWired(chip)) {
+        return SensorReadResult::NO_PRESENCE;
+    }
+    
+    uint32_t raw = _source->readRaw(chip);
+    if (raw == 0 || raw == UINT32_MAX) {
+        return SensorReadResult::NO_PRESENCE;
+    }
+    
+    // Open thermocouple reads as a missing probe; shorts to GND/VCC as faults
+    if (raw & MAX31855_FAULT) {
+        return (raw & MAX31855_OPEN_CIRCUIT) ? SensorReadResult::NO_PRESENCE
+                                             : SensorReadResult::OUT_OF_RANGE;
+    }
+    
+    // 14-bit signed thermocouple temperature in bits 31..18, 0.25 °C
+    temp = ((int32_t)raw >> 18) * 0.25f;
+    return SensorReadResult::OK;
+}
@@ -0,0 +1,280 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sensor Driver Header
+ *
+ * Probe types behind one interface, so they share SensorManager's
+ * non-blocking read cycle, calibration, filters, alarms, history and
+ * publishing:
+ * - start a conversion on all of a driver's probes, poll until it is
+ *   ready, then read the probes in one batch
+ * - probes are identified by an 8-byte address (1-Wire ROM code, or a
+ *   synthetic address whose family code names the driver)
+ *
+ * Drivers:
+ * - Ds18x20Driver: DS18B20, DS1822 and DS18S20 on the OneWire bus
+ * - Max31855Driver: MAX31855 thermocouple converters on SPI
+ *
+ * Probes without hardware (SIMULATE_SENSORS) run the same drivers over
+ * simulated transports: a SimulatedOneWireBus, and a
+ * SimulatedMax31855Source in place of SPI.
+ */
+
+#ifndef SENSOR_DRIVER_H
+#define SENSOR_DRIVER_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "config.h"
+#include "onewire_bus.h"
+
+// Family code for synthetic addresses (not assigned to 1-Wire devices)
+constexpr uint8_t FAMILY_MAX31855 = 0xF5;
+
+/**
+ * Outcome of one probe read
+ */
+enum class SensorReadResult : uint8_t {
+    OK,
+    NO_PRESENCE,    // Probe did not answer (or thermocouple open)
+    CRC_ERROR,      // Transfer corrupted (or all zeros)
+    OUT_OF_RANGE    // Valid transfer, value outside the probe's range or a probe fault
+};
+
+// ============================================================================
+// SensorDriver Class
+// ============================================================================
+
+class SensorDriver {
+public:
+    virtual ~SensorDriver() {}
+    
+    /**
+     * Driver name ("onewire", "max31855"; "-sim" over a simulated transport)
+     */
+    virtual const char* getName() const = 0;
+    
+    /**
+     * Prepare the hardware
+     * @return true if the driver is usable
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * Check if a probe address belongs to this driver (by family code)
+     */
+    virtual bool handles(const DeviceAddress addr) const = 0;
+    
+    /**
+     * Probe type of an address handled by this driver ("ds18b20", ...)
+     */
+    virtual const char* getType(const DeviceAddress addr) const = 0;
+    
+    /**
+     * Restart probe enumeration
+     */
+    virtual void startDiscovery() = 0;
+    
+    /**
+     * Find the next probe (one bus search step for OneWire)
+     * @return false when enumeration is complete or aborted
+     */
+    virtual bool discoverNext(DeviceAddress addr) = 0;
+    
+    /**
+     * Check if the last discoverNext() returned false because of a bus
+     * error; the probes found so far are then an incomplete list
+     */
+    virtual bool discoveryAborted() const { return false; }
+    
+    /**
+     * Start a conversion on all of this driver's probes
+     * @return Worst-case conversion time in ms
+     */
+    virtual uint16_t startConversion() = 0;
+    
+    /**
+     * Check if the conversion started last has completed (non-blocking)
+     */
+    virtual bool isConversionReady() = 0;
+    
+    /**
+     * Read one probe's last conversion (also used for re-reads)
+     * @param temp Temperature in °C (TEMP_INVALID unless OK)
+     */
+    virtual SensorReadResult read(const DeviceAddress addr, float& temp) = 0;
+    
+    /**
+     * Read several probes; by default one read() each
+     */
+    virtual void readBatch(const DeviceAddress* addrs, uint8_t count,
+                           float* temps, SensorReadResult* results);
+};
+
+// ============================================================================
+// Ds18x20Driver Class
+// ============================================================================
+
+class Ds18x20Driver : public SensorDriver {
+public:
+    /**
+     * @param simulatedBus Run on this bus instead of the OneWire pin; the
+     *        driver then handles only simulated ROM codes
+     */
+    explicit Ds18x20Driver(SimulatedOneWireBus* simulatedBus = nullptr);
+    
+    const char* getName() const override { return _simulatedBus ? "onewire-sim" : "onewire"; }
+    bool begin() override;
+    bool handles(const DeviceAddress addr) const override;
+    const char* getType(const DeviceAddress addr) const override;
+    void startDiscovery() override;
+    bool discoverNext(DeviceAddress addr) override;
+    bool discoveryAborted() const override { return _search.aborted; }
+    uint16_t startConversion() override;
+    bool isConversionReady() override;
+    SensorReadResult read(const DeviceAddress addr, float& temp) override;
+    
+    /**
+     * Detect parasite power; moves the bus to the GPIO backend if found,
+     * since only a push-pull pin can supply the conversion current
+     */
+    void detectParasitePower();
+    
+    /**
+     * Check if a parasite-powered device is on the bus
+     */
+    bool isParasite() const { return _parasite; }
+    
+    /**
+     * OneWire backend in use ("gpio", "rmt")
+     */
+    const char* getBusName() const { return _bus->getName(); }
+    
+    /**
+     * Find the next probe with its alarm flag set (Alarm Search)
+     */
+    bool alarmSearch(OneWireSearch& state, DeviceAddress addr);
+    
+    /**
+     * Program TH/TL (written to EEPROM only if they differ)
+     * @return false if the probe could not be read
+     */
+    bool writeAlarmRegisters(const DeviceAddress addr, int8_t high, int8_t low);
+    
+private:
+    GpioOneWireBus _gpioBus;
+    RmtOneWireBus _rmtBus;
+    SimulatedOneWireBus* _simulatedBus;
+    OneWireBus* _bus;                   // Backend in use
+    bool _parasite;
+    OneWireSearch _search;              // Discovery position
+    uint32_t _conversionStart;
+    uint32_t _lastPoll;
+};
+
+// ============================================================================
+// MAX31855 Sources
+// ============================================================================
+
+/**
+ * Where Max31855Driver gets the chips' 32-bit conversion registers
+ */
+class Max31855Source {
+public:
+    virtual ~Max31855Source() {}
+    
+    /**
+     * Prepare the pins
+     * @return false if no chip can be fitted
+     */
+    virtual bool begin() = 0;
+    
+    /**
+     * Number of chip positions
+     */
+    virtual uint8_t getChipCount() const = 0;
+    
+    /**
+     * Check if a chip position is wired (has a chip select)
+     */
+    virtual bool isWired(uint8_t chip) const = 0;
+    
+    /**
+     * Read the 32-bit conversion register of one chip
+     */
+    virtual uint32_t readRaw(uint8_t chip) = 0;
+    
+    /**
+     * Check if the chips are simulated (they get their own addresses)
+     */
+    virtual bool isSimulated() const { return false; }
+};
+
+/**
+ * Chips on the probe SPI bus, one chip select each (MAX31855_CS_PINS)
+ */
+class SpiMax31855Source : public Max31855Source {
+public:
+    SpiMax31855Source();
+    
+    bool begin() override;
+    uint8_t getChipCount() const override;
+    bool isWired(uint8_t chip) const override;
+    uint32_t readRaw(uint8_t chip) override;
+    
+    /**
+     * Check if any chip-select pin is configured
+     */
+    static bool isFitted();
+    
+private:
+    SPIClass _spi;
+};
+
+/**
+ * SIMULATED_THERMOCOUPLE_COUNT chips answering with encoded registers:
+ * one well above the UDP telemetry range, one below zero, and in every
+ * SIMULATED_ERROR_EVERY reads an open or shorted thermocouple
+ */
+class SimulatedMax31855Source : public Max31855Source {
+public:
+    SimulatedMax31855Source();
+    
+    bool begin() override { return SIMULATED_THERMOCOUPLE_COUNT > 0; }
+    uint8_t getChipCount() const override { return SIMULATED_THERMOCOUPLE_COUNT; }
+    bool isWired(uint8_t chip) const override { return chip < SIMULATED_THERMOCOUPLE_COUNT; }
+    uint32_t readRaw(uint8_t chip) override;
+    bool isSimulated() const override { return true; }
+    
+private:
+    uint32_t _reads;
+};
+
+// ============================================================================
+// Max31855Driver Class
+// ============================================================================
+
+class Max31855Driver : public SensorDriver {
+public:
+    explicit Max31855Driver(Max31855Source* source);
+    
+    const char* getName() const override { return _source->isSimulated() ? "max31855-sim" : "max31855"; }
+    bool begin() override { return _source->begin(); }
+    bool handles(const DeviceAddress addr) const override;
+    const char* getType(const DeviceAddress addr) const override { return "max31855"; }
+    void startDiscovery() override;
+    bool discoverNext(DeviceAddress addr) override;
+    uint16_t startConversion() override;
+    bool isConversionReady() override { return true; }
+    SensorReadResult read(const DeviceAddress addr, float& temp) override;
+    
+private:
+    Max31855Source* _source;
+    uint8_t _nextChip;                  // Discovery position
+    
+    /**
+     * Synthetic address of a chip position
+     */
+    void chipAddress(uint8_t chip, DeviceAddress addr) const;
+};
+
+#endif // SENSOR_DRIVER_H
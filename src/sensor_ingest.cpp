@@ -0,0 +1,245 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sensor Ingestion Implementation
+ */
+
+#include "sensor_ingest.h"
+#include "cbor.h"
+#include "udp_telemetry.h"
+
+// Global instance
+SensorIngest sensorIngest;
+
+namespace {
+
+// CBOR major types used by the message format
+constexpr uint8_t CBOR_BYTES = 2;
+constexpr uint8_t CBOR_TEXT = 3;
+constexpr uint8_t CBOR_ARRAY = 4;
+
+// Plausible range for a reading (°C); anything else is a sender bug
+constexpr float INGEST_TEMP_MIN = -273.0f;
+constexpr float INGEST_TEMP_MAX = 2000.0f;
+
+int8_t hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+SensorIngest::SensorIngest() :
+    _queueCount(0),
+    _mux(portMUX_INITIALIZER_UNLOCKED),
+    _messageCount(0),
+    _readingCount(0),
+    _rejectedCount(0),
+    _droppedCount(0) {
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+IngestStatus SensorIngest::submit(const uint8_t* data, size_t len, uint8_t& accepted) {
+    accepted = 0;
+
+    if (!configManager.getIngestConfig().enabled) {
+        return IngestStatus::DISABLED;
+    }
+    if (len > INGEST_MAX_MESSAGE_SIZE) {
+        _rejectedCount++;
+        return IngestStatus::TOO_LARGE;
+    }
+    if (len == 0) {
+        _rejectedCount++;
+        return IngestStatus::INVALID;
+    }
+
+    // CBOR messages are an array; datagrams start with the 'T' magic
+    IngestReading readings[INGEST_MAX_READINGS];
+    int count = (data[0] >> 5) == CBOR_ARRAY ?
+        decodeCbor(data, len, readings) : decodeBinary(data, len, readings);
+
+    if (count < 0) {
+        _rejectedCount++;
+        return count == -2 ? IngestStatus::TOO_LARGE : IngestStatus::INVALID;
+    }
+
+    bool queued = false;
+    portENTER_CRITICAL(&_mux);
+    if (_queueCount + count <= INGEST_QUEUE_SIZE) {
+        memcpy(&_queue[_queueCount], readings, count * sizeof(IngestReading));
+        _queueCount += count;
+        queued = true;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (!queued) {
+        _rejectedCount++;
+        return IngestStatus::BUSY;
+    }
+
+    _messageCount++;
+    accepted = count;
+    return IngestStatus::OK;
+}
+
+void SensorIngest::update() {
+    const IngestConfig& config = configManager.getIngestConfig();
+
+    if (_queueCount > 0) {
+        IngestReading pending[INGEST_QUEUE_SIZE];
+        uint8_t count;
+
+        portENTER_CRITICAL(&_mux);
+        count = _queueCount;
+        memcpy(pending, _queue, count * sizeof(IngestReading));
+        _queueCount = 0;
+        portEXIT_CRITICAL(&_mux);
+
+        for (uint8_t i = 0; i < count; i++) {
+            const IngestReading& reading = pending[i];
+
+            char addressStr[SENSOR_ADDR_STR_LEN];
+            SensorManager::addressToString(reading.address, addressStr);
+            bool known = configManager.getSensorConfigByAddress(addressStr) != nullptr;
+
+            if (sensorManager.pushReading(reading.address, SensorSource::EXTERNAL, reading.temp) < 0) {
+                _droppedCount++;
+                continue;
+            }
+            _readingCount++;
+
+            // A new sensor with a text ID is named after it
+            SensorConfig* sensorConfig = configManager.getSensorConfigByAddress(addressStr);
+            if (!known && sensorConfig && reading.name[0] != '\0') {
+                strlcpy(sensorConfig->name, reading.name, sizeof(sensorConfig->name));
+                configManager.markDirty();
+            }
+        }
+    }
+
+    // Also runs while disabled, so external sensors never show stale values
+    sensorManager.expirePushedSensors(SensorSource::EXTERNAL, (uint32_t)config.timeout * 1000);
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+int SensorIngest::decodeCbor(const uint8_t* data, size_t len, IngestReading* out) {
+    CborReader reader(data, len);
+
+    size_t count;
+    if (!reader.readArray(count)) {
+        return -1;
+    }
+    if (count > INGEST_MAX_READINGS) {
+        return -2;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        IngestReading& reading = out[i];
+        reading.name[0] = '\0';
+
+        size_t fields;
+        if (!reader.readArray(fields) || fields != 2) {
+            return -1;
+        }
+
+        if (reader.peekType() == CBOR_BYTES) {
+            const uint8_t* id;
+            size_t idLen;
+            if (!reader.readBytes(id, idLen) || idLen != sizeof(DeviceAddress)) {
+                return -1;
+            }
+            memcpy(reading.address, id, sizeof(DeviceAddress));
+        } else if (reader.peekType() == CBOR_TEXT) {
+            const char* id;
+            size_t idLen;
+            if (!reader.readText(id, idLen) || idLen == 0 || idLen >= SENSOR_NAME_MAX_LEN) {
+                return -1;
+            }
+            if (addressFromText(id, idLen, reading.address)) {
+                memcpy(reading.name, id, idLen);
+                reading.name[idLen] = '\0';
+            }
+        } else {
+            return -1;
+        }
+
+        // Synthetic addresses of virtual sensors are reserved
+        if (reading.address[0] == VIRTUAL_SENSOR_FAMILY) {
+            return -1;
+        }
+
+        if (reader.readNull()) {
+            reading.temp = TEMP_INVALID;
+        } else if (!reader.readNumber(reading.temp) ||
+                   !(reading.temp >= INGEST_TEMP_MIN && reading.temp <= INGEST_TEMP_MAX)) {
+            return -1;
+        }
+    }
+
+    // Trailing bytes mean the sender and the format disagree
+    return reader.atEnd() ? (int)count : -1;
+}
+
+int SensorIngest::decodeBinary(const uint8_t* data, size_t len, IngestReading* out) {
+    UdpTelemetryHeader header;
+    if (!parseUdpTelemetryHeader(data, len, header) || header.count > INGEST_MAX_READINGS) {
+        return -1;
+    }
+
+    int count = 0;
+    for (uint8_t i = 0; i < header.count; i++) {
+        UdpTelemetryReading reading;
+        float temp = readUdpTelemetryReading(data, i, reading);
+
+        // Virtual sensors of the sender are only meaningful there
+        if (!qualifyUdpTelemetryAddress(header.deviceId, reading.address)) {
+            continue;
+        }
+
+        memcpy(out[count].address, reading.address, sizeof(DeviceAddress));
+        out[count].temp = temp;
+        out[count].name[0] = '\0';
+        count++;
+    }
+    return count;
+}
+
+bool SensorIngest::addressFromText(const char* text, size_t len, DeviceAddress addr) {
+    if (len == 2 * sizeof(DeviceAddress)) {
+        bool hex = true;
+        for (uint8_t i = 0; i < sizeof(DeviceAddress) && hex; i++) {
+            int8_t high = hexValue(text[2 * i]);
+            int8_t low = hexValue(text[2 * i + 1]);
+            hex = high >= 0 && low >= 0;
+            addr[i] = (high << 4) | low;
+        }
+        if (hex) {
+            return false;
+        }
+    }
+
+    // FNV-1a: stable across reboots and firmware versions
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    addr[0] = EXTERNAL_SENSOR_FAMILY;
+    for (uint8_t i = 1; i < sizeof(DeviceAddress); i++) {
+        addr[i] = (uint8_t)(hash >> (8 * (i - 1)));
+    }
+    return true;
+}
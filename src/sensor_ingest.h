@@ -0,0 +1,132 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sensor Ingestion Header
+ *
+ * Accepts batched readings from satellite devices that cannot run the full
+ * firmware (POST /api/ingest, MQTT cmd/ingest) and merges them into the
+ * sensor table as external sensors, with calibration, alarms, history and
+ * HA discovery like local probes. Two message formats, told apart by their
+ * first byte:
+ * - CBOR: array of [id, value] pairs. id is an 8-byte string (used as the
+ *   address), 16 hex digits, or a text ID of up to 31 characters (hashed
+ *   into an address; becomes the sensor name). value is °C, null = error
+ * - Binary: a UDP telemetry datagram (see udp_telemetry.h)
+ *
+ * Cost per message is bounded: at most INGEST_MAX_MESSAGE_SIZE bytes and
+ * INGEST_MAX_READINGS readings, decoded without allocation. Readings are
+ * queued and applied by the main loop, so web handlers never touch the
+ * sensor table.
+ */
+
+#ifndef SENSOR_INGEST_H
+#define SENSOR_INGEST_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+// Family code of addresses derived from text IDs (not a 1-Wire family)
+constexpr uint8_t EXTERNAL_SENSOR_FAMILY = 0xEE;
+
+/**
+ * Result of submitting one message
+ */
+enum class IngestStatus : uint8_t {
+    OK,                 // All readings queued
+    DISABLED,           // Ingestion is turned off
+    TOO_LARGE,          // Message or reading count over the limit
+    INVALID,            // Not a valid message
+    BUSY                // Queue full, retry later
+};
+
+/**
+ * Reading waiting to be applied
+ */
+struct IngestReading {
+    DeviceAddress address;
+    float temp;                         // °C, TEMP_INVALID = sensor error
+    char name[SENSOR_NAME_MAX_LEN];     // Name for new sensors ("" = default)
+};
+
+// ============================================================================
+// SensorIngest Class
+// ============================================================================
+
+class SensorIngest {
+public:
+    /**
+     * Constructor
+     */
+    SensorIngest();
+
+    /**
+     * Decode a message and queue its readings
+     * All or nothing: a message is either queued whole or rejected
+     * Safe to call from async web handlers
+     * @param data Message bytes
+     * @param len Message size
+     * @param accepted Number of readings queued
+     * @return Result
+     */
+    IngestStatus submit(const uint8_t* data, size_t len, uint8_t& accepted);
+
+    /**
+     * Update ingestion (call in main loop)
+     * Applies queued readings and expires silent external sensors
+     */
+    void update();
+
+    /**
+     * Get number of accepted messages
+     */
+    uint32_t getMessageCount() const { return _messageCount; }
+
+    /**
+     * Get number of readings applied to external sensors
+     */
+    uint32_t getReadingCount() const { return _readingCount; }
+
+    /**
+     * Get number of rejected messages
+     */
+    uint32_t getRejectedCount() const { return _rejectedCount; }
+
+    /**
+     * Get number of readings dropped (sensor table full, or address taken
+     * by another sensor)
+     */
+    uint32_t getDroppedCount() const { return _droppedCount; }
+
+private:
+    IngestReading _queue[INGEST_QUEUE_SIZE];
+    uint8_t _queueCount;
+    portMUX_TYPE _mux;
+    uint32_t _messageCount;
+    uint32_t _readingCount;
+    uint32_t _rejectedCount;
+    uint32_t _droppedCount;
+
+    /**
+     * Decode a CBOR message
+     * @return Number of readings, -1 if invalid, -2 if too many
+     */
+    int decodeCbor(const uint8_t* data, size_t len, IngestReading* out);
+
+    /**
+     * Decode a UDP telemetry datagram
+     * @return Number of readings, -1 if invalid
+     */
+    int decodeBinary(const uint8_t* data, size_t len, IngestReading* out);
+
+    /**
+     * Build the address of a text ID (16 hex digits, else hashed)
+     * @return true if the ID was hashed (the ID becomes the sensor name)
+     */
+    static bool addressFromText(const char* text, size_t len, DeviceAddress addr);
+};
+
+// Global sensor ingestion instance
+extern SensorIngest sensorIngest;
+
+#endif // SENSOR_INGEST_H
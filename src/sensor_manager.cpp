@@ -4,10 +4,54 @@
  */
 
 #include "sensor_manager.h"
+#include <rom/crc.h>
+#include "boot_metrics.h"
 
 // Global instance
 SensorManager sensorManager;
 
+static_assert(MAX_SENSORS <= 32, "Acknowledgement mask holds one bit per sensor");
+
+// ============================================================================
+// Persistent Alarm State
+// ============================================================================
+
+constexpr uint32_t ALARM_SNAPSHOT_MAGIC = 0x414C524D;  // 'ALRM'
+
+constexpr uint8_t ALARM_FLAG_ACKNOWLEDGED = 0x01;
+constexpr uint8_t ALARM_FLAG_LATCHED = 0x02;
+constexpr uint8_t ALARM_FLAG_RULE = 0x04;
+
+struct AlarmSnapshotEntry {
+    char address[SENSOR_ADDR_STR_LEN];
+    uint8_t state;                      // AlarmState
+    uint8_t flags;
+};
+
+struct AlarmSnapshot {
+    uint32_t magic;
+    uint32_t crc;                       // CRC32 of entries
+    AlarmSnapshotEntry entries[MAX_SENSORS];
+};
+
+// Not cleared by the bootloader on software/watchdog resets; random after power-on
+RTC_NOINIT_ATTR static AlarmSnapshot rtcAlarmSnapshot;
+
+static uint32_t alarmSnapshotCrc(const AlarmSnapshot& snapshot) {
+    return crc32_le(0, (const uint8_t*)snapshot.entries, sizeof(snapshot.entries));
+}
+
+static bool isAlarmActive(AlarmState state) {
+    return state == AlarmState::BELOW_LOW || state == AlarmState::ABOVE_HIGH;
+}
+
+// ============================================================================
+// Topology Cache
+// ============================================================================
+
+constexpr const char* TOPOLOGY_SECTION_KEY = "topology";
+constexpr uint16_t TOPOLOGY_SECTION_VERSION = 1;
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -27,17 +71,35 @@ const char* alarmStateToString(AlarmState state) {
 // ============================================================================
 
 SensorManager::SensorManager() :
-    _oneWire(ONEWIRE_PIN),
-    _sensors(&_oneWire),
+    _max31855(&_max31855Spi),
+#if SIMULATE_SENSORS
+    _simulatedOneWire(&_simulatedBus),
+    _simulatedMax31855(&_simulatedChips),
+#endif
+    _driverCount(0),
     _sensorCount(0),
     _lastReadTime(0),
     _lastDiscoveryTime(0),
     _rescanRequested(false),
+    _reconcilePending(false),
+    _ruleReloadRequested(false),
+    _discoveryActive(false),
+    _discoveryDriver(0),
+    _discoveryCount(0),
+    _discoveryRestarts(0),
+    _ackRequests(0),
     _alarmCallback(nullptr),
     _connectionCallback(nullptr),
     _dataChanged(false),
+    _readGeneration(0),
+    _inputMask(0),
+    _alarmCycle(0),
+    _skippedReads(0),
+    _conversionCount(0),
     _readState(SensorReadState::IDLE),
-    _conversionStartTime(0) {
+    _conversionStartTime(0),
+    _conversionTime(0) {
+    memset(&_topology, 0, sizeof(_topology));
 }
 
 // ============================================================================
@@ -47,106 +109,745 @@ SensorManager::SensorManager() :
 bool SensorManager::begin() {
     Serial.println(F("[SensorManager] Initializing..."));
     
-    // Initialize DallasTemperature library
-    _sensors.begin();
-    _sensors.setWaitForConversion(false);  // Async mode
+    beginDrivers();
+    
+    // Compile alarm rules (bound to sensor indices by discovery)
+    _ruleEngine.load();
     
-    // Discover sensors
-    uint8_t found = discoverSensors();
+    uint8_t found;
+    if (loadTopology() && !(_topology.flags & TOPOLOGY_FLAG_PARASITE)) {
+        // Known sensors start converting right away; the full search that
+        // reconciles the cache runs from update() after the first reading
+        Serial.printf("[SensorManager] Using cached topology (%d sensors)\n", _topology.count);
+        
+        DeviceAddress cached[MAX_SENSORS];
+        memcpy(cached, _topology.addresses, sizeof(cached));
+        orderByConfig(cached, _topology.count);
+        applyTopology(cached, _topology.count);
+        
+        found = _sensorCount;
+        _reconcilePending = true;
+    } else {
+        _ds18x20.detectParasitePower();
+        found = discoverSensors();
+    }
+    
+    // Resume alarm states from before the reset instead of re-announcing them
+    restoreAlarmStates();
+    
+    // Start the first conversion now; update() collects it ~750 ms later
+    // instead of waiting a full read interval after boot
+    readTemperatures();
     
     Serial.printf("[SensorManager] Initialization complete. Found %d sensors\n", found);
     
     return found > 0;
 }
 
+void SensorManager::beginDrivers() {
+    _driverCount = 0;
+    
+    _ds18x20.begin();
+    _drivers[_driverCount++] = &_ds18x20;
+    
+    if (_max31855.begin()) {
+        _drivers[_driverCount++] = &_max31855;
+    }
+    
+#if SIMULATE_SENSORS
+    if (_simulatedOneWire.begin()) {
+        _drivers[_driverCount++] = &_simulatedOneWire;
+    }
+    if (_simulatedMax31855.begin()) {
+        _drivers[_driverCount++] = &_simulatedMax31855;
+    }
+#endif
+    
+    for (uint8_t d = 0; d < _driverCount; d++) {
+        Serial.printf("[SensorManager] Probe driver: %s\n", _drivers[d]->getName());
+    }
+}
+
+SensorDriver* SensorManager::driverFor(const DeviceAddress addr) const {
+    for (uint8_t d = 0; d < _driverCount; d++) {
+        if (_drivers[d]->handles(addr)) {
+            return _drivers[d];
+        }
+    }
+    return nullptr;
+}
+
 uint8_t SensorManager::discoverSensors() {
     Serial.println(F("[SensorManager] Scanning for sensors..."));
     
-    // Get number of devices on bus
-    uint8_t deviceCount = _sensors.getDeviceCount();
-    Serial.printf("[SensorManager] Found %d devices on OneWire bus\n", deviceCount);
+    DeviceAddress found[MAX_SENSORS];
+    bool complete;
+    uint8_t physicalCount = searchProbes(found, complete);
     
-    // Track previously connected sensors to detect changes
-    bool previouslyConnected[MAX_SENSORS];
-    for (uint8_t i = 0; i < _sensorCount; i++) {
-        previouslyConnected[i] = _sensorData[i].connected;
+    // Config order keeps indices stable whatever order the search returns
+    orderByConfig(found, physicalCount);
+    applyTopology(found, physicalCount);
+    
+    // A partial list is used for now but never cached; the background
+    // search completes it after the first reading
+    if (complete) {
+        saveTopology(found, physicalCount);
+    }
+    
+    _lastDiscoveryTime = millis();
+    _rescanRequested = false;
+    _reconcilePending = !complete;
+    
+    Serial.printf("[SensorManager] Discovery complete. %d probes found, %d virtual\n",
+        physicalCount, _sensorCount - physicalCount);
+    
+    return _sensorCount;
+}
+
+uint8_t SensorManager::searchProbes(DeviceAddress* found, bool& complete) {
+    uint8_t count = 0;
+    uint8_t restarts = 0;
+    complete = true;
+    
+    // Enumerate the probes of every driver in turn
+    for (uint8_t d = 0; d < _driverCount; d++) {
+        SensorDriver* driver = _drivers[d];
+        DeviceAddress addr;
+        uint8_t driverCount = 0;
+        uint8_t driverStart = count;
+        
+        driver->startDiscovery();
+        while (count < MAX_SENSORS) {
+            if (!driver->discoverNext(addr)) {
+                if (!driver->discoveryAborted()) {
+                    break;
+                }
+                if (restarts >= DISCOVERY_MAX_RESTARTS) {
+                    Serial.printf("[SensorManager] Search aborted (%s), list incomplete\n", driver->getName());
+                    complete = false;
+                    break;
+                }
+                
+                // Bus error: search this driver's probes again from the start
+                Serial.printf("[SensorManager] Search aborted (%s), restarting\n", driver->getName());
+                restarts++;
+                count = driverStart;
+                driverCount = 0;
+                driver->startDiscovery();
+                continue;
+            }
+            
+            // Check for duplicate address (can happen with electrical issues)
+            bool isDuplicate = false;
+            for (uint8_t i = 0; i < count; i++) {
+                if (memcmp(found[i], addr, sizeof(DeviceAddress)) == 0) {
+                    isDuplicate = true;
+                    break;
+                }
+            }
+            if (isDuplicate) {
+                Serial.printf("[SensorManager] Skipping duplicate sensor address\n");
+                continue;
+            }
+            
+            memcpy(found[count], addr, sizeof(DeviceAddress));
+            count++;
+            driverCount++;
+        }
+        
+        Serial.printf("[SensorManager] Found %d probes (%s)\n", driverCount, driver->getName());
+    }
+    
+    return count;
+}
+
+void SensorManager::orderByConfig(DeviceAddress* addresses, uint8_t count) {
+    const SensorConfig* base = configManager.getSensorConfig(0);
+    uint8_t slots[MAX_SENSORS];
+    
+    for (uint8_t i = 0; i < count; i++) {
+        char addressStr[SENSOR_ADDR_STR_LEN];
+        addressToString(addresses[i], addressStr);
+        
+        // Ensure sensor has configuration (no free slot: sorted last)
+        SensorConfig* config = configManager.findOrCreateSensorConfig(addressStr);
+        slots[i] = config ? (uint8_t)(config - base) : MAX_SENSORS;
+    }
+    
+    // Insertion sort, at most MAX_SENSORS entries
+    for (uint8_t i = 1; i < count; i++) {
+        for (uint8_t j = i; j > 0 && slots[j - 1] > slots[j]; j--) {
+            uint8_t slot = slots[j];
+            slots[j] = slots[j - 1];
+            slots[j - 1] = slot;
+            
+            DeviceAddress addr;
+            memcpy(addr, addresses[j], sizeof(DeviceAddress));
+            memcpy(addresses[j], addresses[j - 1], sizeof(DeviceAddress));
+            memcpy(addresses[j - 1], addr, sizeof(DeviceAddress));
+        }
+    }
+}
+
+void SensorManager::applyTopology(const DeviceAddress* addresses, uint8_t count) {
+    // Entries move to their new index with history and alarm state intact
+    SensorData previous[MAX_SENSORS];
+    uint8_t previousCount = _sensorCount;
+    for (uint8_t i = 0; i < previousCount; i++) {
+        previous[i] = _sensorData[i];
+    }
+    
+    // Report sensors that left the bus while their index is still valid
+    for (uint8_t i = 0; i < previousCount; i++) {
+        if (previous[i].source != SensorSource::PHYSICAL || !previous[i].connected) {
+            continue;
+        }
+        
+        bool present = false;
+        for (uint8_t k = 0; k < count && !present; k++) {
+            present = memcmp(addresses[k], previous[i].address, sizeof(DeviceAddress)) == 0;
+        }
+        
+        if (!present) {
+            _sensorData[i].connected = false;
+            _sensorData[i].alarmState = AlarmState::SENSOR_ERROR;
+            
+            if (_connectionCallback) {
+                _connectionCallback(i, false);
+            }
+        }
     }
     
-    // Reset sensor count for rediscovery
-    uint8_t oldSensorCount = _sensorCount;
     _sensorCount = 0;
+    for (uint8_t k = 0; k < count; k++) {
+        SensorData& sensor = _sensorData[_sensorCount];
+        
+        int8_t from = -1;
+        for (uint8_t i = 0; i < previousCount; i++) {
+            if (previous[i].source == SensorSource::PHYSICAL &&
+                memcmp(previous[i].address, addresses[k], sizeof(DeviceAddress)) == 0) {
+                from = i;
+                break;
+            }
+        }
+        
+        if (from >= 0) {
+            sensor = previous[from];
+        } else {
+            // Not connected until the first valid reading, so the display
+            // never shows -127.0 during boot
+            sensor = SensorData();
+            memcpy(sensor.address, addresses[k], sizeof(DeviceAddress));
+            addressToString(addresses[k], sensor.addressStr);
+        }
+        
+        const SensorConfig* config = configManager.getSensorConfigByAddress(sensor.addressStr);
+        Serial.printf("[SensorManager] Sensor %d: %s (%s)\n",
+            _sensorCount,
+            sensor.addressStr,
+            config ? config->name : "no config"
+        );
+        
+        _sensorCount++;
+    }
     
-    // Enumerate all DS18B20 sensors
-    DeviceAddress addr;
-    _oneWire.reset_search();
+    // Previous virtual entries follow with their history; new ones after them
+    for (uint8_t i = 0; i < previousCount && _sensorCount < MAX_SENSORS; i++) {
+        if (previous[i].source == SensorSource::VIRTUAL) {
+            _sensorData[_sensorCount++] = previous[i];
+        }
+    }
+    
+    appendVirtualSensors();
     
-    while (_oneWire.search(addr) && _sensorCount < MAX_SENSORS) {
-        // Check if this is a DS18B20 (family code 0x28)
-        if (addr[0] != 0x28) {
+    // Pushed sensors come last, so adding one never moves another index
+    for (uint8_t i = 0; i < previousCount && _sensorCount < MAX_SENSORS; i++) {
+        if (isPushed(previous[i])) {
+            _sensorData[_sensorCount++] = previous[i];
+        }
+    }
+    
+    bindRules();
+}
+
+void SensorManager::startDiscovery() {
+    Serial.println(F("[SensorManager] Scanning for sensors (background)..."));
+    
+    _rescanRequested = false;
+    _discoveryActive = true;
+    _discoveryCount = 0;
+    _discoveryDriver = 0;
+    _discoveryRestarts = 0;
+    _drivers[0]->startDiscovery();
+}
+
+void SensorManager::stepDiscovery() {
+    for (uint8_t step = 0; step < DISCOVERY_STEPS_PER_UPDATE; step++) {
+        if (_discoveryCount >= MAX_SENSORS || _discoveryDriver >= _driverCount) {
+            finishDiscovery();
+            return;
+        }
+        
+        DeviceAddress addr;
+        if (!_drivers[_discoveryDriver]->discoverNext(addr)) {
+            if (_drivers[_discoveryDriver]->discoveryAborted()) {
+                // A partial list would mark the missing probes disconnected
+                // and truncate the topology cache: run the whole pass again
+                if (_discoveryRestarts >= DISCOVERY_MAX_RESTARTS) {
+                    Serial.println(F("[SensorManager] Search aborted, sensor list left unchanged"));
+                    _discoveryActive = false;
+                    _lastDiscoveryTime = millis();
+                    return;
+                }
+                
+                Serial.println(F("[SensorManager] Search aborted, restarting pass"));
+                _discoveryRestarts++;
+                _discoveryCount = 0;
+                _discoveryDriver = 0;
+                _drivers[0]->startDiscovery();
+                continue;
+            }
+            
+            // This driver is done: continue with the next one
+            if (++_discoveryDriver < _driverCount) {
+                _drivers[_discoveryDriver]->startDiscovery();
+            }
             continue;
         }
         
         // Check for duplicate address (can happen with electrical issues)
         bool isDuplicate = false;
-        for (uint8_t i = 0; i < _sensorCount; i++) {
-            if (memcmp(_sensorData[i].address, addr, sizeof(DeviceAddress)) == 0) {
+        for (uint8_t i = 0; i < _discoveryCount; i++) {
+            if (memcmp(_discoveryFound[i], addr, sizeof(DeviceAddress)) == 0) {
                 isDuplicate = true;
                 break;
             }
         }
         if (isDuplicate) {
-            Serial.printf("[SensorManager] Skipping duplicate sensor address\n");
             continue;
         }
         
-        // Copy address
-        memcpy(_sensorData[_sensorCount].address, addr, sizeof(DeviceAddress));
+        memcpy(_discoveryFound[_discoveryCount], addr, sizeof(DeviceAddress));
+        _discoveryCount++;
+    }
+}
+
+void SensorManager::finishDiscovery() {
+    _discoveryActive = false;
+    
+    // Creates configs for new sensors; the cache keeps config order
+    orderByConfig(_discoveryFound, _discoveryCount);
+    
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_sensorData[i].source != SensorSource::PHYSICAL) {
+            continue;
+        }
         
-        // Convert to string
-        addressToString(addr, _sensorData[_sensorCount].addressStr);
+        bool present = false;
+        for (uint8_t k = 0; k < _discoveryCount && !present; k++) {
+            present = memcmp(_discoveryFound[k], _sensorData[i].address, sizeof(DeviceAddress)) == 0;
+        }
         
-        // Set resolution
-        _sensors.setResolution(addr, SENSOR_RESOLUTION);
+        // Missing sensors keep their index
+        if (!present) {
+            markDisconnected(i);
+        }
+    }
+    
+    // Hot-added sensors go after every existing entry: alarm, notification
+    // and MQTT state is kept by index, so no index may ever move
+    uint8_t added = 0;
+    for (uint8_t k = 0; k < _discoveryCount; k++) {
+        char addressStr[SENSOR_ADDR_STR_LEN];
+        addressToString(_discoveryFound[k], addressStr);
+        
+        if (getSensorIndexByAddress(addressStr) >= 0) {
+            continue;
+        }
         
-        // Don't mark as connected yet - wait for first valid temperature reading
-        // This prevents showing -127.0 on display during boot
-        _sensorData[_sensorCount].connected = false;
-        _sensorData[_sensorCount].errorCount = 0;
+        if (_sensorCount >= MAX_SENSORS) {
+            Serial.printf("[SensorManager] No free slot for sensor %s\n", addressStr);
+            continue;
+        }
+        uint8_t index = _sensorCount++;
         
-        // Ensure sensor has configuration
-        SensorConfig* config = configManager.findOrCreateSensorConfig(
-            _sensorData[_sensorCount].addressStr
-        );
+        _sensorData[index] = SensorData();
+        memcpy(_sensorData[index].address, _discoveryFound[k], sizeof(DeviceAddress));
+        strcpy(_sensorData[index].addressStr, addressStr);
         
-        if (config) {
-            Serial.printf("[SensorManager] Sensor %d: %s (%s)\n",
-                _sensorCount,
-                _sensorData[_sensorCount].addressStr,
-                config->name
-            );
+        const SensorConfig* config = configManager.getSensorConfigByAddress(addressStr);
+        Serial.printf("[SensorManager] Sensor %d: %s (%s) added\n",
+            index, addressStr, config ? config->name : "no config");
+        added++;
+    }
+    
+    appendVirtualSensors();
+    bindRules();
+    
+    saveTopology(_discoveryFound, _discoveryCount);
+    
+    _lastDiscoveryTime = millis();
+    _dataChanged = true;
+    
+    Serial.printf("[SensorManager] Discovery complete. %d probes found, %d added\n",
+        _discoveryCount, added);
+}
+
+// ============================================================================
+// Bus Diagnostics
+// ============================================================================
+
+float SensorDiagnostics::errorRate() const {
+    if (windowCount == 0) {
+        return 0.0f;
+    }
+    uint32_t mask = windowCount >= 32 ? UINT32_MAX : ((1UL << windowCount) - 1);
+    return (float)__builtin_popcount(errorWindow & mask) / windowCount;
+}
+
+SensorReadResult SensorManager::readSensor(uint8_t index, float& temp) {
+    SensorData& sensor = _sensorData[index];
+    SensorDriver* driver = driverFor(sensor.address);
+    
+    temp = TEMP_INVALID;
+    if (!driver) {
+        recordRead(index, SensorReadResult::NO_PRESENCE, 0);
+        return SensorReadResult::NO_PRESENCE;
+    }
+    
+    uint32_t start = micros();
+    SensorReadResult result = driver->read(sensor.address, temp);
+    recordRead(index, result, micros() - start);
+    
+    return result;
+}
+
+void SensorManager::recordRead(uint8_t index, SensorReadResult result, uint32_t latencyUs) {
+    SensorDiagnostics& diag = _sensorData[index].diag;
+    
+    diag.reads++;
+    diag.lastLatencyUs = latencyUs > UINT16_MAX ? UINT16_MAX : latencyUs;
+    if (diag.lastLatencyUs > diag.maxLatencyUs) {
+        diag.maxLatencyUs = diag.lastLatencyUs;
+    }
+    
+    // A missing presence pulse points at wiring or a dead probe, CRC errors
+    // at signal quality (pull-up, cable length), range errors at the probe
+    switch (result) {
+        case SensorReadResult::NO_PRESENCE:  diag.presenceErrors++; break;
+        case SensorReadResult::CRC_ERROR:    diag.crcErrors++;      break;
+        case SensorReadResult::OUT_OF_RANGE: diag.rangeErrors++;    break;
+        default:                                                    break;
+    }
+    
+    diag.errorWindow = (diag.errorWindow << 1) | (result != SensorReadResult::OK ? 1 : 0);
+    if (diag.windowCount < 32) {
+        diag.windowCount++;
+    }
+}
+
+float SensorManager::retryRead(uint8_t index, SensorReadResult result, uint8_t& budget) {
+    SensorData& sensor = _sensorData[index];
+    float temp = TEMP_INVALID;
+    
+    // Dead probes are checked once per cycle, not retried
+    uint8_t retries = sensor.errorCount >= 3 ? 0 : READ_MAX_RETRIES;
+    
+    // Only transfer failures are worth a re-read: an out-of-range value
+    // with a valid CRC is what the sensor actually converted
+    while (retries > 0 && budget > 0 &&
+           (result == SensorReadResult::NO_PRESENCE || result == SensorReadResult::CRC_ERROR)) {
+        retries--;
+        budget--;
+        sensor.diag.retries++;
+        
+        result = readSensor(index, temp);
+        if (result == SensorReadResult::OK) {
+            sensor.diag.recovered++;
+        }
+    }
+    
+    return result == SensorReadResult::OK ? temp : TEMP_INVALID;
+}
+
+void SensorManager::readDriverSensors(SensorDriver* driver, uint32_t readMask, uint8_t& budget) {
+    DeviceAddress addrs[MAX_SENSORS];
+    uint8_t indices[MAX_SENSORS];
+    float temps[MAX_SENSORS];
+    SensorReadResult results[MAX_SENSORS];
+    uint8_t count = 0;
+    
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_sensorData[i].source != SensorSource::PHYSICAL ||
+            !driver->handles(_sensorData[i].address)) {
+            continue;
         }
         
-        _sensorCount++;
+        if (!(readMask & (1UL << i))) {
+            _skippedReads++;
+            continue;
+        }
+        
+        memcpy(addrs[count], _sensorData[i].address, sizeof(DeviceAddress));
+        indices[count] = i;
+        count++;
     }
     
-    // Check for disconnected sensors
-    for (uint8_t i = _sensorCount; i < oldSensorCount; i++) {
-        if (previouslyConnected[i]) {
-            _sensorData[i].connected = false;
-            _sensorData[i].alarmState = AlarmState::SENSOR_ERROR;
-            
-            if (_connectionCallback) {
-                _connectionCallback(i, false);
+    if (count == 0) {
+        return;
+    }
+    
+    // Drivers may share one transaction across probes: latency is per probe
+    uint32_t start = micros();
+    driver->readBatch(addrs, count, temps, results);
+    uint32_t latency = (micros() - start) / count;
+    
+    for (uint8_t n = 0; n < count; n++) {
+        uint8_t index = indices[n];
+        recordRead(index, results[n], latency);
+        
+        float temp = temps[n];
+        if (results[n] != SensorReadResult::OK) {
+            temp = retryRead(index, results[n], budget);
+        }
+        
+        applyReading(index, temp);
+    }
+}
+
+void SensorManager::applyReading(uint8_t index, float temp) {
+    SensorData& sensor = _sensorData[index];
+    
+    // Check for valid reading
+    if (temp == TEMP_INVALID) {
+        sensor.errorCount++;
+        
+        // Mark as disconnected after 3 consecutive errors
+        if (sensor.errorCount >= 3) {
+            markDisconnected(index);
+        }
+        return;
+    }
+    
+    // Valid reading
+    sensor.errorCount = 0;
+    
+    // Check if sensor was reconnected
+    if (!sensor.connected) {
+        sensor.connected = true;
+        if (_connectionCallback) {
+            _connectionCallback(index, true);
+        }
+    }
+    
+    // Store raw temperature
+    sensor.rawTemperature = temp;
+    
+    // Smooth, then apply calibration
+    sensor.filteredTemperature = applyFilter(index, temp);
+    sensor.temperature = applyCalibration(index, sensor.filteredTemperature);
+    
+    // Add to history
+    addToHistory(index, sensor.temperature);
+    
+    if (configManager.getBusConfig().hardwareAlarms) {
+        syncAlarmRegisters(index);
+    }
+}
+
+BusDiagnostics SensorManager::getBusDiagnostics() const {
+    BusDiagnostics bus = {};
+    bus.conversions = _conversionCount;
+    bus.skippedReads = _skippedReads;
+    bus.backend = _ds18x20.getBusName();
+    
+    uint32_t windowReads = 0;
+    uint32_t windowErrors = 0;
+    
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        const SensorData& sensor = _sensorData[i];
+        if (sensor.source != SensorSource::PHYSICAL) {
+            continue;
+        }
+        
+        const SensorDiagnostics& diag = sensor.diag;
+        bus.reads += diag.reads;
+        bus.crcErrors += diag.crcErrors;
+        bus.presenceErrors += diag.presenceErrors;
+        bus.rangeErrors += diag.rangeErrors;
+        bus.retries += diag.retries;
+        bus.recovered += diag.recovered;
+        if (diag.maxLatencyUs > bus.maxLatencyUs) {
+            bus.maxLatencyUs = diag.maxLatencyUs;
+        }
+        
+        windowReads += diag.windowCount;
+        windowErrors += (uint32_t)(diag.errorRate() * diag.windowCount + 0.5f);
+    }
+    
+    bus.errorRate = windowReads > 0 ? (float)windowErrors / windowReads : 0.0f;
+    return bus;
+}
+
+// ============================================================================
+// Hardware Alarm Mode
+// ============================================================================
+
+/**
+ * TH/TL value for a threshold in raw (uncalibrated) degrees
+ * The DS18B20 compares only the integer part of the reading (rounded down),
+ * so rounding the threshold down flags every reading beyond it
+ */
+static int8_t alarmRegisterFor(float rawThreshold) {
+    float value = floorf(rawThreshold);
+    if (value < -55.0f) return -55;
+    if (value > 125.0f) return 125;
+    return (int8_t)value;
+}
+
+uint32_t SensorManager::selectSensorsToRead() {
+    const BusConfig& bus = configManager.getBusConfig();
+    if (!bus.hardwareAlarms) {
+        return UINT32_MAX;
+    }
+    
+    // Periodic full read keeps history and published values current
+    _alarmCycle++;
+    if (bus.inRangeReadEvery <= 1 || _alarmCycle % bus.inRangeReadEvery == 0) {
+        return UINT32_MAX;
+    }
+    
+    uint32_t mask = _inputMask | searchAlarmedSensors();
+    
+    // Anything not settled in range needs every reading: alarms and their
+    // exit delays, latches, errors, and sensors whose TH/TL are unprogrammed
+    // or stale after a threshold or calibration change
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        const SensorData& sensor = _sensorData[i];
+        if (!sensor.connected || !sensor.alarmRegsValid || sensor.alarmLatched ||
+            sensor.alarmState != AlarmState::NORMAL ||
+            sensor.pendingAlarmState != AlarmState::NORMAL) {
+            mask |= 1UL << i;
+            continue;
+        }
+        
+        int8_t high, low;
+        if (expectedAlarmRegisters(i, high, low) &&
+            (sensor.alarmHigh != high || sensor.alarmLow != low)) {
+            mask |= 1UL << i;
+        }
+    }
+    
+    return mask;
+}
+
+uint32_t SensorManager::searchAlarmedSensors() {
+    uint32_t mask = 0;
+    DeviceAddress addr;
+    OneWireSearch search;
+    
+    for (uint8_t found = 0; found < MAX_SENSORS && _ds18x20.alarmSearch(search, addr); found++) {
+        for (uint8_t i = 0; i < _sensorCount; i++) {
+            if (_sensorData[i].source == SensorSource::PHYSICAL &&
+                memcmp(_sensorData[i].address, addr, sizeof(DeviceAddress)) == 0) {
+                mask |= 1UL << i;
+                break;
             }
         }
     }
     
-    _lastDiscoveryTime = millis();
-    _rescanRequested = false;
+    // A search cut short may have missed alarmed sensors: read them all
+    return search.aborted ? UINT32_MAX : mask;
+}
+
+bool SensorManager::expectedAlarmRegisters(uint8_t index, int8_t& high, int8_t& low) const {
+    const SensorData& sensor = _sensorData[index];
+    const SensorConfig* config = configManager.getSensorConfigByAddress(sensor.addressStr);
+    if (!config || sensor.source != SensorSource::PHYSICAL || driverFor(sensor.address) != &_ds18x20) {
+        return false;   // Only local DS18x20 probes have alarm registers
+    }
+    
+    // The device sees raw readings, thresholds apply to calibrated ones
+    high = alarmRegisterFor(config->thresholdHigh - config->calibrationOffset);
+    low = alarmRegisterFor(config->thresholdLow - config->calibrationOffset);
+    return true;
+}
+
+void SensorManager::syncAlarmRegisters(uint8_t index) {
+    SensorData& sensor = _sensorData[index];
+    int8_t high, low;
+    if (!expectedAlarmRegisters(index, high, low)) {
+        return;
+    }
+    
+    if (sensor.alarmRegsValid && sensor.alarmHigh == high && sensor.alarmLow == low) {
+        return;
+    }
+    
+    if (!_ds18x20.writeAlarmRegisters(sensor.address, high, low)) {
+        return;     // Tried again after the next reading
+    }
+    
+    sensor.alarmHigh = high;
+    sensor.alarmLow = low;
+    sensor.alarmRegsValid = true;
+    
+    Serial.printf("[SensorManager] Sensor %d alarm registers: TL=%d TH=%d\n", index, low, high);
+}
+
+void SensorManager::markDisconnected(uint8_t index) {
+    SensorData& sensor = _sensorData[index];
+    if (!sensor.connected) {
+        return;
+    }
+    
+    sensor.connected = false;
+    sensor.temperature = TEMP_INVALID;
+    sensor.rawTemperature = TEMP_INVALID;
+    sensor.filteredTemperature = TEMP_INVALID;
+    sensor.filter = SensorFilterState();
+    
+    AlarmState oldState = sensor.alarmState;
+    sensor.alarmState = AlarmState::SENSOR_ERROR;
+    
+    if (_connectionCallback) {
+        _connectionCallback(index, false);
+    }
     
-    Serial.printf("[SensorManager] Discovery complete. %d DS18B20 sensors found\n", _sensorCount);
+    if (_alarmCallback && oldState != AlarmState::SENSOR_ERROR) {
+        _alarmCallback(index, oldState, AlarmState::SENSOR_ERROR, TEMP_INVALID);
+    }
+}
+
+bool SensorManager::loadTopology() {
+    if (!configManager.loadSection(TOPOLOGY_SECTION_KEY, TOPOLOGY_SECTION_VERSION,
+                                   &_topology, sizeof(_topology)) ||
+        _topology.count == 0 || _topology.count > MAX_SENSORS) {
+        memset(&_topology, 0, sizeof(_topology));
+        return false;
+    }
+    return true;
+}
+
+void SensorManager::saveTopology(const DeviceAddress* addresses, uint8_t count) {
+    SensorTopology topology;
+    memset(&topology, 0, sizeof(topology));
+    topology.count = count;
+    topology.flags = _ds18x20.isParasite() ? TOPOLOGY_FLAG_PARASITE : 0;
+    memcpy(topology.addresses, addresses, count * sizeof(DeviceAddress));
+    
+    // Unchanged topology: no flash write
+    if (memcmp(&topology, &_topology, sizeof(topology)) == 0) {
+        return;
+    }
     
-    return _sensorCount;
+    if (configManager.saveSection(TOPOLOGY_SECTION_KEY, TOPOLOGY_SECTION_VERSION,
+                                  &topology, sizeof(topology))) {
+        _topology = topology;
+        Serial.printf("[SensorManager] Topology cached (%d sensors)\n", count);
+    } else {
+        Serial.println(F("[SensorManager] Failed to cache topology"));
+    }
 }
 
 void SensorManager::readTemperatures() {
@@ -157,18 +858,31 @@ void SensorManager::readTemperatures() {
     // Non-blocking temperature reading using state machine
     switch (_readState) {
         case SensorReadState::IDLE:
-            // Start temperature conversion
-            _sensors.requestTemperatures();
+            // Start temperature conversion on every driver at once
+            _conversionTime = 0;
+            for (uint8_t d = 0; d < _driverCount; d++) {
+                uint16_t ms = _drivers[d]->startConversion();
+                if (ms > _conversionTime) {
+                    _conversionTime = ms;
+                }
+            }
             _conversionStartTime = millis();
+            _conversionCount++;
             _readState = SensorReadState::CONVERSION_REQUESTED;
             // Exit and let conversion happen in background
             return;
             
         case SensorReadState::CONVERSION_REQUESTED:
-            // Check if conversion time has elapsed (750ms for 12-bit resolution)
-            if (millis() - _conversionStartTime < 750) {
-                // Still converting, exit and check again next update
-                return;
+            // Done once every driver reports ready, or at the worst-case time
+            if (millis() - _conversionStartTime < _conversionTime) {
+                bool ready = true;
+                for (uint8_t d = 0; d < _driverCount && ready; d++) {
+                    ready = _drivers[d]->isConversionReady();
+                }
+                if (!ready) {
+                    // Still converting, exit and check again next update
+                    return;
+                }
             }
             // Conversion complete, ready to read
             _readState = SensorReadState::READY_TO_READ;
@@ -180,56 +894,26 @@ void SensorManager::readTemperatures() {
     }
     
     // Read temperatures from all discovered sensors
+    uint32_t readMask = selectSensorsToRead();
+    uint8_t retryBudget = READ_RETRY_BUDGET;
+    
+    for (uint8_t d = 0; d < _driverCount; d++) {
+        readDriverSensors(_drivers[d], readMask, retryBudget);
+    }
+    
+    // Cached probes whose driver did not start (e.g. board removed)
     for (uint8_t i = 0; i < _sensorCount; i++) {
-        float temp = _sensors.getTempC(_sensorData[i].address);
-        
-        // Check for valid reading
-        if (temp == DEVICE_DISCONNECTED_C || temp < -55.0f || temp > 125.0f) {
-            _sensorData[i].errorCount++;
-            
-            if (_sensorData[i].errorCount >= 3) {
-                // Mark as disconnected after 3 consecutive errors
-                if (_sensorData[i].connected) {
-                    _sensorData[i].connected = false;
-                    _sensorData[i].temperature = TEMP_INVALID;
-                    _sensorData[i].rawTemperature = TEMP_INVALID;
-                    
-                    AlarmState oldState = _sensorData[i].alarmState;
-                    _sensorData[i].alarmState = AlarmState::SENSOR_ERROR;
-                    
-                    if (_connectionCallback) {
-                        _connectionCallback(i, false);
-                    }
-                    
-                    if (_alarmCallback && oldState != AlarmState::SENSOR_ERROR) {
-                        _alarmCallback(i, oldState, AlarmState::SENSOR_ERROR, TEMP_INVALID);
-                    }
-                }
-            }
-            continue;
-        }
-        
-        // Valid reading
-        _sensorData[i].errorCount = 0;
-        
-        // Check if sensor was reconnected
-        if (!_sensorData[i].connected) {
-            _sensorData[i].connected = true;
-            if (_connectionCallback) {
-                _connectionCallback(i, true);
-            }
+        if (_sensorData[i].source == SensorSource::PHYSICAL && !driverFor(_sensorData[i].address)) {
+            float temp;
+            readSensor(i, temp);
+            applyReading(i, temp);
         }
-        
-        // Store raw temperature
-        _sensorData[i].rawTemperature = temp;
-        
-        // Apply calibration
-        _sensorData[i].temperature = applyCalibration(i, temp);
-        
-        // Add to history
-        addToHistory(i, _sensorData[i].temperature);
     }
     
+    // Derived values use this cycle's calibrated readings
+    evaluateVirtualSensors();
+    evaluateRules();
+    
     _lastReadTime = millis();
     
     // Check alarm states
@@ -237,6 +921,8 @@ void SensorManager::readTemperatures() {
     
     // Mark data as changed
     _dataChanged = true;
+    _readGeneration++;
+    bootMetrics.mark(BootStage::FIRST_READING);
     
     // Reset state machine for next reading cycle
     _readState = SensorReadState::IDLE;
@@ -246,8 +932,32 @@ void SensorManager::update() {
     uint32_t now = millis();
     
     // Manual sensor discovery only (via rescan button)
-    if (_rescanRequested) {
-        discoverSensors();
+    if (_rescanRequested && !_discoveryActive) {
+        startDiscovery();
+    }
+    
+    // Started from the cached topology: reconcile with a background search
+    // once the first reading is in. Battery wakes stop calling update()
+    // once their reading is in, so they never search. Parasite-powered
+    // buses never start from the cache, so begin() is not needed here.
+    if (_reconcilePending && !_discoveryActive && _readGeneration > 0) {
+        _reconcilePending = false;
+        startDiscovery();
+    }
+    
+    // A search resets the bus, so it only advances between conversions
+    if (_discoveryActive && _readState == SensorReadState::IDLE) {
+        stepDiscovery();
+    }
+    
+    if (_ruleReloadRequested) {
+        _ruleReloadRequested = false;
+        _ruleEngine.load();
+        bindRules();
+    }
+    
+    if (__atomic_load_n(&_ackRequests, __ATOMIC_ACQUIRE)) {
+        processAcknowledgements();
     }
     
     // Non-blocking temperature reading state machine
@@ -264,6 +974,31 @@ void SensorManager::update() {
     }
 }
 
+uint32_t SensorManager::getNextReadingMs() const {
+    uint32_t now = millis();
+    
+    // Worst case before the first cycle has measured it
+    uint32_t conversion = _conversionTime > 0 ? _conversionTime : 750;
+    
+    switch (_readState) {
+        case SensorReadState::IDLE: {
+            // The next cycle starts one read interval after the last one ended
+            uint32_t readInterval = configManager.getSystemConfig().readInterval * 1000;
+            uint32_t elapsed = now - _lastReadTime;
+            uint32_t untilStart = elapsed >= readInterval ? 0 : readInterval - elapsed;
+            return untilStart + conversion;
+        }
+            
+        case SensorReadState::CONVERSION_REQUESTED: {
+            uint32_t elapsed = now - _conversionStartTime;
+            return elapsed >= conversion ? 0 : conversion - elapsed;
+        }
+            
+        default:
+            return 0;
+    }
+}
+
 SensorData* SensorManager::getSensorData(uint8_t index) {
     if (index >= _sensorCount) {
         return nullptr;
@@ -303,6 +1038,46 @@ void SensorManager::addressToString(const DeviceAddress addr, char* buffer) {
     buffer[16] = '\0';
 }
 
+void SensorManager::virtualAddress(uint8_t slot, DeviceAddress addr) {
+    memset(addr, 0, sizeof(DeviceAddress));
+    addr[0] = VIRTUAL_SENSOR_FAMILY;
+    addr[1] = 'V';
+    addr[2] = 'S';
+    addr[7] = slot;
+}
+
+bool SensorManager::isVirtual(uint8_t index) const {
+    return index < _sensorCount && _sensorData[index].source == SensorSource::VIRTUAL;
+}
+
+const char* SensorManager::getUnit(uint8_t index) const {
+    if (isVirtual(index)) {
+        const VirtualSensorDef* def = configManager.getVirtualSensorDef(_sensorData[index].virtualSlot);
+        if (def && def->op == VirtualSensorOp::HEAT_FLOW) {
+            return "kW";
+        }
+    }
+    return configManager.getSystemConfig().celsiusUnits ? "°C" : "°F";
+}
+
+const char* SensorManager::getSensorType(uint8_t index) const {
+    if (index >= _sensorCount) {
+        return "unknown";
+    }
+    if (isVirtual(index)) {
+        return "virtual";
+    }
+    if (_sensorData[index].source == SensorSource::REMOTE) {
+        return "remote";
+    }
+    if (_sensorData[index].source == SensorSource::EXTERNAL) {
+        return "external";
+    }
+    
+    const SensorDriver* driver = driverFor(_sensorData[index].address);
+    return driver ? driver->getType(_sensorData[index].address) : "unknown";
+}
+
 void SensorManager::calibrateAll(float referenceTemp) {
     Serial.printf("[SensorManager] Calibrating all sensors to %.2f°C\n", referenceTemp);
     
@@ -333,7 +1108,7 @@ uint8_t SensorManager::calibrateUncalibrated(float referenceTemp) {
 }
 
 bool SensorManager::isUncalibrated(uint8_t index) const {
-    if (index >= _sensorCount) return false;
+    if (index >= _sensorCount || isVirtual(index)) return false;
     
     const SensorConfig* config = configManager.getSensorConfigByAddress(
         _sensorData[index].addressStr
@@ -353,12 +1128,13 @@ bool SensorManager::isUncalibrated(uint8_t index) const {
 }
 
 void SensorManager::calibrateSensor(uint8_t index, float referenceTemp) {
-    if (index >= _sensorCount || !_sensorData[index].connected) {
+    // Virtual sensors are not referenced to a physical temperature
+    if (index >= _sensorCount || !_sensorData[index].connected || isVirtual(index)) {
         return;
     }
     
     // Calculate offset: reference - raw
-    float offset = referenceTemp - _sensorData[index].rawTemperature;
+    float offset = referenceTemp - _sensorData[index].filteredTemperature;
     
     // Get config and update offset
     SensorConfig* config = configManager.getSensorConfigByAddress(
@@ -374,7 +1150,7 @@ void SensorManager::calibrateSensor(uint8_t index, float referenceTemp) {
         
         // Update current temperature with new calibration
         _sensorData[index].temperature = applyCalibration(index, 
-            _sensorData[index].rawTemperature);
+            _sensorData[index].filteredTemperature);
     }
 }
 
@@ -402,7 +1178,7 @@ void SensorManager::resetSensorCalibration(uint8_t index) {
         configManager.markDirty();
         
         // Update current temperature
-        _sensorData[index].temperature = _sensorData[index].rawTemperature;
+        _sensorData[index].temperature = _sensorData[index].filteredTemperature;
     }
 }
 
@@ -413,7 +1189,7 @@ void SensorManager::recalculateTemperature(uint8_t index) {
     
     // Recalculate temperature using current raw temperature and updated offset
     _sensorData[index].temperature = applyCalibration(index, 
-        _sensorData[index].rawTemperature);
+        _sensorData[index].filteredTemperature);
     
     Serial.printf("[SensorManager] Recalculated temperature for sensor %d: %.2f°C (raw: %.2f°C)\n",
         index, _sensorData[index].temperature, _sensorData[index].rawTemperature);
@@ -422,11 +1198,28 @@ void SensorManager::recalculateTemperature(uint8_t index) {
     _dataChanged = true;
 }
 
+void SensorManager::resetFilter(uint8_t index) {
+    if (index >= _sensorCount || isVirtual(index)) {
+        return;
+    }
+    
+    // Restart from the latest reading rather than waiting a full window
+    SensorData& sensor = _sensorData[index];
+    sensor.filter = SensorFilterState();
+    if (sensor.rawTemperature != TEMP_INVALID) {
+        sensor.filteredTemperature = applyFilter(index, sensor.rawTemperature);
+        sensor.temperature = applyCalibration(index, sensor.filteredTemperature);
+        _dataChanged = true;
+    }
+}
+
 float SensorManager::getAverageTemperature() const {
     float sum = 0;
     uint8_t count = 0;
     
+    // Derived values (deltas, power) would skew the summary
     for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_sensorData[i].source == SensorSource::VIRTUAL) continue;
         if (_sensorData[i].connected && _sensorData[i].temperature != TEMP_INVALID) {
             sum += _sensorData[i].temperature;
             count++;
@@ -441,6 +1234,7 @@ float SensorManager::getMinTemperature() const {
     bool found = false;
     
     for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_sensorData[i].source == SensorSource::VIRTUAL) continue;
         if (_sensorData[i].connected && _sensorData[i].temperature != TEMP_INVALID) {
             if (!found || _sensorData[i].temperature < minTemp) {
                 minTemp = _sensorData[i].temperature;
@@ -457,6 +1251,7 @@ float SensorManager::getMaxTemperature() const {
     bool found = false;
     
     for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_sensorData[i].source == SensorSource::VIRTUAL) continue;
         if (_sensorData[i].connected && _sensorData[i].temperature != TEMP_INVALID) {
             if (!found || _sensorData[i].temperature > maxTemp) {
                 maxTemp = _sensorData[i].temperature;
@@ -491,6 +1286,72 @@ uint8_t SensorManager::getAlarmCount() const {
     return count;
 }
 
+// ============================================================================
+// Pushed Sensors
+// ============================================================================
+
+int8_t SensorManager::pushReading(const DeviceAddress addr, SensorSource source, float temp) {
+    char addressStr[SENSOR_ADDR_STR_LEN];
+    addressToString(addr, addressStr);
+    
+    int8_t index = getSensorIndexByAddress(addressStr);
+    if (index >= 0 && _sensorData[index].source != source) {
+        return -1;      // Address belongs to a local probe or another source
+    }
+    
+    if (index < 0) {
+        if (_sensorCount >= MAX_SENSORS) {
+            return -1;
+        }
+        
+        // Appended, so the index of every other sensor stays the same
+        uint8_t slot = _sensorCount;
+        
+        SensorData& sensor = _sensorData[slot];
+        sensor = SensorData();
+        memcpy(sensor.address, addr, sizeof(DeviceAddress));
+        strcpy(sensor.addressStr, addressStr);
+        sensor.source = source;
+        _sensorCount++;
+        index = slot;
+        
+        // Thresholds, name and MQTT/HA identity come from a regular sensor config
+        SensorConfig* config = configManager.findOrCreateSensorConfig(addressStr);
+        
+        Serial.printf("[SensorManager] Sensor %d: %s (%s, %s) added\n",
+            index, addressStr, getSensorType(index), config ? config->name : "no config");
+        
+        bindRules();
+    }
+    
+    _sensorData[index].pushedAt = millis();
+    
+    // The source has already debounced its errors
+    if (temp == TEMP_INVALID) {
+        markDisconnected(index);
+    } else {
+        applyReading(index, temp);
+    }
+    
+    _dataChanged = true;
+    return index;
+}
+
+void SensorManager::expirePushedSensors(SensorSource source, uint32_t timeoutMs) {
+    uint32_t now = millis();
+    
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        const SensorData& sensor = _sensorData[i];
+        if (sensor.source != source || !sensor.connected || now - sensor.pushedAt < timeoutMs) {
+            continue;
+        }
+        
+        Serial.printf("[SensorManager] Sensor %d: %s timed out\n", i, sensor.addressStr);
+        markDisconnected(i);
+        _dataChanged = true;
+    }
+}
+
 // ============================================================================
 // Private Methods
 // ============================================================================
@@ -501,6 +1362,8 @@ void SensorManager::checkAlarms() {
             updateAlarmState(i);
         }
     }
+    
+    persistAlarmStates();
 }
 
 void SensorManager::updateAlarmState(uint8_t index) {
@@ -525,40 +1388,172 @@ void SensorManager::updateAlarmState(uint8_t index) {
     float lowThreshold = config->thresholdLow;
     float highThreshold = config->thresholdHigh;
     
-    if (currentState == AlarmState::BELOW_LOW) {
+    // Hysteresis only applies to an alarm the thresholds raised themselves
+    bool thresholdAlarm = !_sensorData[index].ruleAlarm;
+    
+    if (currentState == AlarmState::BELOW_LOW && thresholdAlarm) {
         // Already in low alarm, need to rise above threshold + hysteresis to clear
         lowThreshold += THRESHOLD_HYSTERESIS;
-    } else if (currentState == AlarmState::ABOVE_HIGH) {
+    } else if (currentState == AlarmState::ABOVE_HIGH && thresholdAlarm) {
         // Already in high alarm, need to drop below threshold - hysteresis to clear
         highThreshold -= THRESHOLD_HYSTERESIS;
     }
     
     // Determine new state
+    AlarmRuleSeverity ruleSeverity;
+    _sensorData[index].ruleAlarm = false;
     if (temp < lowThreshold) {
         newState = AlarmState::BELOW_LOW;
     } else if (temp > highThreshold) {
         newState = AlarmState::ABOVE_HIGH;
+    } else if (_ruleEngine.getTargetAlarm(index, ruleSeverity)) {
+        // Rules raise the same states as thresholds so every consumer handles them
+        newState = (ruleSeverity == AlarmRuleSeverity::BELOW_LOW) ?
+            AlarmState::BELOW_LOW : AlarmState::ABOVE_HIGH;
+        _sensorData[index].ruleAlarm = true;
     } else {
         newState = AlarmState::NORMAL;
     }
     
-    // Check for state change
-    if (newState != currentState) {
-        _sensorData[index].prevAlarmState = currentState;
-        _sensorData[index].alarmState = newState;
+    SensorData& sensor = _sensorData[index];
+    
+    if (newState == currentState) {
+        // Condition agrees with the reported state: cancel any pending change
+        sensor.pendingAlarmState = currentState;
+        sensor.alarmLatched = false;
+        return;
+    }
+    
+    // Entry/exit delay: the new condition must persist before it is reported
+    const SensorAlarmConfig* timing = configManager.getSensorAlarmConfig(sensor.addressStr);
+    uint32_t delayMs = 0;
+    if (timing) {
+        if (isAlarmActive(newState)) {
+            delayMs = timing->entryDelay * 1000UL;
+        } else if (isAlarmActive(currentState)) {
+            delayMs = timing->exitDelay * 1000UL;
+        }
+    }
+    
+    uint32_t now = millis();
+    if (sensor.pendingAlarmState != newState) {
+        sensor.pendingAlarmState = newState;
+        sensor.pendingSince = now;
+    }
+    if (now - sensor.pendingSince < delayMs) {
+        return;
+    }
+    
+    // Latched alarms stay active until acknowledged
+    if (newState == AlarmState::NORMAL && isAlarmActive(currentState) &&
+        timing && timing->latch && !sensor.alarmAcknowledged) {
+        if (!sensor.alarmLatched) {
+            sensor.alarmLatched = true;
+            Serial.printf("[SensorManager] Sensor %d alarm latched until acknowledged\n", index);
+        }
+        return;
+    }
+    
+    sensor.prevAlarmState = currentState;
+    sensor.alarmState = newState;
+    sensor.alarmLatched = false;
+    if (isAlarmActive(newState)) {
+        sensor.alarmAcknowledged = false;
+    }
+    
+    // Trigger callback
+    if (_alarmCallback) {
+        _alarmCallback(index, currentState, newState, temp);
+    }
+    
+    Serial.printf("[SensorManager] Sensor %d alarm state: %s -> %s (%.1f°C)\n",
+        index, 
+        alarmStateToString(currentState),
+        alarmStateToString(newState),
+        temp
+    );
+}
+
+bool SensorManager::acknowledgeAlarm(uint8_t index) {
+    if (index >= _sensorCount || !isAlarmActive(_sensorData[index].alarmState)) {
+        return false;
+    }
+    // Set from the web and MQTT tasks, cleared by update() on the other
+    // core: a plain |= could lose a concurrent request
+    __atomic_fetch_or(&_ackRequests, 1UL << index, __ATOMIC_ACQ_REL);
+    return true;
+}
+
+void SensorManager::processAcknowledgements() {
+    uint32_t requests = __atomic_exchange_n(&_ackRequests, 0, __ATOMIC_ACQ_REL);
+    
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (!(requests & (1UL << i)) || !isAlarmActive(_sensorData[i].alarmState)) {
+            continue;
+        }
+        
+        _sensorData[i].alarmAcknowledged = true;
+        Serial.printf("[SensorManager] Sensor %d alarm acknowledged\n", i);
+        
+        // Releases a latched alarm whose condition has already cleared
+        if (_sensorData[i].connected) {
+            updateAlarmState(i);
+        }
+    }
+    
+    persistAlarmStates();
+}
+
+void SensorManager::persistAlarmStates() {
+    for (uint8_t i = 0; i < MAX_SENSORS; i++) {
+        AlarmSnapshotEntry& entry = rtcAlarmSnapshot.entries[i];
+        memset(&entry, 0, sizeof(entry));
         
-        // Trigger callback
-        if (_alarmCallback) {
-            _alarmCallback(index, currentState, newState, temp);
+        if (i < _sensorCount) {
+            const SensorData& sensor = _sensorData[i];
+            memcpy(entry.address, sensor.addressStr, SENSOR_ADDR_STR_LEN);
+            entry.state = (uint8_t)sensor.alarmState;
+            entry.flags = (sensor.alarmAcknowledged ? ALARM_FLAG_ACKNOWLEDGED : 0) |
+                          (sensor.alarmLatched ? ALARM_FLAG_LATCHED : 0) |
+                          (sensor.ruleAlarm ? ALARM_FLAG_RULE : 0);
         }
+    }
+    
+    rtcAlarmSnapshot.crc = alarmSnapshotCrc(rtcAlarmSnapshot);
+    rtcAlarmSnapshot.magic = ALARM_SNAPSHOT_MAGIC;
+}
+
+void SensorManager::restoreAlarmStates() {
+    if (rtcAlarmSnapshot.magic != ALARM_SNAPSHOT_MAGIC ||
+        rtcAlarmSnapshot.crc != alarmSnapshotCrc(rtcAlarmSnapshot)) {
+        Serial.println(F("[SensorManager] No saved alarm states (power-on)"));
+        return;
+    }
+    
+    uint8_t restored = 0;
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        SensorData& sensor = _sensorData[i];
         
-        Serial.printf("[SensorManager] Sensor %d alarm state: %s -> %s (%.1f°C)\n",
-            index, 
-            alarmStateToString(currentState),
-            alarmStateToString(newState),
-            temp
-        );
+        // Match by address: sensors may have been added or removed
+        for (uint8_t k = 0; k < MAX_SENSORS; k++) {
+            const AlarmSnapshotEntry& entry = rtcAlarmSnapshot.entries[k];
+            if (entry.state > (uint8_t)AlarmState::SENSOR_ERROR ||
+                strncmp(entry.address, sensor.addressStr, SENSOR_ADDR_STR_LEN) != 0) {
+                continue;
+            }
+            
+            sensor.alarmState = (AlarmState)entry.state;
+            sensor.prevAlarmState = sensor.alarmState;
+            sensor.pendingAlarmState = sensor.alarmState;
+            sensor.alarmAcknowledged = entry.flags & ALARM_FLAG_ACKNOWLEDGED;
+            sensor.alarmLatched = entry.flags & ALARM_FLAG_LATCHED;
+            sensor.ruleAlarm = entry.flags & ALARM_FLAG_RULE;
+            restored++;
+            break;
+        }
     }
+    
+    Serial.printf("[SensorManager] Restored %d alarm states\n", restored);
 }
 
 void SensorManager::addToHistory(uint8_t index, float temp) {
@@ -598,8 +1593,15 @@ void SensorManager::addToHistory(uint8_t index, float temp) {
         return;
     }
     
-    // Store as int16_t (temp * 100) to save memory
-    int16_t historyValue = (int16_t)(temp * 100.0f);
+    // Store as int16_t (temp * 100) to save memory; thermocouples can
+    // exceed the range, keep clear of TEMP_HISTORY_INVALID
+    float scaled = temp * 100.0f;
+    if (scaled > 32767.0f) {
+        scaled = 32767.0f;
+    } else if (scaled < -32767.0f) {
+        scaled = -32767.0f;
+    }
+    int16_t historyValue = (int16_t)scaled;
     sensor.history[sensor.historyIndex] = historyValue;
     sensor.historyIndex = (sensor.historyIndex + 1) % TEMP_HISTORY_SIZE;
     
@@ -627,3 +1629,236 @@ float SensorManager::applyCalibration(uint8_t index, float rawTemp) {
     
     return rawTemp;
 }
+
+float SensorManager::applyFilter(uint8_t index, float rawTemp) {
+    const SensorFilterConfig* config = configManager.getSensorFilterConfig(
+        _sensorData[index].addressStr
+    );
+    if (!config || config->type == SensorFilterType::NONE) {
+        return rawTemp;
+    }
+    
+    SensorFilterState& state = _sensorData[index].filter;
+    int32_t sample = (int32_t)lroundf(rawTemp * 256.0f);
+    
+    state.window[state.pos] = sample;
+    state.pos = (state.pos + 1) % 5;
+    if (state.count < 5) {
+        state.count++;
+    }
+    
+    int32_t output = sample;
+    switch (config->type) {
+        case SensorFilterType::EMA:
+            // First reading seeds the average; rounded so it settles on
+            // a steady input instead of stopping one step short
+            if (state.count == 1) {
+                state.ema = sample;
+            } else {
+                state.ema += ((sample - state.ema) * config->alpha + 128) >> 8;
+            }
+            output = state.ema;
+            break;
+            
+        case SensorFilterType::MEDIAN3:
+        case SensorFilterType::MEDIAN5: {
+            // Median of the newest n readings (fewer right after a reset)
+            uint8_t n = config->type == SensorFilterType::MEDIAN3 ? 3 : 5;
+            if (n > state.count) {
+                n = state.count;
+            }
+            
+            int32_t sorted[5];
+            for (uint8_t k = 0; k < n; k++) {
+                int32_t value = state.window[(state.pos + 5 - 1 - k) % 5];
+                uint8_t j = k;
+                while (j > 0 && sorted[j - 1] > value) {
+                    sorted[j] = sorted[j - 1];
+                    j--;
+                }
+                sorted[j] = value;
+            }
+            output = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+            break;
+        }
+            
+        default:
+            break;
+    }
+    
+    return output / 256.0f;
+}
+
+void SensorManager::appendVirtualSensors() {
+    for (uint8_t slot = 0; slot < MAX_VIRTUAL_SENSORS; slot++) {
+        const VirtualSensorDef* def = configManager.getVirtualSensorDef(slot);
+        if (!def || !def->enabled) {
+            continue;
+        }
+        
+        DeviceAddress addr;
+        char addressStr[SENSOR_ADDR_STR_LEN];
+        virtualAddress(slot, addr);
+        addressToString(addr, addressStr);
+        
+        // Already in the table: keeps its index and history
+        if (getSensorIndexByAddress(addressStr) >= 0) {
+            continue;
+        }
+        
+        if (_sensorCount >= MAX_SENSORS) {
+            Serial.printf("[SensorManager] No free slot for virtual sensor %d\n", slot);
+            break;
+        }
+        
+        SensorData& sensor = _sensorData[_sensorCount];
+        sensor = SensorData();
+        memcpy(sensor.address, addr, sizeof(DeviceAddress));
+        strcpy(sensor.addressStr, addressStr);
+        sensor.source = SensorSource::VIRTUAL;
+        sensor.virtualSlot = slot;
+        
+        // Thresholds, name and MQTT/HA identity come from a regular sensor config
+        SensorConfig* config = configManager.findOrCreateSensorConfig(sensor.addressStr);
+        
+        Serial.printf("[SensorManager] Sensor %d: %s (virtual %s, %s)\n",
+            _sensorCount,
+            sensor.addressStr,
+            virtualSensorOpToString(def->op),
+            config ? config->name : "no config"
+        );
+        
+        _sensorCount++;
+    }
+}
+
+void SensorManager::evaluateVirtualSensors() {
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        SensorData& sensor = _sensorData[i];
+        if (sensor.source != SensorSource::VIRTUAL) {
+            continue;
+        }
+        
+        const VirtualSensorDef* def = configManager.getVirtualSensorDef(sensor.virtualSlot);
+        if (!def || !def->enabled) {
+            // Removed or disabled: the entry keeps its index until the next
+            // restart, but is not an error and raises no alarm
+            sensor.connected = false;
+            sensor.temperature = TEMP_INVALID;
+            sensor.alarmState = AlarmState::NORMAL;
+            continue;
+        }
+        float value = computeVirtual(*def);
+        
+        if (value == TEMP_INVALID) {
+            // Inputs missing: same handling as a disconnected probe
+            markDisconnected(i);
+            continue;
+        }
+        
+        if (!sensor.connected) {
+            sensor.connected = true;
+            if (_connectionCallback) {
+                _connectionCallback(i, true);
+            }
+        }
+        
+        sensor.rawTemperature = value;
+        sensor.filteredTemperature = value;
+        sensor.temperature = applyCalibration(i, value);
+        addToHistory(i, sensor.temperature);
+    }
+}
+
+float SensorManager::computeVirtual(const VirtualSensorDef& def) {
+    float values[VIRTUAL_SENSOR_MAX_INPUTS];
+    bool valid[VIRTUAL_SENSOR_MAX_INPUTS];
+    uint8_t validCount = 0;
+    
+    // Inputs may be physical or earlier virtual sensors
+    for (uint8_t k = 0; k < def.inputCount && k < VIRTUAL_SENSOR_MAX_INPUTS; k++) {
+        const SensorData* input = getSensorDataByAddress(def.inputs[k]);
+        valid[k] = input && input->connected && input->temperature != TEMP_INVALID;
+        values[k] = valid[k] ? input->temperature : TEMP_INVALID;
+        if (valid[k]) {
+            validCount++;
+        }
+    }
+    
+    switch (def.op) {
+        case VirtualSensorOp::DIFF:
+        case VirtualSensorOp::HEAT_FLOW: {
+            if (def.inputCount < 2 || !valid[0] || !valid[1]) {
+                return TEMP_INVALID;
+            }
+            float delta = values[0] - values[1];
+            if (def.op == VirtualSensorOp::DIFF) {
+                return delta;
+            }
+            return def.flowRate * WATER_HEAT_FLOW_KW_PER_LPM_K * delta;
+        }
+        
+        case VirtualSensorOp::MEAN:
+        case VirtualSensorOp::MIN:
+        case VirtualSensorOp::MAX: {
+            // Aggregates use whichever inputs are available
+            if (validCount == 0) {
+                return TEMP_INVALID;
+            }
+            float sum = 0.0f;
+            float result = TEMP_INVALID;
+            bool first = true;
+            for (uint8_t k = 0; k < def.inputCount; k++) {
+                if (!valid[k]) {
+                    continue;
+                }
+                sum += values[k];
+                if (first ||
+                    (def.op == VirtualSensorOp::MIN && values[k] < result) ||
+                    (def.op == VirtualSensorOp::MAX && values[k] > result)) {
+                    result = values[k];
+                    first = false;
+                }
+            }
+            return def.op == VirtualSensorOp::MEAN ? sum / validCount : result;
+        }
+    }
+    
+    return TEMP_INVALID;
+}
+
+void SensorManager::bindRules() {
+    const char* addresses[MAX_SENSORS];
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        addresses[i] = _sensorData[i].addressStr;
+    }
+    _ruleEngine.bind(addresses, _sensorCount);
+    
+    // Rules and virtual sensors need fresh values from their inputs
+    _inputMask = 0;
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        if (_ruleEngine.isReferenced(i)) {
+            _inputMask |= 1UL << i;
+        }
+    }
+    for (uint8_t slot = 0; slot < MAX_VIRTUAL_SENSORS; slot++) {
+        const VirtualSensorDef* def = configManager.getVirtualSensorDef(slot);
+        if (!def || !def->enabled) {
+            continue;
+        }
+        for (uint8_t k = 0; k < def->inputCount && k < VIRTUAL_SENSOR_MAX_INPUTS; k++) {
+            int8_t index = getSensorIndexByAddress(def->inputs[k]);
+            if (index >= 0) {
+                _inputMask |= 1UL << index;
+            }
+        }
+    }
+}
+
+void SensorManager::evaluateRules() {
+    float values[MAX_SENSORS];
+    for (uint8_t i = 0; i < _sensorCount; i++) {
+        values[i] = _sensorData[i].connected ? _sensorData[i].temperature : TEMP_INVALID;
+    }
+    _ruleEngine.evaluate(values, _sensorCount);
+}
@@ -2,8 +2,9 @@
  * ESP32 Temperature Monitoring System
  * Sensor Manager Header
  * 
- * Handles DS18B20 temperature sensor operations including:
- * - Sensor discovery and enumeration
+ * Handles temperature sensor operations including:
+ * - Sensor discovery and enumeration through the probe drivers
+ *   (cached topology, config order)
  * - Temperature reading with calibration
  * - Alarm state management
  * - Temperature history
@@ -13,10 +14,10 @@
 #define SENSOR_MANAGER_H
 
 #include <Arduino.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
 #include "config.h"
 #include "config_manager.h"
+#include "alarm_rules.h"
+#include "sensor_driver.h"
 
 // ============================================================================
 // Data Structures
@@ -32,6 +33,85 @@ enum class AlarmState {
     SENSOR_ERROR    // Sensor error (disconnected, etc.)
 };
 
+/**
+ * Where a sensor's value comes from
+ */
+enum class SensorSource : uint8_t {
+    PHYSICAL,       // Probe read through a SensorDriver
+    VIRTUAL,        // Computed from other sensors (VirtualSensorDef)
+    REMOTE,         // Pushed by a peer station (hub mode)
+    EXTERNAL        // Pushed by a satellite device (ingestion API)
+};
+
+// Family code used for synthetic addresses (never assigned to real 1-Wire devices)
+constexpr uint8_t VIRTUAL_SENSOR_FAMILY = 0x00;
+
+/**
+ * Read health of one sensor
+ * Counters are totals since boot; the window holds the last 32 reads
+ */
+struct SensorDiagnostics {
+    uint32_t reads;                         // Scratchpad read attempts
+    uint32_t crcErrors;                     // Scratchpad failed CRC (or read all zeros)
+    uint32_t presenceErrors;                // No presence pulse
+    uint32_t rangeErrors;                   // Valid CRC, value outside -55..125 °C
+    uint32_t retries;                       // Immediate re-reads after a failed read
+    uint32_t recovered;                     // Cycles saved by a re-read
+    uint32_t errorWindow;                   // Bit per read, newest in bit 0, 1 = failed
+    uint8_t windowCount;                    // Valid bits in errorWindow
+    uint16_t lastLatencyUs;                 // Duration of the last read
+    uint16_t maxLatencyUs;
+    
+    SensorDiagnostics() :
+        reads(0),
+        crcErrors(0),
+        presenceErrors(0),
+        rangeErrors(0),
+        retries(0),
+        recovered(0),
+        errorWindow(0),
+        windowCount(0),
+        lastLatencyUs(0),
+        maxLatencyUs(0) {
+    }
+    
+    /**
+     * Fraction of failed reads in the window (0..1)
+     */
+    float errorRate() const;
+};
+
+/**
+ * Read health of the whole bus (sum over physical sensors)
+ */
+struct BusDiagnostics {
+    uint32_t conversions;                   // Conversion cycles started
+    uint32_t reads;
+    uint32_t crcErrors;
+    uint32_t presenceErrors;
+    uint32_t rangeErrors;
+    uint32_t retries;
+    uint32_t recovered;
+    uint32_t skippedReads;                  // Saved by hardware alarm mode
+    float errorRate;                        // Over all sensors' windows
+    uint16_t maxLatencyUs;
+    const char* backend;                    // OneWire backend ("gpio", "rmt")
+};
+
+/**
+ * Smoothing filter state, in fixed point (1/256 °C)
+ */
+struct SensorFilterState {
+    int32_t ema;                            // EMA output
+    int32_t window[5];                      // Recent readings for the median, ring buffer
+    uint8_t count;                          // Readings seen since reset (saturates at 5)
+    uint8_t pos;                            // Next window slot
+    
+    SensorFilterState() : ema(0), count(0), pos(0) {
+        memset(window, 0, sizeof(window));
+    }
+};
+
 /**
  * Runtime sensor data (not persisted)
  */
@@ -41,8 +121,9 @@ constexpr int16_t TEMP_HISTORY_INVALID = -32768;
 struct SensorData {
     DeviceAddress address;                  // Raw sensor address
     char addressStr[SENSOR_ADDR_STR_LEN];   // Address as hex string
-    float temperature;                       // Current calibrated temperature
-    float rawTemperature;                    // Raw temperature (before calibration)
+    float temperature;                       // Current calibrated, filtered temperature
+    float rawTemperature;                    // Raw temperature (before calibration and filtering)
+    float filteredTemperature;               // Raw temperature after smoothing (before calibration)
     int16_t history[TEMP_HISTORY_SIZE];      // Temperature history (temp*100), saves ~50% RAM
     uint16_t historyIndex;                   // Current position in history buffer
     uint16_t historyCount;                   // Number of valid history entries
@@ -50,20 +131,45 @@ struct SensorData {
     float lastHistoryTemp;                   // Last temperature stored in history
     AlarmState alarmState;                   // Current alarm state
     AlarmState prevAlarmState;               // Previous alarm state (for change detection)
+    bool ruleAlarm;                          // alarmState was raised by an alarm rule
+    AlarmState pendingAlarmState;            // Condition waiting out its entry/exit delay
+    uint32_t pendingSince;                   // When pendingAlarmState was first seen
+    bool alarmAcknowledged;                  // Current alarm acknowledged by the user
+    bool alarmLatched;                       // Condition cleared, alarm held until acknowledged
     bool connected;                          // Whether sensor is currently responding
     uint32_t errorCount;                     // Consecutive error count
+    SensorSource source;                     // Physical, virtual or pushed
+    uint8_t virtualSlot;                     // VirtualSensorDef slot (virtual only)
+    uint32_t pushedAt;                       // millis() of the last pushed reading (pushed only)
+    int8_t alarmHigh;                        // TH register as last programmed
+    int8_t alarmLow;                         // TL register as last programmed
+    bool alarmRegsValid;                     // alarmHigh/alarmLow match the device
+    SensorDiagnostics diag;                  // Read health (physical only)
+    SensorFilterState filter;                // Smoothing state (physical only)
     
     SensorData() : 
         temperature(TEMP_INVALID),
         rawTemperature(TEMP_INVALID),
+        filteredTemperature(TEMP_INVALID),
         historyIndex(0),
         historyCount(0),
         lastHistoryTime(0),
         lastHistoryTemp(TEMP_INVALID),
         alarmState(AlarmState::SENSOR_ERROR),
         prevAlarmState(AlarmState::SENSOR_ERROR),
+        ruleAlarm(false),
+        pendingAlarmState(AlarmState::SENSOR_ERROR),
+        pendingSince(0),
+        alarmAcknowledged(false),
+        alarmLatched(false),
         connected(false),
-        errorCount(0) {
+        errorCount(0),
+        source(SensorSource::PHYSICAL),
+        virtualSlot(0),
+        pushedAt(0),
+        alarmHigh(0),
+        alarmLow(0),
+        alarmRegsValid(false) {
         addressStr[0] = '\0';
         memset(address, 0, sizeof(address));
         for (uint16_t i = 0; i < TEMP_HISTORY_SIZE; i++) {
@@ -72,6 +178,20 @@ struct SensorData {
     }
 };
 
+// Bus needs parasite-power handling, which only a Read Power Supply at begin() detects
+constexpr uint8_t TOPOLOGY_FLAG_PARASITE = 0x01;
+
+/**
+ * Physical sensors found by the last bus search, in config order
+ * Persisted so the next boot can start conversions without a search
+ */
+struct SensorTopology {
+    uint8_t count;
+    uint8_t flags;                          // TOPOLOGY_FLAG_*
+    uint8_t reserved[2];
+    DeviceAddress addresses[MAX_SENSORS];
+};
+
 // ============================================================================
 // Callback Types
 // ============================================================================
@@ -115,12 +235,17 @@ public:
     
     /**
      * Initialize the sensor manager
-     * @return true if at least one sensor found
+     * Starts from the cached topology when there is one; the full bus
+     * search then runs from update() after the first reading
+     * @return true if at least one sensor found (or cached)
      */
     bool begin();
     
     /**
-     * Discover all connected sensors
+     * Discover all connected sensors (blocking full bus search, used at boot)
+     * Physical sensors are ordered by config slot, so indices stay stable
+     * across reboots; data of sensors that are still present is kept.
+     * At runtime use requestRescan(), which searches in the background.
      * @return Number of sensors found
      */
     uint8_t discoverSensors();
@@ -171,6 +296,46 @@ public:
      */
     static void addressToString(const DeviceAddress addr, char* buffer);
     
+    /**
+     * Build the synthetic address of a virtual sensor slot
+     * @param slot Virtual sensor slot
+     * @param addr Output address
+     */
+    static void virtualAddress(uint8_t slot, DeviceAddress addr);
+    
+    /**
+     * Check if a sensor is computed rather than measured
+     */
+    bool isVirtual(uint8_t index) const;
+    
+    /**
+     * Get the unit of a sensor's value ("°C"/"°F", or "kW" for heat flow)
+     */
+    const char* getUnit(uint8_t index) const;
+    
+    /**
+     * Get the probe type of a sensor ("ds18b20", "max31855", "virtual", "remote", ...)
+     */
+    const char* getSensorType(uint8_t index) const;
+    
+    /**
+     * Apply a reading pushed from outside the bus (e.g. a peer station)
+     * Unknown sensors are appended after every existing entry, so no
+     * other index moves, and get a regular sensor config
+     * @param addr Sensor address as reported by the source
+     * @param source Where the reading comes from (not PHYSICAL or VIRTUAL)
+     * @param temp Temperature in °C, TEMP_INVALID if the source reports an error
+     * @return Sensor index, -1 if the table is full
+     */
+    int8_t pushReading(const DeviceAddress addr, SensorSource source, float temp);
+    
+    /**
+     * Disconnect pushed sensors whose source has gone quiet
+     * @param source Pushed source to check
+     * @param timeoutMs Time since the last reading after which a sensor disconnects
+     */
+    void expirePushedSensors(SensorSource source, uint32_t timeoutMs);
+    
     /**
      * Perform calibration for all sensors
      * Sets calibration offsets so all sensors read the reference temperature
@@ -217,6 +382,12 @@ public:
      */
     void recalculateTemperature(uint8_t index);
     
+    /**
+     * Restart a sensor's smoothing filter (after a filter change)
+     * @param index Sensor index
+     */
+    void resetFilter(uint8_t index);
+    
     /**
      * Get average temperature across all connected sensors
      * @return Average temperature or TEMP_INVALID if no sensors connected
@@ -256,10 +427,37 @@ public:
     void setConnectionCallback(ConnectionCallback callback) { _connectionCallback = callback; }
     
     /**
-     * Force a sensor rescan on next update
+     * Start a background rescan on next update
+     * New sensors are added and missing ones marked disconnected without
+     * renumbering the others; readings continue during the search
      */
     void requestRescan() { _rescanRequested = true; }
     
+    /**
+     * Check if a background rescan is in progress
+     */
+    bool isDiscovering() const { return _discoveryActive; }
+    
+    /**
+     * Recompile alarm rules on next update
+     * Safe to call from async web handlers
+     */
+    void requestRuleReload() { _ruleReloadRequested = true; }
+    
+    /**
+     * Acknowledge an active alarm (applied on next update)
+     * A latched alarm whose condition has cleared returns to normal.
+     * Safe to call from async web handlers
+     * @param index Sensor index
+     * @return false if the sensor has no active alarm
+     */
+    bool acknowledgeAlarm(uint8_t index);
+    
+    /**
+     * Get alarm rule engine (compile status and active rules)
+     */
+    const AlarmRuleEngine& getRuleEngine() const { return _ruleEngine; }
+    
     /**
      * Check if sensor data has changed since last check
      * Clears the flag after returning true
@@ -271,22 +469,81 @@ public:
         return changed;
     }
     
+    /**
+     * Get the read generation counter
+     * Incremented after every completed read cycle; consumers compare it
+     * against the last value they handled instead of consuming a flag
+     */
+    uint32_t getReadGeneration() const { return _readGeneration; }
+    
+    /**
+     * Get ms since the last completed read cycle
+     * Only meaningful once getReadGeneration() is non-zero
+     */
+    uint32_t getSampleAgeMs() const { return millis() - _lastReadTime; }
+    
+    /**
+     * Estimate ms until the next read cycle completes
+     * From the read interval, the read state machine and the conversion time
+     * of the last cycle (0 while the values are being read)
+     */
+    uint32_t getNextReadingMs() const;
+    
+    /**
+     * Get number of scratchpad reads saved by hardware alarm mode
+     */
+    uint32_t getSkippedReads() const { return _skippedReads; }
+    
+    /**
+     * Get read health of the whole bus
+     */
+    BusDiagnostics getBusDiagnostics() const;
+    
 private:
-    OneWire _oneWire;
-    DallasTemperature _sensors;
+    Ds18x20Driver _ds18x20;
+    SpiMax31855Source _max31855Spi;
+    Max31855Driver _max31855;
+#if SIMULATE_SENSORS
+    SimulatedOneWireBus _simulatedBus;
+    Ds18x20Driver _simulatedOneWire;            // Real drivers over simulated transports
+    SimulatedMax31855Source _simulatedChips;
+    Max31855Driver _simulatedMax31855;
+#endif
+    SensorDriver* _drivers[4];                  // Drivers in use, in discovery order
+    uint8_t _driverCount;
     SensorData _sensorData[MAX_SENSORS];
     uint8_t _sensorCount;
     uint32_t _lastReadTime;
     uint32_t _lastDiscoveryTime;
     bool _rescanRequested;
+    bool _reconcilePending;                     // Started from cache, full search outstanding
+    bool _ruleReloadRequested;
+    SensorTopology _topology;                   // As last saved to NVS
+    
+    // Background discovery (one ROM search per step)
+    bool _discoveryActive;
+    uint8_t _discoveryDriver;                   // Driver being enumerated
+    uint8_t _discoveryCount;                    // Probes in _discoveryFound
+    uint8_t _discoveryRestarts;                 // Passes restarted after a bus error
+    DeviceAddress _discoveryFound[MAX_SENSORS];
+    AlarmRuleEngine _ruleEngine;
+    uint32_t _ackRequests;                      // Bit per sensor index (atomic access only)
     
     // Non-blocking temperature reading state
     SensorReadState _readState;
     uint32_t _conversionStartTime;
+    uint16_t _conversionTime;                   // Worst case over all drivers (ms)
     
     AlarmCallback _alarmCallback;
     ConnectionCallback _connectionCallback;
     bool _dataChanged;
+    uint32_t _readGeneration;
+    
+    // Hardware alarm mode
+    uint32_t _inputMask;                        // Sensors read by rules or virtual sensors
+    uint32_t _alarmCycle;
+    uint32_t _skippedReads;
+    uint32_t _conversionCount;
     
     /**
      * Check and update alarm states for all sensors
@@ -299,6 +556,156 @@ private:
      */
     void updateAlarmState(uint8_t index);
     
+    /**
+     * Apply acknowledgements queued by acknowledgeAlarm()
+     */
+    void processAcknowledgements();
+    
+    /**
+     * Enumerate the probes of all drivers, restarting a pass cut short by
+     * a bus error up to DISCOVERY_MAX_RESTARTS times
+     * @param found Destination for up to MAX_SENSORS addresses
+     * @param complete Set false if the last pass was still cut short
+     * @return Number of sensors found
+     */
+    uint8_t searchProbes(DeviceAddress* found, bool& complete);
+    
+    /**
+     * Ensure each address has a sensor config and sort by config slot
+     */
+    void orderByConfig(DeviceAddress* addresses, uint8_t count);
+    
+    /**
+     * Make the given addresses the physical sensor list
+     * Keeps the runtime data of sensors that stay, reports removed ones
+     * as disconnected and appends the virtual sensors after them
+     */
+    void applyTopology(const DeviceAddress* addresses, uint8_t count);
+    
+    /**
+     * Start the probe drivers (OneWire always; MAX31855 if chip selects
+     * are configured; both over simulated transports if built with
+     * SIMULATE_SENSORS)
+     */
+    void beginDrivers();
+    
+    /**
+     * Driver handling a probe address
+     * @return Driver or nullptr if none in use handles it
+     */
+    SensorDriver* driverFor(const DeviceAddress addr) const;
+    
+    /**
+     * Begin a background discovery pass
+     */
+    void startDiscovery();
+    
+    /**
+     * Run up to DISCOVERY_STEPS_PER_UPDATE enumeration steps of the current
+     * pass (one ROM search each on the OneWire bus)
+     */
+    void stepDiscovery();
+    
+    /**
+     * Merge a completed pass into the sensor table in place
+     * Known sensors keep their index; new ones are appended
+     */
+    void finishDiscovery();
+    
+    /**
+     * Batch-read a driver's sensors selected this cycle, with retries
+     * @param readMask Bit per sensor index
+     * @param budget Retries left this cycle (decremented)
+     */
+    void readDriverSensors(SensorDriver* driver, uint32_t readMask, uint8_t& budget);
+    
+    /**
+     * Read one sensor and record its read health
+     * @param temp Raw temperature (TEMP_INVALID unless OK)
+     */
+    SensorReadResult readSensor(uint8_t index, float& temp);
+    
+    /**
+     * Record the outcome of one read in the sensor's diagnostics
+     */
+    void recordRead(uint8_t index, SensorReadResult result, uint32_t latencyUs);
+    
+    /**
+     * Re-read a sensor after a transfer failure
+     * The conversion result stays in the probe, so a re-read needs no new
+     * conversion. Probes already marked disconnected get no retries.
+     * @param result Outcome of the first read
+     * @param budget Retries left this cycle (decremented)
+     * @return Raw temperature or TEMP_INVALID
+     */
+    float retryRead(uint8_t index, SensorReadResult result, uint8_t& budget);
+    
+    /**
+     * Take a read result into the sensor's state: error count, connection,
+     * filter, calibration, history and alarm registers
+     * @param temp Raw temperature or TEMP_INVALID
+     */
+    void applyReading(uint8_t index, float temp);
+    
+    /**
+     * Select the sensors to read this cycle
+     * Hardware alarm mode skips settled in-range sensors nothing depends
+     * on, except every inRangeReadEvery cycles
+     * @return Bit per sensor index
+     */
+    uint32_t selectSensorsToRead();
+    
+    /**
+     * Find sensors with the on-chip alarm flag set (one Alarm Search)
+     * @return Bit per sensor index
+     */
+    uint32_t searchAlarmedSensors();
+    
+    /**
+     * TH/TL a sensor's device should hold for its current configuration
+     * @return false if the sensor has no alarm registers
+     */
+    bool expectedAlarmRegisters(uint8_t index, int8_t& high, int8_t& low) const;
+    
+    /**
+     * Program TH/TL from the sensor's thresholds if they changed
+     */
+    void syncAlarmRegisters(uint8_t index);
+    
+    /**
+     * Mark a sensor disconnected and notify the callbacks
+     */
+    void markDisconnected(uint8_t index);
+    
+    /**
+     * Check if a sensor's readings are pushed rather than read or computed
+     */
+    static bool isPushed(const SensorData& sensor) {
+        return sensor.source != SensorSource::PHYSICAL && sensor.source != SensorSource::VIRTUAL;
+    }
+    
+    /**
+     * Load the cached topology from NVS
+     * @return true if a non-empty topology was loaded
+     */
+    bool loadTopology();
+    
+    /**
+     * Save the topology to NVS if it changed
+     */
+    void saveTopology(const DeviceAddress* addresses, uint8_t count);
+    
+    /**
+     * Store alarm states in RTC memory (survives resets, not power loss)
+     */
+    void persistAlarmStates();
+    
+    /**
+     * Restore alarm states saved before the last reset
+     * Called once after the first discovery
+     */
+    void restoreAlarmStates();
+    
     /**
      * Add temperature to history buffer
      * @param index Sensor index
@@ -313,6 +720,40 @@ private:
      * @return Calibrated temperature
      */
     float applyCalibration(uint8_t index, float rawTemp);
+    
+    /**
+     * Run a raw reading through the sensor's smoothing filter
+     * Works in 1/256 °C fixed point; DS18B20 steps (1/16 °C) are exact.
+     * @return Filtered raw temperature
+     */
+    float applyFilter(uint8_t index, float rawTemp);
+    
+    /**
+     * Append enabled virtual sensors that are not in the table yet
+     * Existing entries keep their index and history
+     */
+    void appendVirtualSensors();
+    
+    /**
+     * Compute all virtual sensors from the current calibrated readings
+     */
+    void evaluateVirtualSensors();
+    
+    /**
+     * Compute one virtual sensor value
+     * @return Value or TEMP_INVALID if required inputs are unavailable
+     */
+    float computeVirtual(const VirtualSensorDef& def);
+    
+    /**
+     * Point compiled rules at the current sensor indices
+     */
+    void bindRules();
+    
+    /**
+     * Run alarm rules over the current readings
+     */
+    void evaluateRules();
 };
 
 // Global sensor manager instance
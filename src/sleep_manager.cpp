@@ -0,0 +1,378 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sleep Manager Implementation
+ */
+
+#include "sleep_manager.h"
+#include <WiFi.h>
+#include <esp_sleep.h>
+#include "mqtt_client.h"
+#include "notification_manager.h"
+#include "ota_manager.h"
+#include "wifi_manager.h"
+
+// Global instance
+SleepManager sleepManager;
+
+namespace {
+
+constexpr uint32_t SLEEP_BUFFER_MAGIC = 0x534C5042; // 'SLPB'
+
+struct SleepBuffer {
+    uint32_t magic;
+    char columns[MAX_SENSORS][SENSOR_ADDR_STR_LEN];     // Sensor per column, empty = free
+    uint16_t head;                                      // Oldest sample
+    uint16_t count;
+    uint16_t wakesSinceFlush;
+    uint32_t alarmMask;                                 // Columns in alarm at the last wake
+    SleepStats stats;
+    SleepSample samples[SLEEP_BUFFER_SAMPLES];
+};
+
+// Kept through deep sleep, zeroed on power-on
+RTC_DATA_ATTR SleepBuffer rtcSleepBuffer;
+
+void ensureBuffer() {
+    if (rtcSleepBuffer.magic != SLEEP_BUFFER_MAGIC) {
+        memset(&rtcSleepBuffer, 0, sizeof(rtcSleepBuffer));
+        rtcSleepBuffer.magic = SLEEP_BUFFER_MAGIC;
+    }
+}
+
+void powerDownRadio() {
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+}
+
+} // namespace
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+SleepManager::SleepManager() :
+    _cycleStartMs(0),
+    _armedAtMs(0),
+    _armed(false) {
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+bool SleepManager::isBatteryWake() const {
+    return configManager.getPowerConfig().batteryMode &&
+           esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+}
+
+void SleepManager::runWakeCycles() {
+    ensureBuffer();
+    const PowerConfig& power = configManager.getPowerConfig();
+
+    for (;;) {
+        SleepBuffer& buf = rtcSleepBuffer;
+        buf.stats.wakeCount++;
+        buf.wakesSinceFlush++;
+
+        sensorManager.begin();
+        bool alarmChanged = sample();
+
+        // Alarms go out right away, regular samples every flushEvery wakes
+        if (alarmChanged || buf.wakesSinceFlush >= power.flushEvery) {
+            buf.wakesSinceFlush = 0;
+            if (flush()) {
+                buf.stats.flushCount++;
+            } else {
+                buf.stats.flushFailures++;
+            }
+        }
+
+        deepSleep();
+    }
+}
+
+void SleepManager::update() {
+    const PowerConfig& power = configManager.getPowerConfig();
+    if (!power.batteryMode) {
+        _armed = false;
+        return;
+    }
+
+    // The window runs from boot, or from when battery mode was switched on
+    if (!_armed) {
+        _armed = true;
+        _armedAtMs = millis();
+    }
+    if (millis() - _armedAtMs < SLEEP_CONFIG_WINDOW_MS) {
+        return;
+    }
+
+    // Never leave normal mode without a way to flush, or mid-update
+    if (!wifiManager.isConnected() || !mqttClient.isEnabled() || otaManager.isBusy()) {
+        return;
+    }
+
+    Serial.println(F("[Sleep] Configuration window over, entering battery mode"));
+    ensureBuffer();
+    mqttClient.disconnect();
+    powerDownRadio();
+
+    // The configuration window is not part of the duty cycle
+    _cycleStartMs = millis();
+    deepSleep();
+    runWakeCycles();
+}
+
+const SleepStats& SleepManager::getStats() const {
+    return rtcSleepBuffer.stats;
+}
+
+uint16_t SleepManager::getBufferedCount() const {
+    return rtcSleepBuffer.magic == SLEEP_BUFFER_MAGIC ? rtcSleepBuffer.count : 0;
+}
+
+float SleepManager::getDutyCycle() const {
+    const SleepStats& stats = rtcSleepBuffer.stats;
+    uint64_t total = stats.awakeTotalMs + stats.sleepTotalMs;
+    return total > 0 ? (float)((double)stats.awakeTotalMs / (double)total) : 0.0f;
+}
+
+// ============================================================================
+// Sampling
+// ============================================================================
+
+bool SleepManager::sample() {
+    SleepBuffer& buf = rtcSleepBuffer;
+
+    if (!readSensors()) {
+        Serial.println(F("[Sleep] Sensor read timed out"));
+    }
+
+    // Overwrite the oldest sample when the last flushes failed
+    uint16_t slot;
+    if (buf.count >= SLEEP_BUFFER_SAMPLES) {
+        slot = buf.head;
+        buf.head = (buf.head + 1) % SLEEP_BUFFER_SAMPLES;
+        buf.stats.droppedSamples++;
+    } else {
+        slot = (buf.head + buf.count) % SLEEP_BUFFER_SAMPLES;
+        buf.count++;
+    }
+
+    SleepSample& sample = buf.samples[slot];
+    time_t epoch = time(nullptr);
+    sample.timestamp = epoch >= MIN_VALID_EPOCH ? (uint32_t)epoch : 0;
+    for (uint8_t c = 0; c < MAX_SENSORS; c++) {
+        sample.values[c] = SLEEP_SAMPLE_INVALID;
+    }
+
+    uint32_t alarmMask = 0;
+    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        int8_t column = data ? columnFor(data->addressStr) : -1;
+        if (column < 0) {
+            continue;
+        }
+
+        if (data->connected && data->temperature != TEMP_INVALID) {
+            float centi = roundf(data->temperature * 100.0f);
+            if (centi > INT16_MAX) centi = INT16_MAX;
+            if (centi <= SLEEP_SAMPLE_INVALID) centi = SLEEP_SAMPLE_INVALID + 1;
+            sample.values[column] = (int16_t)centi;
+        }
+        if (data->alarmState != AlarmState::NORMAL) {
+            alarmMask |= 1UL << column;
+        }
+    }
+
+    bool changed = alarmMask != buf.alarmMask;
+    buf.alarmMask = alarmMask;
+
+    DEBUG_PRINTF("[Sleep] Wake %lu: %u samples buffered\n",
+        (unsigned long)buf.stats.wakeCount, buf.count);
+    return changed;
+}
+
+bool SleepManager::readSensors() {
+    uint32_t start = millis();
+    uint32_t generation = sensorManager.getReadGeneration();
+
+    // Make sure a conversion is running (begin() normally started one)
+    sensorManager.readTemperatures();
+
+    while (sensorManager.getReadGeneration() == generation) {
+        if (millis() - start >= SLEEP_READ_TIMEOUT_MS) {
+            return false;
+        }
+        delay(10);
+        sensorManager.update();
+    }
+    return true;
+}
+
+int8_t SleepManager::columnFor(const char* address) {
+    SleepBuffer& buf = rtcSleepBuffer;
+    int8_t freeColumn = -1;
+
+    for (uint8_t c = 0; c < MAX_SENSORS; c++) {
+        if (strcmp(buf.columns[c], address) == 0) {
+            return c;
+        }
+        if (freeColumn < 0 && buf.columns[c][0] == '\0') {
+            freeColumn = c;
+        }
+    }
+
+    if (freeColumn >= 0) {
+        strlcpy(buf.columns[freeColumn], address, SENSOR_ADDR_STR_LEN);
+    }
+    return freeColumn;
+}
+
+// ============================================================================
+// Flushing
+// ============================================================================
+
+bool SleepManager::flush() {
+    uint32_t start = millis();
+    SleepBuffer& buf = rtcSleepBuffer;
+
+    wifiManager.begin();
+    while (!wifiManager.isConnected() && millis() - start < SLEEP_FLUSH_TIMEOUT_MS) {
+        wifiManager.update();
+        delay(50);
+    }
+
+    bool delivered = false;
+    if (wifiManager.isConnected()) {
+        // Keep the RTC clock in sync for sample timestamps
+        configTime(configManager.getSystemConfig().utcOffset * 3600L, 0, NTP_SERVER);
+
+        mqttClient.begin();
+        if (mqttClient.connectNow()) {
+            mqttClient.publishTemperatures();
+            delivered = publishBuffer();
+            mqttClient.disconnect();
+        }
+
+        // Give queued webhook notifications a chance to go out
+        while (notificationManager.getQueuedCount() > 0 &&
+               millis() - start < SLEEP_FLUSH_TIMEOUT_MS) {
+            notificationManager.update();
+            delay(20);
+        }
+    }
+
+    powerDownRadio();
+    buf.stats.lastFlushMs = millis() - start;
+
+    if (delivered) {
+        // Free columns of sensors that are gone, now nothing refers to them
+        for (uint8_t c = 0; c < MAX_SENSORS; c++) {
+            if (buf.columns[c][0] != '\0' && sensorManager.getSensorIndexByAddress(buf.columns[c]) < 0) {
+                buf.columns[c][0] = '\0';
+                buf.alarmMask &= ~(1UL << c);
+            }
+        }
+    }
+
+    Serial.printf("[Sleep] Flush %s in %lums (%u samples left)\n",
+        delivered ? "done" : "failed", (unsigned long)buf.stats.lastFlushMs, buf.count);
+    return delivered;
+}
+
+bool SleepManager::publishBuffer() {
+    SleepBuffer& buf = rtcSleepBuffer;
+    const PowerConfig& power = configManager.getPowerConfig();
+    bool first = true;
+
+    uint8_t columns = 0;
+    for (uint8_t c = 0; c < MAX_SENSORS; c++) {
+        if (buf.columns[c][0] != '\0') {
+            columns = c + 1;
+        }
+    }
+
+    while (buf.count > 0) {
+        uint16_t n = buf.count < SLEEP_SAMPLES_PER_MESSAGE ? buf.count : SLEEP_SAMPLES_PER_MESSAGE;
+
+        // {"interval":300,"sensors":[..],"samples":[[ts,v0,v1,..],..]}
+        JsonDocument doc;
+        doc["interval"] = power.sleepInterval;
+        if (first) {
+            // Metrics of the wakes since the last flush ride along once
+            doc["wakes"] = buf.stats.wakeCount;
+            doc["awakeMs"] = buf.stats.lastAwakeMs;
+            doc["dutyCycle"] = round(getDutyCycle() * 100000.0) / 1000.0;  // percent
+            doc["dropped"] = buf.stats.droppedSamples;
+        }
+
+        JsonArray sensors = doc["sensors"].to<JsonArray>();
+        for (uint8_t c = 0; c < columns; c++) {
+            if (buf.columns[c][0] != '\0') {
+                sensors.add(buf.columns[c]);
+            } else {
+                sensors.add(nullptr);
+            }
+        }
+
+        JsonArray samples = doc["samples"].to<JsonArray>();
+        for (uint16_t k = 0; k < n; k++) {
+            const SleepSample& sample = buf.samples[(buf.head + k) % SLEEP_BUFFER_SAMPLES];
+            JsonArray row = samples.add<JsonArray>();
+            row.add(sample.timestamp);
+            for (uint8_t c = 0; c < columns; c++) {
+                if (sample.values[c] == SLEEP_SAMPLE_INVALID) {
+                    row.add(nullptr);
+                } else {
+                    row.add(sample.values[c] / 100.0);
+                }
+            }
+        }
+
+        char payload[896];
+        if (measureJson(doc) >= sizeof(payload)) {
+            Serial.println(F("[Sleep] Batch message too large"));
+            return false;
+        }
+        serializeJson(doc, payload, sizeof(payload));
+
+        if (!mqttClient.publishBatch(payload)) {
+            return false;
+        }
+
+        buf.head = (buf.head + n) % SLEEP_BUFFER_SAMPLES;
+        buf.count -= n;
+        first = false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Sleeping
+// ============================================================================
+
+void SleepManager::deepSleep() {
+    const PowerConfig& power = configManager.getPowerConfig();
+    SleepStats& stats = rtcSleepBuffer.stats;
+
+    // Time to sleep: wake (or boot) until now
+    uint32_t awake = millis() - _cycleStartMs;
+    uint32_t sleepMs = (uint32_t)power.sleepInterval * 1000UL;
+    stats.lastAwakeMs = awake;
+    stats.awakeTotalMs += awake;
+    stats.sleepTotalMs += sleepMs;
+
+    Serial.printf("[Sleep] Awake %lums, sleeping %us (duty cycle %.3f%%)\n",
+        (unsigned long)awake, power.sleepInterval, getDutyCycle() * 100.0f);
+    Serial.flush();
+
+#if SIMULATE_DEEP_SLEEP
+    delay(sleepMs);
+    _cycleStartMs = millis();
+#else
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+    esp_deep_sleep_start();
+#endif
+}
@@ -0,0 +1,146 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * Sleep Manager Header
+ *
+ * Battery mode for remote installations:
+ * - After power-on (or enabling the mode) the device runs normally for
+ *   SLEEP_CONFIG_WINDOW_MS, then enters a deep-sleep duty cycle
+ * - Each timer wake only reads the sensors and appends one sample to a
+ *   buffer in RTC memory (display, web server and OTA are never started)
+ * - WiFi comes up every N wakes, when the buffer is full or when an alarm
+ *   state changed, to flush the batch over MQTT
+ * - Time awake per wake and the overall duty cycle are measured and
+ *   published with each batch
+ *
+ * Build with -DSIMULATE_DEEP_SLEEP=1 to run the cycle with delay() instead
+ * of powering down.
+ */
+
+#ifndef SLEEP_MANAGER_H
+#define SLEEP_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+// ============================================================================
+// RTC Buffer
+// ============================================================================
+
+// Centidegree value of a sensor without a reading
+constexpr int16_t SLEEP_SAMPLE_INVALID = INT16_MIN;
+
+/**
+ * One wake's readings, indexed by buffer column (not sensor index,
+ * which can change between wakes)
+ */
+struct SleepSample {
+    uint32_t timestamp;                 // Unix time, 0 if clock not synchronised
+    int16_t values[MAX_SENSORS];        // Centidegrees per column
+};
+
+/**
+ * Duty-cycle metrics, kept across wakes
+ */
+struct SleepStats {
+    uint32_t wakeCount;
+    uint32_t flushCount;
+    uint32_t flushFailures;
+    uint32_t droppedSamples;            // Overwritten before they were flushed
+    uint32_t lastAwakeMs;               // Boot to sleep of the last wake
+    uint32_t lastFlushMs;               // WiFi + MQTT time of the last flush
+    uint64_t awakeTotalMs;
+    uint64_t sleepTotalMs;
+};
+
+// ============================================================================
+// SleepManager Class
+// ============================================================================
+
+class SleepManager {
+public:
+    /**
+     * Constructor
+     */
+    SleepManager();
+
+    /**
+     * Check if this boot is a battery-mode timer wake
+     * Requires the configuration to be loaded
+     */
+    bool isBatteryWake() const;
+
+    /**
+     * Run battery-mode wake cycles: sample, maybe flush, sleep
+     * Does not return
+     */
+    void runWakeCycles();
+
+    /**
+     * Update sleep manager (call in main loop)
+     * Enters battery mode once the configuration window has passed
+     */
+    void update();
+
+    /**
+     * Get duty-cycle metrics
+     */
+    const SleepStats& getStats() const;
+
+    /**
+     * Get number of samples waiting to be flushed
+     */
+    uint16_t getBufferedCount() const;
+
+    /**
+     * Fraction of time spent awake (0..1)
+     */
+    float getDutyCycle() const;
+
+private:
+    uint32_t _cycleStartMs;             // millis() at wake (0 = boot)
+    uint32_t _armedAtMs;                // When normal mode saw battery mode enabled
+    bool _armed;
+
+    /**
+     * Read all sensors and append one sample
+     * @return true if alarm states changed since the previous wake
+     */
+    bool sample();
+
+    /**
+     * Read one complete sensor cycle
+     * @return true if the read completed within SLEEP_READ_TIMEOUT_MS
+     */
+    bool readSensors();
+
+    /**
+     * Buffer column for a sensor address, claiming a free one if needed
+     * @return column or -1 if all columns are taken
+     */
+    int8_t columnFor(const char* address);
+
+    /**
+     * Bring up WiFi and MQTT, publish buffered samples, power WiFi down
+     * @return true if all samples were delivered
+     */
+    bool flush();
+
+    /**
+     * Publish buffered samples in chunks, removing each delivered chunk
+     * @return true if the buffer is empty afterwards
+     */
+    bool publishBuffer();
+
+    /**
+     * Record metrics and power down until the next wake
+     * Returns only when SIMULATE_DEEP_SLEEP is set
+     */
+    void deepSleep();
+};
+
+// Global sleep manager instance
+extern SleepManager sleepManager;
+
+#endif // SLEEP_MANAGER_H
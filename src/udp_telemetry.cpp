@@ -0,0 +1,206 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * UDP Telemetry Implementation
+ */
+
+#include "udp_telemetry.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <errno.h>
+#include "wifi_manager.h"
+
+// Global instance
+UdpTelemetry udpTelemetry;
+
+// ============================================================================
+// Datagram Parsing
+// ============================================================================
+
+bool parseUdpTelemetryHeader(const uint8_t* data, size_t len, UdpTelemetryHeader& header) {
+    if (len < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    return header.magic[0] == UDP_TELEMETRY_MAGIC_0 &&
+           header.magic[1] == UDP_TELEMETRY_MAGIC_1 &&
+           header.version == UDP_TELEMETRY_VERSION &&
+           len == sizeof(header) + header.count * sizeof(UdpTelemetryReading);
+}
+
+float readUdpTelemetryReading(const uint8_t* data, uint8_t index, UdpTelemetryReading& reading) {
+    memcpy(&reading, data + sizeof(UdpTelemetryHeader) + index * sizeof(reading), sizeof(reading));
+
+    if (!(reading.flags & UDP_READING_CONNECTED) || reading.value == UDP_TELEMETRY_VALUE_INVALID) {
+        return TEMP_INVALID;
+    }
+    return reading.value / 100.0f;
+}
+
+bool qualifyUdpTelemetryAddress(const uint8_t* deviceId, uint8_t* address) {
+    switch (address[0]) {
+        case VIRTUAL_SENSOR_FAMILY:
+            return false;
+
+        case FAMILY_MAX31855:
+            // Bytes 4-6 are zero in these addresses; the low half of the
+            // station MAC is enough to tell peers apart
+            memcpy(address + 4, deviceId + 3, 3);
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+UdpTelemetry::UdpTelemetry() :
+    _socket(-1),
+    _sequence(0),
+    _lastGeneration(0),
+    _sentCount(0),
+    _errorCount(0),
+    _destAddr(0),
+    _reconfigureRequested(false) {
+    memset(_deviceId, 0, sizeof(_deviceId));
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void UdpTelemetry::update() {
+    const UdpTelemetryConfig& config = configManager.getUdpTelemetryConfig();
+
+    // Handle reconfigure request from web handlers (thread-safe)
+    if (_reconfigureRequested) {
+        _reconfigureRequested = false;
+        closeSocket();
+    }
+
+    if (!config.enabled || !wifiManager.isConnected()) {
+        if (_socket >= 0) {
+            closeSocket();
+        }
+        return;
+    }
+
+    if (_socket < 0) {
+        if (!openSocket()) {
+            return;
+        }
+        // Skip the reading that was current when the socket opened
+        _lastGeneration = sensorManager.getReadGeneration();
+        return;
+    }
+
+    uint32_t generation = sensorManager.getReadGeneration();
+    if (generation == _lastGeneration) {
+        return;
+    }
+    _lastGeneration = generation;
+
+    sendReadings();
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+bool UdpTelemetry::openSocket() {
+    const UdpTelemetryConfig& config = configManager.getUdpTelemetryConfig();
+
+    IPAddress group;
+    if (!group.fromString(config.group) || group[0] < 224 || group[0] > 239) {
+        Serial.printf("[UDP] Invalid multicast group: %s\n", config.group);
+        return false;
+    }
+    _destAddr = (uint32_t)group;
+
+    _socket = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket < 0) {
+        Serial.println(F("[UDP] Failed to create socket"));
+        return false;
+    }
+
+    // Never block the main loop on a full send queue
+    int flags = lwip_fcntl(_socket, F_GETFL, 0);
+    lwip_fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
+
+    uint8_t ttl = config.ttl > 0 ? config.ttl : 1;
+    lwip_setsockopt(_socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+    WiFi.macAddress(_deviceId);
+
+    Serial.printf("[UDP] Telemetry to %s:%u (ttl %u)\n", config.group, config.port, ttl);
+    return true;
+}
+
+void UdpTelemetry::closeSocket() {
+    if (_socket >= 0) {
+        lwip_close(_socket);
+        _socket = -1;
+    }
+}
+
+void UdpTelemetry::sendReadings() {
+    uint8_t packet[UDP_TELEMETRY_MAX_SIZE];
+
+    UdpTelemetryHeader header;
+    header.magic[0] = UDP_TELEMETRY_MAGIC_0;
+    header.magic[1] = UDP_TELEMETRY_MAGIC_1;
+    header.version = UDP_TELEMETRY_VERSION;
+    header.count = 0;
+    memcpy(header.deviceId, _deviceId, sizeof(header.deviceId));
+    header.sequence = _sequence++;
+
+    size_t offset = sizeof(header);
+
+    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        if (!data || data->source == SensorSource::REMOTE) {
+            continue;       // Re-sending peer readings would echo them between hubs
+        }
+
+        UdpTelemetryReading reading;
+        memcpy(reading.address, data->address, sizeof(reading.address));
+        reading.value = UDP_TELEMETRY_VALUE_INVALID;
+        reading.alarm = (uint8_t)data->alarmState;
+        reading.flags = data->connected ? UDP_READING_CONNECTED : 0;
+
+        if (data->connected && data->temperature != TEMP_INVALID) {
+            // Clamp before converting: out of int16 range is undefined
+            float scaled = roundf(data->temperature * 100.0f);
+            if (scaled > UDP_TELEMETRY_VALUE_MAX || scaled < UDP_TELEMETRY_VALUE_MIN) {
+                scaled = scaled > 0 ? UDP_TELEMETRY_VALUE_MAX : UDP_TELEMETRY_VALUE_MIN;
+                reading.flags |= UDP_READING_CLAMPED;
+            }
+            reading.value = (int16_t)scaled;
+        }
+
+        memcpy(packet + offset, &reading, sizeof(reading));
+        offset += sizeof(reading);
+        header.count++;
+    }
+
+    memcpy(packet, &header, sizeof(header));
+
+    const UdpTelemetryConfig& config = configManager.getUdpTelemetryConfig();
+
+    struct sockaddr_in dest;
+    memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(config.port);
+    dest.sin_addr.s_addr = _destAddr;
+
+    int sent = lwip_sendto(_socket, packet, offset, 0, (struct sockaddr*)&dest, sizeof(dest));
+    if (sent == (int)offset) {
+        _sentCount++;
+    } else {
+        _errorCount++;
+        DEBUG_PRINTF("[UDP] Send failed (errno %d)\n", errno);
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * ESP32 Temperature Monitoring System
+ * UDP Telemetry Header
+ *
+ * Broadcasts a compact binary datagram to a multicast group after every
+ * completed sensor read cycle:
+ * - No per-client state on the device (any number of listeners)
+ * - Fixed-point readings, no JSON serialization
+ * - Sequence number so listeners can detect lost datagrams
+ */
+
+#ifndef UDP_TELEMETRY_H
+#define UDP_TELEMETRY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "config_manager.h"
+#include "sensor_manager.h"
+
+// ============================================================================
+// Datagram Format
+// ============================================================================
+
+// All multi-byte fields are little-endian (native ESP32 byte order)
+constexpr uint8_t UDP_TELEMETRY_MAGIC_0 = 'T';
+constexpr uint8_t UDP_TELEMETRY_MAGIC_1 = 'M';
+constexpr uint8_t UDP_TELEMETRY_VERSION = 1;
+
+// Reading value is scaled by 100 (e.g. 2150 = 21.50°C), so it covers
+// -327.67 to +327.67°C; readings beyond (thermocouples) are sent clamped
+// to the limit with UDP_READING_CLAMPED set
+constexpr int16_t UDP_TELEMETRY_VALUE_INVALID = -32768;
+constexpr int16_t UDP_TELEMETRY_VALUE_MAX = 32767;
+constexpr int16_t UDP_TELEMETRY_VALUE_MIN = -32767;
+
+// Reading flags
+constexpr uint8_t UDP_READING_CONNECTED = 0x01;
+constexpr uint8_t UDP_READING_CLAMPED = 0x02;
+
+struct __attribute__((packed)) UdpTelemetryHeader {
+    uint8_t magic[2];           // 'T', 'M'
+    uint8_t version;            // UDP_TELEMETRY_VERSION
+    uint8_t count;              // Number of readings that follow
+    uint8_t deviceId[6];        // Station MAC address
+    uint32_t sequence;          // Incremented for every datagram sent
+};
+
+struct __attribute__((packed)) UdpTelemetryReading {
+    uint8_t address[8];         // Sensor ROM address
+    int16_t value;              // Calibrated value * 100
+    uint8_t alarm;              // AlarmState as integer
+    uint8_t flags;              // UDP_READING_* bit flags
+};
+
+constexpr size_t UDP_TELEMETRY_MAX_SIZE =
+    sizeof(UdpTelemetryHeader) + MAX_SENSORS * sizeof(UdpTelemetryReading);
+
+/**
+ * Validate a received datagram (magic, version and length)
+ * @param data Datagram bytes
+ * @param len Datagram size
+ * @param header Output header
+ * @return true if well-formed
+ */
+bool parseUdpTelemetryHeader(const uint8_t* data, size_t len, UdpTelemetryHeader& header);
+
+/**
+ * Get one reading of a validated datagram
+ * @param data Datagram bytes
+ * @param index Reading index (0 to header.count-1)
+ * @param reading Output reading
+ * @return Temperature in °C (at the range limit if clamped), TEMP_INVALID
+ *         if the sensor reported an error
+ */
+float readUdpTelemetryReading(const uint8_t* data, uint8_t index, UdpTelemetryReading& reading);
+
+/**
+ * Make a received sensor address unique on the receiving station
+ * Synthetic MAX31855 addresses only number the chips of their own
+ * station, so the sender's device ID is folded into their unused bytes;
+ * ROM addresses (simulated ones too) are unique already.
+ * @return false for addresses that only exist on the sender (virtual sensors)
+ */
+bool qualifyUdpTelemetryAddress(const uint8_t* deviceId, uint8_t* address);
+
+// ============================================================================
+// UdpTelemetry Class
+// ============================================================================
+
+class UdpTelemetry {
+public:
+    /**
+     * Constructor
+     */
+    UdpTelemetry();
+
+    /**
+     * Update telemetry (call in main loop)
+     * Sends one datagram per completed read cycle while enabled and connected
+     */
+    void update();
+
+    /**
+     * Apply changed configuration on next update
+     * Safe to call from async web handlers
+     */
+    void reconfigure() { _reconfigureRequested = true; }
+
+    /**
+     * Check if the multicast socket is open
+     */
+    bool isActive() const { return _socket >= 0; }
+
+    /**
+     * Get number of datagrams sent
+     */
+    uint32_t getSentCount() const { return _sentCount; }
+
+    /**
+     * Get number of failed sends
+     */
+    uint32_t getErrorCount() const { return _errorCount; }
+
+private:
+    int _socket;
+    uint32_t _sequence;
+    uint32_t _lastGeneration;
+    uint32_t _sentCount;
+    uint32_t _errorCount;
+    uint32_t _destAddr;                 // Group address (network byte order)
+    uint8_t _deviceId[6];
+    volatile bool _reconfigureRequested;
+
+    /**
+     * Open the UDP socket for the configured group
+     * @return true if socket is ready
+     */
+    bool openSocket();
+
+    /**
+     * Close the UDP socket
+     */
+    void closeSocket();
+
+    /**
+     * Build and send the datagram for the current readings
+     */
+    void sendReadings();
+};
+
+// Global UDP telemetry instance
+extern UdpTelemetry udpTelemetry;
+
+#endif // UDP_TELEMETRY_H
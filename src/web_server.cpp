@@ -8,9 +8,19 @@
 #include <ArduinoJson.h>
 #include <SPIFFS.h>
 #include <Update.h>
+#include <memory>
 #include "wifi_manager.h"
 #include "mqtt_client.h"
 #include "ota_manager.h"
+#include "udp_telemetry.h"
+#include "hub_receiver.h"
+#include "sensor_ingest.h"
+#include "influx_exporter.h"
+#include "notification_manager.h"
+#include "coap_server.h"
+#include "mdns_advertiser.h"
+#include "boot_metrics.h"
+#include "gzip_encoder.h"
 
 // Global instance
 WebServer webServer;
@@ -26,7 +36,9 @@ WebServer::WebServer() :
     _server(WEB_SERVER_PORT),
     _ws("/ws"),
     _lastWsUpdate(0),
-    _otaMode(false) {
+    _otaMode(false),
+    _gzipStats(),
+    _longPollWaiters(0) {
 }
 
 // ============================================================================
@@ -167,6 +179,89 @@ void WebServer::setupRoutes() {
         }
     );
     
+    // Acknowledge sensor alarm
+    _server.on("^\\/api\\/sensors\\/(\\d+)\\/ack$", HTTP_POST,
+        [this](AsyncWebServerRequest* request) {
+            uint8_t idx = request->pathArg(0).toInt();
+            handleAcknowledgeAlarm(request, idx);
+        });
+    
+    // ========== Sensor Ingestion ==========
+    _server.on("/api/ingest", HTTP_POST,
+        [this](AsyncWebServerRequest* request) {
+            handleIngest(request);
+        },
+        nullptr,
+        [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            // Collect the body (freed with the request); oversized bodies are
+            // refused in handleIngest() without being buffered
+            if (total > INGEST_MAX_MESSAGE_SIZE) {
+                return;
+            }
+            if (index == 0) {
+                request->_tempObject = malloc(total);
+            }
+            if (request->_tempObject && index + len <= total) {
+                memcpy((uint8_t*)request->_tempObject + index, data, len);
+            }
+        });
+    
+    _server.on("/api/config/ingest", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetIngestConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* ingestConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/ingest",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateIngestConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(ingestConfigHandler);
+    
+    // ========== Virtual Sensors ==========
+    _server.on("/api/virtual", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetVirtualSensors(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* virtualHandler = new AsyncCallbackJsonWebHandler(
+        "/api/virtual",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateVirtualSensor(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(virtualHandler);
+    
+    _server.on("^\\/api\\/virtual\\/(\\d+)$", HTTP_DELETE,
+        [this](AsyncWebServerRequest* request) {
+            uint8_t slot = request->pathArg(0).toInt();
+            handleDeleteVirtualSensor(request, slot);
+        });
+    
+    // ========== Alarm Rules ==========
+    _server.on("/api/rules", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetAlarmRules(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* rulesHandler = new AsyncCallbackJsonWebHandler(
+        "/api/rules",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateAlarmRule(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(rulesHandler);
+    
+    _server.on("^\\/api\\/rules\\/(\\d+)$", HTTP_DELETE,
+        [this](AsyncWebServerRequest* request) {
+            uint8_t slot = request->pathArg(0).toInt();
+            handleDeleteAlarmRule(request, slot);
+        });
+    
     // ========== Configuration ==========
     _server.on("/api/config/wifi", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleGetWiFiConfig(request);
@@ -210,6 +305,115 @@ void WebServer::setupRoutes() {
     );
     _server.addHandler(sysConfigHandler);
     
+    _server.on("/api/config/udp", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetUdpConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* udpConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/udp",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateUdpConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(udpConfigHandler);
+    
+    _server.on("/api/config/hub", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetHubConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* hubConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/hub",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateHubConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(hubConfigHandler);
+    
+    _server.on("/api/config/coap", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetCoapConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* coapConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/coap",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateCoapConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(coapConfigHandler);
+    
+    _server.on("/api/config/influx", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetInfluxConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* influxConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/influx",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateInfluxConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(influxConfigHandler);
+    
+    _server.on("/api/config/power", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetPowerConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* powerConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/power",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdatePowerConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(powerConfigHandler);
+    
+    _server.on("/api/config/bus", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetBusConfig(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* busConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/bus",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateBusConfig(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(busConfigHandler);
+    
+    // ========== Webhook Notifications ==========
+    _server.on("/api/config/webhooks", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetWebhooks(request);
+    });
+    
+    AsyncCallbackJsonWebHandler* webhookConfigHandler = new AsyncCallbackJsonWebHandler(
+        "/api/config/webhooks",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleUpdateWebhook(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(webhookConfigHandler);
+    
+    AsyncCallbackJsonWebHandler* webhookTestHandler = new AsyncCallbackJsonWebHandler(
+        "/api/webhooks/test",
+        [this](AsyncWebServerRequest* request, JsonVariant& json) {
+            String jsonStr;
+            serializeJson(json, jsonStr);
+            handleTestWebhook(request, (uint8_t*)jsonStr.c_str(), jsonStr.length());
+        }
+    );
+    _server.addHandler(webhookTestHandler);
+    
     // ========== WiFi Scan ==========
     _server.on("/api/wifi/scan", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleWiFiScan(request);
@@ -282,6 +486,10 @@ void WebServer::setupRoutes() {
         handleRescan(request);
     });
     
+    _server.on("/api/diagnostics/bus", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleGetBusDiagnostics(request);
+    });
+    
     _server.on("/api/reboot", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleReboot(request);
     });
@@ -382,7 +590,22 @@ void WebServer::handleGetStatus(AsyncWebServerRequest* request) {
     if (!checkServerLoad(request)) return;
     
     JsonDocument doc;
+    buildStatusJson(doc);
+    
+    // Sized from the document: the status grows with every module
+    size_t bufferSize = measureJson(doc) + 1;
+    char* buffer = (char*)malloc(bufferSize);
+    if (!buffer) {
+        sendError(request, 500, "Out of memory");
+        return;
+    }
     
+    serializeJson(doc, buffer, bufferSize);
+    sendJson(request, 200, buffer);
+    free(buffer);
+}
+
+void WebServer::buildStatusJson(JsonDocument& doc) {
     // Device info
     doc["device"]["name"] = configManager.getSystemConfig().deviceName;
     doc["device"]["firmware"] = FIRMWARE_VERSION;
@@ -408,43 +631,312 @@ void WebServer::handleGetStatus(AsyncWebServerRequest* request) {
     doc["mqtt"]["connected"] = mqttClient.isConnected();
     doc["mqtt"]["publishCount"] = mqttClient.getPublishCount();
     
+    // UDP telemetry status
+    doc["udp"]["enabled"] = configManager.getUdpTelemetryConfig().enabled;
+    doc["udp"]["active"] = udpTelemetry.isActive();
+    doc["udp"]["sent"] = udpTelemetry.getSentCount();
+    doc["udp"]["errors"] = udpTelemetry.getErrorCount();
+    
+    // Hub mode status
+    doc["hub"]["enabled"] = configManager.getHubConfig().enabled;
+    doc["hub"]["active"] = hubReceiver.isActive();
+    doc["hub"]["peers"] = hubReceiver.getPeerCount();
+    doc["hub"]["datagrams"] = hubReceiver.getDatagramCount();
+    doc["hub"]["readings"] = hubReceiver.getReadingCount();
+    doc["hub"]["invalid"] = hubReceiver.getInvalidCount();
+    doc["hub"]["dropped"] = hubReceiver.getDroppedCount();
+    
+    // Sensor ingestion status
+    doc["ingest"]["enabled"] = configManager.getIngestConfig().enabled;
+    doc["ingest"]["messages"] = sensorIngest.getMessageCount();
+    doc["ingest"]["readings"] = sensorIngest.getReadingCount();
+    doc["ingest"]["rejected"] = sensorIngest.getRejectedCount();
+    doc["ingest"]["dropped"] = sensorIngest.getDroppedCount();
+    
+    // CoAP server status
+    doc["coap"]["enabled"] = configManager.getCoapConfig().enabled;
+    doc["coap"]["active"] = coapServer.isActive();
+    doc["coap"]["requests"] = coapServer.getRequestCount();
+    doc["coap"]["notifications"] = coapServer.getNotifyCount();
+    doc["coap"]["observers"] = coapServer.getObserverCount();
+    
+    // mDNS advertisement status
+    doc["mdns"]["active"] = mdnsAdvertiser.isActive();
+    doc["mdns"]["txtUpdates"] = mdnsAdvertiser.getTxtUpdateCount();
+    
+    // InfluxDB export status
+    doc["influx"]["enabled"] = configManager.getInfluxConfig().enabled;
+    doc["influx"]["batches"] = influxExporter.getBatchCount();
+    doc["influx"]["lines"] = influxExporter.getLineCount();
+    doc["influx"]["bytes"] = influxExporter.getBytesSent();
+    doc["influx"]["errors"] = influxExporter.getErrorCount();
+    doc["influx"]["dropped"] = influxExporter.getDroppedCount();
+    doc["influx"]["buffered"] = influxExporter.getBufferedBytes();
+    doc["influx"]["lastStatus"] = influxExporter.getLastStatus();
+    
+    // Webhook notification status
+    doc["notify"]["queued"] = notificationManager.getQueuedCount();
+    doc["notify"]["delivered"] = notificationManager.getDeliveredCount();
+    doc["notify"]["failed"] = notificationManager.getFailedCount();
+    doc["notify"]["dropped"] = notificationManager.getDroppedCount();
+    
+    // Boot stage timings (ms since start)
+    bootMetrics.toJson(doc["boot"].to<JsonObject>());
+    
+    // API response compression
+    doc["http"]["gzipResponses"] = _gzipStats.responses;
+    doc["http"]["gzipBytesIn"] = _gzipStats.bytesIn;
+    doc["http"]["gzipBytesOut"] = _gzipStats.bytesOut;
+    doc["http"]["gzipTimeUs"] = _gzipStats.timeUs;
+    
     // Sensor summary
     doc["sensors"]["count"] = sensorManager.getSensorCount();
     doc["sensors"]["alarms"] = sensorManager.getAlarmCount();
     doc["sensors"]["avgTemp"] = sensorManager.getAverageTemperature();
     doc["sensors"]["minTemp"] = sensorManager.getMinTemperature();
     doc["sensors"]["maxTemp"] = sensorManager.getMaxTemperature();
+    doc["sensors"]["generation"] = sensorManager.getReadGeneration();
+    if (sensorManager.getReadGeneration() > 0) {
+        doc["sensors"]["sampleAgeMs"] = sensorManager.getSampleAgeMs();
+    }
+    doc["sensors"]["nextReadingMs"] = sensorManager.getNextReadingMs();
+}
+
+// Names of the SensorField bits, in bit order
+static const char* const sensorFieldNames[SENSOR_FIELD_COUNT] = {
+    "address", "connected", "temperature", "rawTemperature", "alarm", "lastReadMs",
+    "virtual", "type", "acknowledged", "latched", "unit", "name", "calibrationOffset",
+    "thresholdLow", "thresholdHigh", "alertEnabled", "entryDelay", "exitDelay", "latch",
+    "filter", "filterAlpha"
+};
+
+bool parseSensorFields(const char* list, uint32_t& fields) {
+    fields = 0;
     
-    char buffer[512];
-    serializeJson(doc, buffer, sizeof(buffer));
-    sendJson(request, 200, buffer);
+    while (*list) {
+        const char* end = strchr(list, ',');
+        size_t len = end ? (size_t)(end - list) : strlen(list);
+        
+        if (len > 0 && !(len == 5 && strncmp(list, "index", 5) == 0)) {
+            uint8_t f = 0;
+            while (f < SENSOR_FIELD_COUNT &&
+                   !(strlen(sensorFieldNames[f]) == len && strncmp(list, sensorFieldNames[f], len) == 0)) {
+                f++;
+            }
+            if (f == SENSOR_FIELD_COUNT) {
+                return false;
+            }
+            fields |= 1UL << f;
+        }
+        
+        if (!end) {
+            break;
+        }
+        list = end + 1;
+    }
+    
+    return true;
+}
+
+bool WebServer::parseSensorQuery(AsyncWebServerRequest* request, SensorQuery& query) {
+    if (request->hasParam("fields")) {
+        if (!parseSensorFields(request->getParam("fields")->value().c_str(), query.fields)) {
+            sendError(request, 400, "Unknown field");
+            return false;
+        }
+    }
+    
+    if (request->hasParam("offset")) {
+        long offset = request->getParam("offset")->value().toInt();
+        if (offset < 0 || offset > MAX_SENSORS * 2) {
+            sendError(request, 400, "Invalid offset");
+            return false;
+        }
+        query.offset = (uint8_t)offset;
+    }
+    
+    if (request->hasParam("limit")) {
+        long limit = request->getParam("limit")->value().toInt();
+        if (limit < 1 || limit > MAX_SENSORS * 2) {
+            sendError(request, 400, "Invalid limit");
+            return false;
+        }
+        query.limit = (uint8_t)limit;
+    }
+    
+    return true;
 }
 
 void WebServer::handleGetSensors(AsyncWebServerRequest* request) {
     if (!checkServerLoad(request)) return;
     
-    JsonDocument doc;
-    JsonArray sensors = doc.to<JsonArray>();
+    SensorQuery query;
+    if (!parseSensorQuery(request, query)) return;
     
-    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
-        JsonObject obj = sensors.add<JsonObject>();
-        buildSensorJson(obj, i);
+    if (request->hasParam("since")) {
+        uint32_t since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+        long wait = request->hasParam("wait") ? request->getParam("wait")->value().toInt() : LONGPOLL_MAX_WAIT_S;
+        if (wait < 0) {
+            wait = 0;
+        } else if (wait > LONGPOLL_MAX_WAIT_S) {
+            wait = LONGPOLL_MAX_WAIT_S;
+        }
+        handleLongPollSensors(request, query, since, (uint16_t)wait);
+        return;
     }
     
-    // Use heap allocation for large response (10 sensors × ~280 bytes = ~2800 bytes)
-    size_t bufferSize = 512 + (sensorManager.getSensorCount() * 300);  // Dynamic sizing
-    char* buffer = (char*)malloc(bufferSize);
+    size_t len;
+    char* buffer = buildSensorsBody(false, query, len);
     if (!buffer) {
         sendError(request, 500, "Out of memory");
         return;
     }
     
-    size_t len = serializeJson(doc, buffer, bufferSize - 1);
-    buffer[len] = '\0';
-    sendJson(request, 200, buffer);
+    AsyncWebServerResponse* response = beginJsonResponse(request, 200, buffer);
+    addReadingHeaders(response);
+    
+    // The body stays a plain array: paging clients get the total here
+    char total[4];
+    snprintf(total, sizeof(total), "%u", sensorManager.getSensorCount());
+    response->addHeader("X-Total-Count", total);
+    request->send(response);
     free(buffer);
 }
 
+void WebServer::addReadingHeaders(AsyncWebServerResponse* response) {
+    char value[12];
+    
+    uint32_t generation = sensorManager.getReadGeneration();
+    snprintf(value, sizeof(value), "%lu", (unsigned long)generation);
+    response->addHeader("X-Read-Generation", value);
+    
+    if (generation > 0) {
+        snprintf(value, sizeof(value), "%lu", (unsigned long)sensorManager.getSampleAgeMs());
+        response->addHeader("X-Sample-Age", value);
+    }
+    
+    snprintf(value, sizeof(value), "%lu", (unsigned long)sensorManager.getNextReadingMs());
+    response->addHeader("X-Next-Reading", value);
+}
+
+/**
+ * State of one held long-poll request, owned by its response filler
+ */
+struct LongPollState {
+    SensorQuery query;
+    uint32_t since;
+    uint32_t deadline;                  // millis() when it answers regardless
+    char* body;                         // Built once the answer is due
+    size_t len;
+    uint8_t* waiters;
+    
+    ~LongPollState() {
+        free(body);
+        (*waiters)--;
+    }
+};
+
+void WebServer::handleLongPollSensors(AsyncWebServerRequest* request, const SensorQuery& query,
+                                      uint32_t since, uint16_t waitS) {
+    // Newer data already there, or no room to hold another request:
+    // answer right away
+    if (sensorManager.getReadGeneration() != since || waitS == 0 ||
+        _longPollWaiters >= LONGPOLL_MAX_WAITERS) {
+        size_t len;
+        char* buffer = buildSensorsBody(true, query, len);
+        if (!buffer) {
+            sendError(request, 500, "Out of memory");
+            return;
+        }
+        sendJson(request, 200, buffer);
+        free(buffer);
+        return;
+    }
+    
+    _longPollWaiters++;
+    std::shared_ptr<LongPollState> state(new LongPollState());
+    state->query = query;
+    state->since = since;
+    state->deadline = millis() + waitS * 1000UL;
+    state->body = nullptr;
+    state->len = 0;
+    state->waiters = &_longPollWaiters;
+    
+    // The filler runs on the AsyncTCP task on every ack and poll (about
+    // every 500 ms); RESPONSE_TRY_AGAIN keeps the request open until the
+    // next reading cycle completes
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+        [this, state](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (!state->body) {
+                if (sensorManager.getReadGeneration() == state->since &&
+                    (int32_t)(millis() - state->deadline) < 0) {
+                    return RESPONSE_TRY_AGAIN;
+                }
+                state->body = buildSensorsBody(true, state->query, state->len);
+                if (!state->body) {
+                    return 0;   // Out of memory: end with an empty body
+                }
+            }
+            
+            if (index >= state->len) {
+                return 0;
+            }
+            size_t chunk = state->len - index;
+            if (chunk > maxLen) {
+                chunk = maxLen;
+            }
+            memcpy(buffer, state->body + index, chunk);
+            return chunk;
+        });
+    
+    response->addHeader("Connection", "close");
+    
+    // The connection is silent while held: keep AsyncTCP from timing it out
+    if (request->client()) {
+        request->client()->setRxTimeout(waitS + LONGPOLL_RX_MARGIN_S);
+    }
+    request->send(response);
+}
+
+char* WebServer::buildSensorsBody(bool generation, const SensorQuery& query, size_t& len) {
+    JsonDocument doc;
+    JsonArray sensors;
+    
+    uint8_t count = sensorManager.getSensorCount();
+    uint8_t first = query.offset < count ? query.offset : count;
+    uint8_t last = count;
+    if (query.limit > 0 && first + query.limit < count) {
+        last = first + query.limit;
+    }
+    
+    if (generation) {
+        doc["generation"] = sensorManager.getReadGeneration();
+        doc["total"] = count;
+        if (sensorManager.getReadGeneration() > 0) {
+            doc["sampleAgeMs"] = sensorManager.getSampleAgeMs();
+        }
+        doc["nextReadingMs"] = sensorManager.getNextReadingMs();
+        sensors = doc["sensors"].to<JsonArray>();
+    } else {
+        sensors = doc.to<JsonArray>();
+    }
+    
+    for (uint8_t i = first; i < last; i++) {
+        JsonObject obj = sensors.add<JsonObject>();
+        buildSensorJson(obj, i, query.fields);
+    }
+    
+    // Sized from the document: names, fields and history vary per sensor
+    size_t bufferSize = measureJson(doc) + 1;
+    char* buffer = (char*)malloc(bufferSize);
+    if (!buffer) {
+        return nullptr;
+    }
+    
+    len = serializeJson(doc, buffer, bufferSize);
+    return buffer;
+}
+
 void WebServer::handleGetSensor(AsyncWebServerRequest* request, uint8_t sensorIndex) {
     if (!checkServerLoad(request)) return;
     
@@ -453,13 +945,23 @@ void WebServer::handleGetSensor(AsyncWebServerRequest* request, uint8_t sensorIn
         return;
     }
     
+    SensorQuery query;
+    if (!parseSensorQuery(request, query)) return;
+    
     JsonDocument doc;
     JsonObject obj = doc.to<JsonObject>();
-    buildSensorJson(obj, sensorIndex);
+    buildSensorJson(obj, sensorIndex, query.fields);
     
-    char buffer[512];
-    serializeJson(doc, buffer, sizeof(buffer));
+    size_t bufferSize = measureJson(doc) + 1;
+    char* buffer = (char*)malloc(bufferSize);
+    if (!buffer) {
+        sendError(request, 500, "Out of memory");
+        return;
+    }
+    
+    serializeJson(doc, buffer, bufferSize);
     sendJson(request, 200, buffer);
+    free(buffer);
 }
 
 void WebServer::handleUpdateSensor(AsyncWebServerRequest* request, uint8_t sensorIndex,
@@ -477,72 +979,942 @@ void WebServer::handleUpdateSensor(AsyncWebServerRequest* request, uint8_t senso
         return;
     }
     
-    const SensorData* sensorData = sensorManager.getSensorData(sensorIndex);
-    SensorConfig* config = configManager.getSensorConfigByAddress(sensorData->addressStr);
+    const SensorData* sensorData = sensorManager.getSensorData(sensorIndex);
+    SensorConfig* config = configManager.getSensorConfigByAddress(sensorData->addressStr);
+    
+    if (!config) {
+        sendError(request, 500, "Sensor config not found");
+        return;
+    }
+    
+    // Update fields
+    if (doc["name"].is<JsonVariant>()) {
+        strncpy(config->name, doc["name"] | "", SENSOR_NAME_MAX_LEN - 1);
+        config->name[SENSOR_NAME_MAX_LEN - 1] = '\0';
+    }
+    if (doc["thresholdLow"].is<JsonVariant>()) {
+        config->thresholdLow = doc["thresholdLow"];
+    }
+    if (doc["thresholdHigh"].is<JsonVariant>()) {
+        config->thresholdHigh = doc["thresholdHigh"];
+    }
+    if (doc["alertEnabled"].is<JsonVariant>()) {
+        config->alertEnabled = doc["alertEnabled"];
+    }
+    
+    SensorAlarmConfig* alarmConfig = configManager.getSensorAlarmConfig(sensorData->addressStr);
+    if (alarmConfig) {
+        if (doc["entryDelay"].is<JsonVariant>() || doc["exitDelay"].is<JsonVariant>()) {
+            uint32_t entryDelay = doc["entryDelay"] | (uint32_t)alarmConfig->entryDelay;
+            uint32_t exitDelay = doc["exitDelay"] | (uint32_t)alarmConfig->exitDelay;
+            if (entryDelay > ALARM_DELAY_MAX || exitDelay > ALARM_DELAY_MAX) {
+                sendError(request, 400, "Alarm delay out of range");
+                return;
+            }
+            alarmConfig->entryDelay = entryDelay;
+            alarmConfig->exitDelay = exitDelay;
+        }
+        if (doc["latch"].is<JsonVariant>()) {
+            alarmConfig->latch = doc["latch"];
+        }
+    }
+    
+    SensorFilterConfig* filterConfig = configManager.getSensorFilterConfig(sensorData->addressStr);
+    if (filterConfig && (doc["filter"].is<JsonVariant>() || doc["filterAlpha"].is<JsonVariant>())) {
+        SensorFilterType type = filterConfig->type;
+        if (doc["filter"].is<JsonVariant>() && !sensorFilterTypeFromString(doc["filter"] | "", type)) {
+            sendError(request, 400, "Unknown filter");
+            return;
+        }
+        uint32_t alpha = doc["filterAlpha"] | (uint32_t)filterConfig->alpha;
+        if (alpha < 1 || alpha > 255) {
+            sendError(request, 400, "filterAlpha must be 1-255");
+            return;
+        }
+        filterConfig->type = type;
+        filterConfig->alpha = alpha;
+        sensorManager.resetFilter(sensorIndex);
+    }
+    if (doc["calibrationOffset"].is<JsonVariant>()) {
+        config->calibrationOffset = doc["calibrationOffset"];
+        
+        // Immediately recalculate temperature with new offset
+        sensorManager.recalculateTemperature(sensorIndex);
+        Serial.printf("[WebServer] Updated calibration offset for sensor %d: %.2f\n", 
+            sensorIndex, config->calibrationOffset);
+    }
+    
+    configManager.markDirty();
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    // Republish Home Assistant discovery if MQTT is enabled and connected
+    // This updates the sensor name in Home Assistant immediately
+    if (mqttClient.isEnabled() && mqttClient.isConnected()) {
+        mqttClient.publishHADiscovery();
+        Serial.printf("[WebServer] Republished HA discovery for sensor %d after config update\n", sensorIndex);
+    }
+    
+    sendSuccess(request, "Sensor updated");
+}
+
+void WebServer::handleAcknowledgeAlarm(AsyncWebServerRequest* request, uint8_t sensorIndex) {
+    if (sensorIndex >= sensorManager.getSensorCount()) {
+        sendError(request, 404, "Sensor not found");
+        return;
+    }
+    
+    if (!sensorManager.acknowledgeAlarm(sensorIndex)) {
+        sendError(request, 409, "No active alarm");
+        return;
+    }
+    
+    sendSuccess(request, "Alarm acknowledged");
+}
+
+void WebServer::handleIngest(AsyncWebServerRequest* request) {
+    size_t len = request->contentLength();
+    if (len > INGEST_MAX_MESSAGE_SIZE) {
+        sendError(request, 413, "Message too large");
+        return;
+    }
+    
+    const uint8_t* body = (const uint8_t*)request->_tempObject;
+    if (!body || len == 0) {
+        sendError(request, 400, "Empty body");
+        return;
+    }
+    
+    uint8_t accepted;
+    switch (sensorIngest.submit(body, len, accepted)) {
+        case IngestStatus::OK: {
+            // Applied by the main loop within one iteration
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "{\"accepted\":%u}", accepted);
+            sendJson(request, 202, buffer);
+            break;
+        }
+        case IngestStatus::DISABLED:
+            sendError(request, 403, "Ingestion disabled");
+            break;
+        case IngestStatus::TOO_LARGE:
+            sendError(request, 413, "Too many readings");
+            break;
+        case IngestStatus::BUSY:
+            sendError(request, 503, "Ingestion queue full");
+            break;
+        default:
+            sendError(request, 400, "Invalid message");
+            break;
+    }
+}
+
+void WebServer::handleGetVirtualSensors(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    JsonArray arr = doc["virtual"].to<JsonArray>();
+    
+    for (uint8_t slot = 0; slot < MAX_VIRTUAL_SENSORS; slot++) {
+        const VirtualSensorDef* def = configManager.getVirtualSensorDef(slot);
+        if (!def || (!def->enabled && def->inputCount == 0)) {
+            continue;
+        }
+        
+        char address[SENSOR_ADDR_STR_LEN];
+        DeviceAddress addr;
+        SensorManager::virtualAddress(slot, addr);
+        SensorManager::addressToString(addr, address);
+        
+        const SensorConfig* config = configManager.getSensorConfigByAddress(address);
+        
+        JsonObject obj = arr.add<JsonObject>();
+        obj["slot"] = slot;
+        obj["address"] = address;
+        obj["name"] = config ? config->name : "";
+        obj["enabled"] = def->enabled;
+        obj["op"] = virtualSensorOpToString(def->op);
+        JsonArray inputs = obj["inputs"].to<JsonArray>();
+        for (uint8_t k = 0; k < def->inputCount; k++) {
+            inputs.add(def->inputs[k]);
+        }
+        obj["flowRate"] = def->flowRate;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    sendJson(request, 200, response.c_str());
+}
+
+void WebServer::handleUpdateVirtualSensor(AsyncWebServerRequest* request,
+                                           uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    // Explicit slot updates in place, otherwise take the first free one
+    // (a disabled sensor still owns its slot, as in the GET list)
+    uint8_t slot = doc["slot"] | 255;
+    if (slot == 255) {
+        for (uint8_t i = 0; i < MAX_VIRTUAL_SENSORS; i++) {
+            const VirtualSensorDef* def = configManager.getVirtualSensorDef(i);
+            if (def && def->inputCount == 0) {
+                slot = i;
+                break;
+            }
+        }
+    }
+    if (slot >= MAX_VIRTUAL_SENSORS) {
+        sendError(request, 400, "No free virtual sensor slot");
+        return;
+    }
+    
+    VirtualSensorDef def;
+    if (!virtualSensorOpFromString(doc["op"] | "", def.op)) {
+        sendError(request, 400, "Invalid op");
+        return;
+    }
+    
+    char ownAddress[SENSOR_ADDR_STR_LEN];
+    DeviceAddress addr;
+    SensorManager::virtualAddress(slot, addr);
+    SensorManager::addressToString(addr, ownAddress);
+    
+    JsonArrayConst inputs = doc["inputs"].as<JsonArrayConst>();
+    for (JsonVariantConst input : inputs) {
+        const char* address = input | "";
+        if (def.inputCount >= VIRTUAL_SENSOR_MAX_INPUTS) {
+            sendError(request, 400, "Too many inputs");
+            return;
+        }
+        if (strcmp(address, ownAddress) == 0 ||
+            !configManager.getSensorConfigByAddress(address)) {
+            sendError(request, 400, "Unknown input sensor");
+            return;
+        }
+        strncpy(def.inputs[def.inputCount], address, SENSOR_ADDR_STR_LEN - 1);
+        def.inputs[def.inputCount][SENSOR_ADDR_STR_LEN - 1] = '\0';
+        def.inputCount++;
+    }
+    
+    bool pairOp = def.op == VirtualSensorOp::DIFF || def.op == VirtualSensorOp::HEAT_FLOW;
+    if ((pairOp && def.inputCount != 2) || def.inputCount == 0) {
+        sendError(request, 400, "Wrong number of inputs");
+        return;
+    }
+    
+    if (def.op == VirtualSensorOp::HEAT_FLOW) {
+        def.flowRate = doc["flowRate"] | 0.0f;
+        if (def.flowRate <= 0.0f) {
+            sendError(request, 400, "Invalid flowRate");
+            return;
+        }
+    }
+    def.enabled = doc["enabled"] | true;
+    
+    *configManager.getVirtualSensorDef(slot) = def;
+    
+    // Name and thresholds live in the regular sensor config
+    SensorConfig* config = configManager.findOrCreateSensorConfig(ownAddress);
+    if (config && doc["name"].is<const char*>()) {
+        strncpy(config->name, doc["name"] | "", SENSOR_NAME_MAX_LEN - 1);
+        config->name[SENSOR_NAME_MAX_LEN - 1] = '\0';
+    }
+    
+    configManager.markDirty();
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    // Sensor table is rebuilt on the next discovery pass
+    sensorManager.requestRescan();
+    
+    JsonDocument response;
+    response["success"] = true;
+    response["slot"] = slot;
+    response["address"] = ownAddress;
+    
+    char buffer[128];
+    serializeJson(response, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleDeleteVirtualSensor(AsyncWebServerRequest* request, uint8_t slot) {
+    VirtualSensorDef* def = configManager.getVirtualSensorDef(slot);
+    if (!def) {
+        sendError(request, 404, "Virtual sensor not found");
+        return;
+    }
+    
+    char address[SENSOR_ADDR_STR_LEN];
+    DeviceAddress addr;
+    SensorManager::virtualAddress(slot, addr);
+    SensorManager::addressToString(addr, address);
+    
+    *def = VirtualSensorDef();
+    configManager.removeSensorConfig(address);
+    
+    configManager.markDirty();
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sensorManager.requestRescan();
+    sendSuccess(request, "Virtual sensor removed");
+}
+
+void WebServer::handleGetAlarmRules(AsyncWebServerRequest* request) {
+    const AlarmRuleEngine& engine = sensorManager.getRuleEngine();
+    
+    JsonDocument doc;
+    JsonArray arr = doc["rules"].to<JsonArray>();
+    
+    for (uint8_t slot = 0; slot < MAX_ALARM_RULES; slot++) {
+        const AlarmRuleDef* def = configManager.getAlarmRuleDef(slot);
+        if (!def || def->expression[0] == '\0') {
+            continue;
+        }
+        
+        JsonObject obj = arr.add<JsonObject>();
+        obj["slot"] = slot;
+        obj["name"] = def->name;
+        obj["enabled"] = def->enabled;
+        obj["target"] = def->target;
+        obj["severity"] = alarmRuleSeverityToString(def->severity);
+        obj["expression"] = def->expression;
+        obj["valid"] = engine.isValid(slot);
+        obj["active"] = engine.isActive(slot);
+        if (def->enabled && !engine.isValid(slot)) {
+            obj["error"] = engine.getError(slot);
+        }
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    sendJson(request, 200, response.c_str());
+}
+
+void WebServer::handleUpdateAlarmRule(AsyncWebServerRequest* request,
+                                       uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    // Explicit slot updates in place, otherwise take the first unused one
+    uint8_t slot = doc["slot"] | 255;
+    if (slot == 255) {
+        for (uint8_t i = 0; i < MAX_ALARM_RULES; i++) {
+            const AlarmRuleDef* def = configManager.getAlarmRuleDef(i);
+            if (def && def->expression[0] == '\0') {
+                slot = i;
+                break;
+            }
+        }
+    }
+    if (slot >= MAX_ALARM_RULES) {
+        sendError(request, 400, "No free rule slot");
+        return;
+    }
+    
+    AlarmRuleDef def;
+    def.enabled = doc["enabled"] | true;
+    if (!alarmRuleSeverityFromString(doc["severity"] | "high", def.severity)) {
+        sendError(request, 400, "Invalid severity");
+        return;
+    }
+    
+    const char* target = doc["target"] | "";
+    if (!configManager.getSensorConfigByAddress(target)) {
+        sendError(request, 400, "Unknown target sensor");
+        return;
+    }
+    
+    const char* expression = doc["expression"] | "";
+    if (strlen(expression) >= ALARM_RULE_EXPR_MAX_LEN) {
+        sendError(request, 400, "Expression too long");
+        return;
+    }
+    
+    strlcpy(def.name, doc["name"] | "", ALARM_RULE_NAME_MAX_LEN);
+    strlcpy(def.target, target, SENSOR_ADDR_STR_LEN);
+    strlcpy(def.expression, expression, ALARM_RULE_EXPR_MAX_LEN);
+    
+    // Reject rules that would not compile instead of storing them
+    CompiledAlarmRule compiled;
+    char compileError[48];
+    if (!AlarmRuleEngine::compile(def, compiled, compileError, sizeof(compileError))) {
+        sendError(request, 400, compileError);
+        return;
+    }
+    
+    *configManager.getAlarmRuleDef(slot) = def;
+    
+    configManager.markDirty();
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    // Recompiled and bound in the main loop
+    sensorManager.requestRuleReload();
+    
+    JsonDocument response;
+    response["success"] = true;
+    response["slot"] = slot;
+    response["codeLength"] = compiled.codeLength;
+    
+    char buffer[96];
+    serializeJson(response, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleDeleteAlarmRule(AsyncWebServerRequest* request, uint8_t slot) {
+    AlarmRuleDef* def = configManager.getAlarmRuleDef(slot);
+    if (!def) {
+        sendError(request, 404, "Rule not found");
+        return;
+    }
+    
+    *def = AlarmRuleDef();
+    
+    configManager.markDirty();
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sensorManager.requestRuleReload();
+    sendSuccess(request, "Rule removed");
+}
+
+void WebServer::handleGetWiFiConfig(AsyncWebServerRequest* request) {
+    const WiFiConfig& config = configManager.getWiFiConfig();
+    
+    JsonDocument doc;
+    doc["ssid"] = config.ssid;
+    doc["password"] = ""; // Don't expose password
+    doc["dhcp"] = config.dhcp;
+    doc["staticIP"] = config.staticIP;
+    doc["gateway"] = config.gateway;
+    doc["subnet"] = config.subnet;
+    doc["dns"] = config.dns;
+    
+    char buffer[256];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateWiFiConfig(AsyncWebServerRequest* request,
+                                        uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    WiFiConfig& config = configManager.getWiFiConfig();
+    
+    if (doc["ssid"].is<JsonVariant>()) {
+        strncpy(config.ssid, doc["ssid"] | "", 32);
+        config.ssid[32] = '\0';
+    }
+    if (doc["password"].is<JsonVariant>() && strlen(doc["password"] | "") > 0) {
+        strncpy(config.password, doc["password"] | "", 64);
+        config.password[64] = '\0';
+    }
+    if (doc["dhcp"].is<JsonVariant>()) {
+        config.dhcp = doc["dhcp"];
+    }
+    if (doc["staticIP"].is<JsonVariant>()) {
+        strncpy(config.staticIP, doc["staticIP"] | "", 15);
+        config.staticIP[15] = '\0';
+    }
+    if (doc["gateway"].is<JsonVariant>()) {
+        strncpy(config.gateway, doc["gateway"] | "", 15);
+        config.gateway[15] = '\0';
+    }
+    if (doc["subnet"].is<JsonVariant>()) {
+        strncpy(config.subnet, doc["subnet"] | "", 15);
+        config.subnet[15] = '\0';
+    }
+    if (doc["dns"].is<JsonVariant>()) {
+        strncpy(config.dns, doc["dns"] | "", 15);
+        config.dns[15] = '\0';
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    // Send response before triggering reconnect
+    sendSuccess(request, "WiFi configuration updated. Reconnecting...");
+    
+    // Request reconnection (handled safely in main loop)
+    wifiManager.reconnect();
+}
+
+void WebServer::handleGetMQTTConfig(AsyncWebServerRequest* request) {
+    const MQTTConfig& config = configManager.getMQTTConfig();
+    
+    JsonDocument doc;
+    doc["server"] = config.server;
+    doc["port"] = config.port;
+    doc["username"] = config.username;
+    doc["password"] = ""; // Don't expose password
+    doc["topicPrefix"] = config.topicPrefix;
+    doc["enabled"] = config.enabled;
+    doc["publishOnChange"] = config.publishOnChange;
+    doc["publishThreshold"] = config.publishThreshold;
+    doc["publishInterval"] = config.publishInterval;
+    
+    char buffer[256];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateMQTTConfig(AsyncWebServerRequest* request,
+                                        uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    MQTTConfig& config = configManager.getMQTTConfig();
+    
+    if (doc["server"].is<JsonVariant>()) {
+        strncpy(config.server, doc["server"] | "", 64);
+        config.server[64] = '\0';
+    }
+    if (doc["port"].is<JsonVariant>()) {
+        config.port = doc["port"];
+    }
+    if (doc["username"].is<JsonVariant>()) {
+        strncpy(config.username, doc["username"] | "", 32);
+        config.username[32] = '\0';
+    }
+    if (doc["password"].is<JsonVariant>() && strlen(doc["password"] | "") > 0) {
+        strncpy(config.password, doc["password"] | "", 64);
+        config.password[64] = '\0';
+    }
+    if (doc["topicPrefix"].is<JsonVariant>()) {
+        strncpy(config.topicPrefix, doc["topicPrefix"] | "", 64);
+        config.topicPrefix[64] = '\0';
+    }
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
+    }
+    if (doc["publishOnChange"].is<JsonVariant>()) {
+        config.publishOnChange = doc["publishOnChange"];
+    }
+    if (doc["publishThreshold"].is<JsonVariant>()) {
+        config.publishThreshold = doc["publishThreshold"];
+    }
+    if (doc["publishInterval"].is<JsonVariant>()) {
+        config.publishInterval = doc["publishInterval"];
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    // Send response before triggering reconnect
+    sendSuccess(request, "MQTT configuration updated");
+    
+    // Request reconnection (handled safely in main loop)
+    mqttClient.reconnect();
+}
+
+void WebServer::handleGetSystemConfig(AsyncWebServerRequest* request) {
+    const SystemConfig& config = configManager.getSystemConfig();
+    
+    JsonDocument doc;
+    doc["deviceName"] = config.deviceName;
+    doc["readInterval"] = config.readInterval;
+    doc["celsiusUnits"] = config.celsiusUnits;
+    doc["utcOffset"] = config.utcOffset;
+    doc["otaEnabled"] = config.otaEnabled;
+    doc["pinnedSensorAddress"] = config.pinnedSensorAddress;
+    
+    char buffer[256];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateSystemConfig(AsyncWebServerRequest* request,
+                                          uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    SystemConfig& config = configManager.getSystemConfig();
+    
+    if (doc["deviceName"].is<JsonVariant>()) {
+        strncpy(config.deviceName, doc["deviceName"] | "", 32);
+        config.deviceName[32] = '\0';
+    }
+    if (doc["readInterval"].is<JsonVariant>()) {
+        config.readInterval = doc["readInterval"];
+    }
+    if (doc["celsiusUnits"].is<JsonVariant>()) {
+        config.celsiusUnits = doc["celsiusUnits"];
+    }
+    if (doc["utcOffset"].is<JsonVariant>()) {
+        config.utcOffset = doc["utcOffset"];
+    }
+    if (doc["otaEnabled"].is<JsonVariant>()) {
+        config.otaEnabled = doc["otaEnabled"];
+    }
+    if (doc["pinnedSensorAddress"].is<JsonVariant>()) {
+        strlcpy(config.pinnedSensorAddress, doc["pinnedSensorAddress"] | "", sizeof(config.pinnedSensorAddress));
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sendSuccess(request, "System configuration updated");
+}
+
+void WebServer::handleGetUdpConfig(AsyncWebServerRequest* request) {
+    const UdpTelemetryConfig& config = configManager.getUdpTelemetryConfig();
+    
+    JsonDocument doc;
+    doc["enabled"] = config.enabled;
+    doc["group"] = config.group;
+    doc["port"] = config.port;
+    doc["ttl"] = config.ttl;
+    
+    char buffer[128];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateUdpConfig(AsyncWebServerRequest* request,
+                                       uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    UdpTelemetryConfig& config = configManager.getUdpTelemetryConfig();
+    
+    // Validate everything first, so a rejected request changes nothing
+    uint32_t port = doc["port"] | 0;
+    if (doc["port"].is<JsonVariant>() && (port == 0 || port > 65535)) {
+        sendError(request, 400, "Invalid port");
+        return;
+    }
+    uint32_t ttl = doc["ttl"] | 0;
+    if (doc["ttl"].is<JsonVariant>() && (ttl == 0 || ttl > 255)) {
+        sendError(request, 400, "ttl must be 1-255");
+        return;
+    }
+    
+    if (doc["group"].is<JsonVariant>()) {
+        IPAddress group;
+        if (!group.fromString(doc["group"] | "") || group[0] < 224 || group[0] > 239) {
+            sendError(request, 400, "Group must be a multicast address (224.0.0.0-239.255.255.255)");
+            return;
+        }
+        strlcpy(config.group, doc["group"] | "", sizeof(config.group));
+    }
+    if (doc["port"].is<JsonVariant>()) {
+        config.port = port;
+    }
+    if (doc["ttl"].is<JsonVariant>()) {
+        config.ttl = ttl;
+    }
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sendSuccess(request, "UDP telemetry configuration updated");
+    
+    // Reopen sockets with new settings (handled safely in main loop)
+    udpTelemetry.reconfigure();
+    hubReceiver.reconfigure();
+}
+
+void WebServer::handleGetHubConfig(AsyncWebServerRequest* request) {
+    const HubConfig& config = configManager.getHubConfig();
+    
+    JsonDocument doc;
+    doc["enabled"] = config.enabled;
+    doc["timeout"] = config.timeout;
+    
+    // Peers heard since boot (sequence gaps count as lost datagrams)
+    JsonArray peers = doc["peers"].to<JsonArray>();
+    for (uint8_t i = 0; i < HUB_MAX_PEERS; i++) {
+        const HubPeer* peer = hubReceiver.getPeer(i);
+        if (!peer) {
+            continue;
+        }
+        
+        char id[18];
+        snprintf(id, sizeof(id), "%02X:%02X:%02X:%02X:%02X:%02X",
+            peer->deviceId[0], peer->deviceId[1], peer->deviceId[2],
+            peer->deviceId[3], peer->deviceId[4], peer->deviceId[5]);
+        
+        JsonObject obj = peers.add<JsonObject>();
+        obj["id"] = id;
+        obj["ageMs"] = millis() - peer->lastSeen;
+        obj["datagrams"] = peer->datagrams;
+        obj["lost"] = peer->lost;
+    }
+    
+    char buffer[768];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateHubConfig(AsyncWebServerRequest* request,
+                                       uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    HubConfig& config = configManager.getHubConfig();
+    
+    if (doc["timeout"].is<JsonVariant>()) {
+        uint32_t timeout = doc["timeout"] | 0;
+        if (timeout < 10 || timeout > 3600) {
+            sendError(request, 400, "Timeout must be 10-3600 seconds");
+            return;
+        }
+        config.timeout = timeout;
+    }
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sendSuccess(request, "Hub configuration updated");
+    
+    // Open or close the socket (handled safely in main loop)
+    hubReceiver.reconfigure();
+}
+
+void WebServer::handleGetIngestConfig(AsyncWebServerRequest* request) {
+    const IngestConfig& config = configManager.getIngestConfig();
+    
+    JsonDocument doc;
+    doc["enabled"] = config.enabled;
+    doc["timeout"] = config.timeout;
+    doc["maxMessageSize"] = INGEST_MAX_MESSAGE_SIZE;
+    doc["maxReadings"] = INGEST_MAX_READINGS;
+    
+    char buffer[128];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateIngestConfig(AsyncWebServerRequest* request,
+                                          uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    IngestConfig& config = configManager.getIngestConfig();
+    
+    if (doc["timeout"].is<JsonVariant>()) {
+        uint32_t timeout = doc["timeout"] | 0;
+        if (timeout < 10 || timeout > 65535) {
+            sendError(request, 400, "Timeout must be 10-65535 seconds");
+            return;
+        }
+        config.timeout = timeout;
+    }
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sendSuccess(request, "Ingestion configuration updated");
+}
+
+void WebServer::handleGetCoapConfig(AsyncWebServerRequest* request) {
+    const CoapConfig& config = configManager.getCoapConfig();
+    
+    JsonDocument doc;
+    doc["enabled"] = config.enabled;
+    doc["port"] = config.port;
+    
+    char buffer[64];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateCoapConfig(AsyncWebServerRequest* request,
+                                        uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    CoapConfig& config = configManager.getCoapConfig();
+    
+    if (doc["port"].is<JsonVariant>()) {
+        uint32_t port = doc["port"] | 0;
+        if (port == 0 || port > 65535) {
+            sendError(request, 400, "Invalid port");
+            return;
+        }
+        config.port = port;
+    }
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
+    }
+    
+    if (!configManager.save()) {
+        sendError(request, 500, "Failed to save configuration");
+        return;
+    }
+    
+    sendSuccess(request, "CoAP configuration updated");
+    
+    // Rebind socket with new settings (handled safely in main loop)
+    coapServer.reconfigure();
+}
+
+void WebServer::handleGetInfluxConfig(AsyncWebServerRequest* request) {
+    const InfluxConfig& config = configManager.getInfluxConfig();
+    
+    JsonDocument doc;
+    doc["enabled"] = config.enabled;
+    doc["url"] = config.url;
+    doc["token"] = ""; // Don't expose token
+    doc["hasToken"] = config.token[0] != '\0';
+    doc["measurement"] = config.measurement;
+    doc["batchWindow"] = config.batchWindow;
+    doc["gzip"] = config.gzip;
+    
+    char buffer[384];
+    serializeJson(doc, buffer, sizeof(buffer));
+    sendJson(request, 200, buffer);
+}
+
+void WebServer::handleUpdateInfluxConfig(AsyncWebServerRequest* request,
+                                          uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    InfluxConfig& config = configManager.getInfluxConfig();
     
-    if (!config) {
-        sendError(request, 500, "Sensor config not found");
-        return;
+    if (doc["url"].is<JsonVariant>()) {
+        const char* url = doc["url"] | "";
+        if (url[0] != '\0' && strncmp(url, "http://", 7) != 0 && strncmp(url, "https://", 8) != 0) {
+            sendError(request, 400, "URL must start with http:// or https://");
+            return;
+        }
+        if (strlen(url) >= sizeof(config.url)) {
+            sendError(request, 400, "URL too long");
+            return;
+        }
+        strlcpy(config.url, url, sizeof(config.url));
     }
-    
-    // Update fields
-    if (doc["name"].is<JsonVariant>()) {
-        strncpy(config->name, doc["name"] | "", SENSOR_NAME_MAX_LEN - 1);
-        config->name[SENSOR_NAME_MAX_LEN - 1] = '\0';
+    // Empty token keeps the stored one
+    if (doc["token"].is<JsonVariant>() && strlen(doc["token"] | "") > 0) {
+        strlcpy(config.token, doc["token"] | "", sizeof(config.token));
     }
-    if (doc["thresholdLow"].is<JsonVariant>()) {
-        config->thresholdLow = doc["thresholdLow"];
+    if (doc["measurement"].is<JsonVariant>() && strlen(doc["measurement"] | "") > 0) {
+        strlcpy(config.measurement, doc["measurement"] | "", sizeof(config.measurement));
     }
-    if (doc["thresholdHigh"].is<JsonVariant>()) {
-        config->thresholdHigh = doc["thresholdHigh"];
+    if (doc["batchWindow"].is<JsonVariant>()) {
+        uint32_t window = doc["batchWindow"] | (uint32_t)INFLUX_DEFAULT_BATCH_WINDOW;
+        if (window < 1 || window > 3600) {
+            sendError(request, 400, "batchWindow must be 1-3600 seconds");
+            return;
+        }
+        config.batchWindow = window;
     }
-    if (doc["alertEnabled"].is<JsonVariant>()) {
-        config->alertEnabled = doc["alertEnabled"];
+    if (doc["gzip"].is<JsonVariant>()) {
+        config.gzip = doc["gzip"];
     }
-    if (doc["calibrationOffset"].is<JsonVariant>()) {
-        config->calibrationOffset = doc["calibrationOffset"];
-        
-        // Immediately recalculate temperature with new offset
-        sensorManager.recalculateTemperature(sensorIndex);
-        Serial.printf("[WebServer] Updated calibration offset for sensor %d: %.2f\n", 
-            sensorIndex, config->calibrationOffset);
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
     }
     
-    configManager.markDirty();
     if (!configManager.save()) {
         sendError(request, 500, "Failed to save configuration");
         return;
     }
     
-    // Republish Home Assistant discovery if MQTT is enabled and connected
-    // This updates the sensor name in Home Assistant immediately
-    if (mqttClient.isEnabled() && mqttClient.isConnected()) {
-        mqttClient.publishHADiscovery();
-        Serial.printf("[WebServer] Republished HA discovery for sensor %d after config update\n", sensorIndex);
-    }
+    sendSuccess(request, "InfluxDB configuration updated");
     
-    sendSuccess(request, "Sensor updated");
+    // Flush the current batch with the new settings (handled safely in main loop)
+    influxExporter.reconfigure();
 }
 
-void WebServer::handleGetWiFiConfig(AsyncWebServerRequest* request) {
-    const WiFiConfig& config = configManager.getWiFiConfig();
+void WebServer::handleGetPowerConfig(AsyncWebServerRequest* request) {
+    const PowerConfig& config = configManager.getPowerConfig();
     
     JsonDocument doc;
-    doc["ssid"] = config.ssid;
-    doc["password"] = ""; // Don't expose password
-    doc["dhcp"] = config.dhcp;
-    doc["staticIP"] = config.staticIP;
-    doc["gateway"] = config.gateway;
-    doc["subnet"] = config.subnet;
-    doc["dns"] = config.dns;
+    doc["batteryMode"] = config.batteryMode;
+    doc["sleepInterval"] = config.sleepInterval;
+    doc["flushEvery"] = config.flushEvery;
+    doc["configWindow"] = SLEEP_CONFIG_WINDOW_MS / 1000;
     
-    char buffer[256];
+    char buffer[128];
     serializeJson(doc, buffer, sizeof(buffer));
     sendJson(request, 200, buffer);
 }
 
-void WebServer::handleUpdateWiFiConfig(AsyncWebServerRequest* request,
-                                        uint8_t* data, size_t len) {
+void WebServer::handleUpdatePowerConfig(AsyncWebServerRequest* request,
+                                         uint8_t* data, size_t len) {
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, data, len);
     
@@ -551,34 +1923,33 @@ void WebServer::handleUpdateWiFiConfig(AsyncWebServerRequest* request,
         return;
     }
     
-    WiFiConfig& config = configManager.getWiFiConfig();
+    PowerConfig& config = configManager.getPowerConfig();
     
-    if (doc["ssid"].is<JsonVariant>()) {
-        strncpy(config.ssid, doc["ssid"] | "", 32);
-        config.ssid[32] = '\0';
-    }
-    if (doc["password"].is<JsonVariant>() && strlen(doc["password"] | "") > 0) {
-        strncpy(config.password, doc["password"] | "", 64);
-        config.password[64] = '\0';
-    }
-    if (doc["dhcp"].is<JsonVariant>()) {
-        config.dhcp = doc["dhcp"];
-    }
-    if (doc["staticIP"].is<JsonVariant>()) {
-        strncpy(config.staticIP, doc["staticIP"] | "", 15);
-        config.staticIP[15] = '\0';
-    }
-    if (doc["gateway"].is<JsonVariant>()) {
-        strncpy(config.gateway, doc["gateway"] | "", 15);
-        config.gateway[15] = '\0';
+    if (doc["sleepInterval"].is<JsonVariant>()) {
+        uint32_t interval = doc["sleepInterval"] | (uint32_t)DEFAULT_SLEEP_INTERVAL;
+        if (interval < 10 || interval > 65535) {
+            sendError(request, 400, "sleepInterval must be 10-65535 seconds");
+            return;
+        }
+        config.sleepInterval = interval;
     }
-    if (doc["subnet"].is<JsonVariant>()) {
-        strncpy(config.subnet, doc["subnet"] | "", 15);
-        config.subnet[15] = '\0';
+    if (doc["flushEvery"].is<JsonVariant>()) {
+        uint32_t flushEvery = doc["flushEvery"] | (uint32_t)DEFAULT_SLEEP_FLUSH_EVERY;
+        // Leave room in the buffer for a few failed flushes
+        if (flushEvery < 1 || flushEvery > SLEEP_BUFFER_SAMPLES / 2) {
+            sendError(request, 400, "flushEvery out of range");
+            return;
+        }
+        config.flushEvery = flushEvery;
     }
-    if (doc["dns"].is<JsonVariant>()) {
-        strncpy(config.dns, doc["dns"] | "", 15);
-        config.dns[15] = '\0';
+    if (doc["batteryMode"].is<JsonVariant>()) {
+        bool batteryMode = doc["batteryMode"];
+        // Samples are only delivered over MQTT
+        if (batteryMode && !mqttClient.isEnabled()) {
+            sendError(request, 400, "Battery mode requires MQTT");
+            return;
+        }
+        config.batteryMode = batteryMode;
     }
     
     if (!configManager.save()) {
@@ -586,34 +1957,24 @@ void WebServer::handleUpdateWiFiConfig(AsyncWebServerRequest* request,
         return;
     }
     
-    // Send response before triggering reconnect
-    sendSuccess(request, "WiFi configuration updated. Reconnecting...");
-    
-    // Request reconnection (handled safely in main loop)
-    wifiManager.reconnect();
+    sendSuccess(request, "Power configuration updated");
 }
 
-void WebServer::handleGetMQTTConfig(AsyncWebServerRequest* request) {
-    const MQTTConfig& config = configManager.getMQTTConfig();
+void WebServer::handleGetBusConfig(AsyncWebServerRequest* request) {
+    const BusConfig& config = configManager.getBusConfig();
     
     JsonDocument doc;
-    doc["server"] = config.server;
-    doc["port"] = config.port;
-    doc["username"] = config.username;
-    doc["password"] = ""; // Don't expose password
-    doc["topicPrefix"] = config.topicPrefix;
-    doc["enabled"] = config.enabled;
-    doc["publishOnChange"] = config.publishOnChange;
-    doc["publishThreshold"] = config.publishThreshold;
-    doc["publishInterval"] = config.publishInterval;
+    doc["hardwareAlarms"] = config.hardwareAlarms;
+    doc["inRangeReadEvery"] = config.inRangeReadEvery;
+    doc["skippedReads"] = sensorManager.getSkippedReads();
     
-    char buffer[256];
+    char buffer[128];
     serializeJson(doc, buffer, sizeof(buffer));
     sendJson(request, 200, buffer);
 }
 
-void WebServer::handleUpdateMQTTConfig(AsyncWebServerRequest* request,
-                                        uint8_t* data, size_t len) {
+void WebServer::handleUpdateBusConfig(AsyncWebServerRequest* request,
+                                       uint8_t* data, size_t len) {
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, data, len);
     
@@ -622,38 +1983,18 @@ void WebServer::handleUpdateMQTTConfig(AsyncWebServerRequest* request,
         return;
     }
     
-    MQTTConfig& config = configManager.getMQTTConfig();
+    BusConfig& config = configManager.getBusConfig();
     
-    if (doc["server"].is<JsonVariant>()) {
-        strncpy(config.server, doc["server"] | "", 64);
-        config.server[64] = '\0';
-    }
-    if (doc["port"].is<JsonVariant>()) {
-        config.port = doc["port"];
-    }
-    if (doc["username"].is<JsonVariant>()) {
-        strncpy(config.username, doc["username"] | "", 32);
-        config.username[32] = '\0';
-    }
-    if (doc["password"].is<JsonVariant>() && strlen(doc["password"] | "") > 0) {
-        strncpy(config.password, doc["password"] | "", 64);
-        config.password[64] = '\0';
-    }
-    if (doc["topicPrefix"].is<JsonVariant>()) {
-        strncpy(config.topicPrefix, doc["topicPrefix"] | "", 64);
-        config.topicPrefix[64] = '\0';
-    }
-    if (doc["enabled"].is<JsonVariant>()) {
-        config.enabled = doc["enabled"];
-    }
-    if (doc["publishOnChange"].is<JsonVariant>()) {
-        config.publishOnChange = doc["publishOnChange"];
-    }
-    if (doc["publishThreshold"].is<JsonVariant>()) {
-        config.publishThreshold = doc["publishThreshold"];
+    if (doc["inRangeReadEvery"].is<JsonVariant>()) {
+        uint32_t every = doc["inRangeReadEvery"] | (uint32_t)DEFAULT_IN_RANGE_READ_EVERY;
+        if (every < 1 || every > 60) {
+            sendError(request, 400, "inRangeReadEvery must be 1-60");
+            return;
+        }
+        config.inRangeReadEvery = every;
     }
-    if (doc["publishInterval"].is<JsonVariant>()) {
-        config.publishInterval = doc["publishInterval"];
+    if (doc["hardwareAlarms"].is<JsonVariant>()) {
+        config.hardwareAlarms = doc["hardwareAlarms"];
     }
     
     if (!configManager.save()) {
@@ -661,31 +2002,45 @@ void WebServer::handleUpdateMQTTConfig(AsyncWebServerRequest* request,
         return;
     }
     
-    // Send response before triggering reconnect
-    sendSuccess(request, "MQTT configuration updated");
-    
-    // Request reconnection (handled safely in main loop)
-    mqttClient.reconnect();
+    sendSuccess(request, "Bus configuration updated");
 }
 
-void WebServer::handleGetSystemConfig(AsyncWebServerRequest* request) {
-    const SystemConfig& config = configManager.getSystemConfig();
-    
+void WebServer::handleGetWebhooks(AsyncWebServerRequest* request) {
     JsonDocument doc;
-    doc["deviceName"] = config.deviceName;
-    doc["readInterval"] = config.readInterval;
-    doc["celsiusUnits"] = config.celsiusUnits;
-    doc["utcOffset"] = config.utcOffset;
-    doc["otaEnabled"] = config.otaEnabled;
-    doc["pinnedSensorAddress"] = config.pinnedSensorAddress;
+    JsonArray arr = doc["webhooks"].to<JsonArray>();
     
-    char buffer[256];
-    serializeJson(doc, buffer, sizeof(buffer));
-    sendJson(request, 200, buffer);
+    for (uint8_t slot = 0; slot < MAX_WEBHOOKS; slot++) {
+        const WebhookConfig* config = configManager.getWebhookConfig(slot);
+        const WebhookStats* stats = notificationManager.getStats(slot);
+        
+        JsonObject obj = arr.add<JsonObject>();
+        obj["slot"] = slot;
+        obj["enabled"] = config->enabled;
+        obj["url"] = config->url;
+        obj["auth"] = ""; // Don't expose credentials
+        obj["hasAuth"] = config->auth[0] != '\0';
+        obj["template"] = config->bodyTemplate;
+        obj["minInterval"] = config->minInterval;
+        JsonArray events = obj["events"].to<JsonArray>();
+        if (config->events & WEBHOOK_EVENT_ALARM) events.add("alarm");
+        if (config->events & WEBHOOK_EVENT_CLEAR) events.add("clear");
+        obj["delivered"] = stats->delivered;
+        obj["failed"] = stats->failed;
+        obj["retries"] = stats->retries;
+        obj["lastStatus"] = stats->lastStatus;
+        obj["lastLatencyMs"] = stats->lastLatencyMs;
+    }
+    
+    doc["queued"] = notificationManager.getQueuedCount();
+    doc["dropped"] = notificationManager.getDroppedCount();
+    
+    String response;
+    serializeJson(doc, response);
+    sendJson(request, 200, response.c_str());
 }
 
-void WebServer::handleUpdateSystemConfig(AsyncWebServerRequest* request,
-                                          uint8_t* data, size_t len) {
+void WebServer::handleUpdateWebhook(AsyncWebServerRequest* request,
+                                     uint8_t* data, size_t len) {
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, data, len);
     
@@ -694,34 +2049,109 @@ void WebServer::handleUpdateSystemConfig(AsyncWebServerRequest* request,
         return;
     }
     
-    SystemConfig& config = configManager.getSystemConfig();
+    WebhookConfig* stored = configManager.getWebhookConfig(doc["slot"] | 255);
+    if (!stored) {
+        sendError(request, 400, "Invalid webhook slot");
+        return;
+    }
     
-    if (doc["deviceName"].is<JsonVariant>()) {
-        strncpy(config.deviceName, doc["deviceName"] | "", 32);
-        config.deviceName[32] = '\0';
+    // Validate into a copy so a rejected request changes nothing
+    WebhookConfig config = *stored;
+    
+    if (doc["url"].is<JsonVariant>()) {
+        const char* url = doc["url"] | "";
+        if (url[0] != '\0' && strncmp(url, "http://", 7) != 0 && strncmp(url, "https://", 8) != 0) {
+            sendError(request, 400, "URL must start with http:// or https://");
+            return;
+        }
+        if (strlen(url) >= sizeof(config.url)) {
+            sendError(request, 400, "URL too long");
+            return;
+        }
+        strlcpy(config.url, url, sizeof(config.url));
     }
-    if (doc["readInterval"].is<JsonVariant>()) {
-        config.readInterval = doc["readInterval"];
+    // Empty auth keeps the stored one
+    if (doc["auth"].is<JsonVariant>() && strlen(doc["auth"] | "") > 0) {
+        if (strlen(doc["auth"] | "") >= sizeof(config.auth)) {
+            sendError(request, 400, "Authorization value too long");
+            return;
+        }
+        strlcpy(config.auth, doc["auth"] | "", sizeof(config.auth));
     }
-    if (doc["celsiusUnits"].is<JsonVariant>()) {
-        config.celsiusUnits = doc["celsiusUnits"];
+    if (doc["clearAuth"] | false) {
+        config.auth[0] = '\0';
     }
-    if (doc["utcOffset"].is<JsonVariant>()) {
-        config.utcOffset = doc["utcOffset"];
+    if (doc["template"].is<JsonVariant>()) {
+        const char* bodyTemplate = doc["template"] | "";
+        if (strlen(bodyTemplate) >= sizeof(config.bodyTemplate)) {
+            sendError(request, 400, "Template too long");
+            return;
+        }
+        strlcpy(config.bodyTemplate, bodyTemplate, sizeof(config.bodyTemplate));
     }
-    if (doc["otaEnabled"].is<JsonVariant>()) {
-        config.otaEnabled = doc["otaEnabled"];
+    if (doc["minInterval"].is<JsonVariant>()) {
+        uint32_t interval = doc["minInterval"] | (uint32_t)WEBHOOK_DEFAULT_MIN_INTERVAL;
+        if (interval > 3600) {
+            sendError(request, 400, "minInterval must be 0-3600 seconds");
+            return;
+        }
+        config.minInterval = interval;
+    }
+    if (doc["events"].is<JsonArrayConst>()) {
+        config.events = 0;
+        for (JsonVariantConst event : doc["events"].as<JsonArrayConst>()) {
+            const char* name = event | "";
+            if (strcmp(name, "alarm") == 0) {
+                config.events |= WEBHOOK_EVENT_ALARM;
+            } else if (strcmp(name, "clear") == 0) {
+                config.events |= WEBHOOK_EVENT_CLEAR;
+            } else {
+                sendError(request, 400, "Unknown event type");
+                return;
+            }
+        }
     }
-    if (doc["pinnedSensorAddress"].is<JsonVariant>()) {
-        strlcpy(config.pinnedSensorAddress, doc["pinnedSensorAddress"] | "", sizeof(config.pinnedSensorAddress));
+    if (doc["enabled"].is<JsonVariant>()) {
+        config.enabled = doc["enabled"];
     }
     
+    *stored = config;
+    
+    configManager.markDirty();
     if (!configManager.save()) {
         sendError(request, 500, "Failed to save configuration");
         return;
     }
     
-    sendSuccess(request, "System configuration updated");
+    sendSuccess(request, "Webhook configuration updated");
+    
+    // Drop or retry queued deliveries (handled safely in main loop)
+    notificationManager.reconfigure();
+}
+
+void WebServer::handleTestWebhook(AsyncWebServerRequest* request,
+                                   uint8_t* data, size_t len) {
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, data, len);
+    
+    if (error) {
+        sendError(request, 400, "Invalid JSON");
+        return;
+    }
+    
+    uint8_t slot = doc["slot"] | 255;
+    const WebhookConfig* config = configManager.getWebhookConfig(slot);
+    if (!config) {
+        sendError(request, 400, "Invalid webhook slot");
+        return;
+    }
+    if (config->url[0] == '\0') {
+        sendError(request, 409, "Webhook has no URL");
+        return;
+    }
+    
+    notificationManager.requestTest(slot);
+    sendSuccess(request, "Test event queued");
 }
 
 void WebServer::handleWiFiScan(AsyncWebServerRequest* request) {
@@ -850,6 +2280,63 @@ void WebServer::handleRescan(AsyncWebServerRequest* request) {
     sendSuccess(request, "Sensor rescan initiated");
 }
 
+void WebServer::handleGetBusDiagnostics(AsyncWebServerRequest* request) {
+    if (!checkServerLoad(request)) return;
+    
+    BusDiagnostics bus = sensorManager.getBusDiagnostics();
+    
+    JsonDocument doc;
+    doc["backend"] = bus.backend;
+    doc["conversions"] = bus.conversions;
+    doc["reads"] = bus.reads;
+    doc["crcErrors"] = bus.crcErrors;
+    doc["presenceErrors"] = bus.presenceErrors;
+    doc["rangeErrors"] = bus.rangeErrors;
+    doc["retries"] = bus.retries;
+    doc["recovered"] = bus.recovered;
+    doc["skippedReads"] = bus.skippedReads;
+    doc["errorRate"] = roundf(bus.errorRate * 1000.0f) / 1000.0f;
+    doc["maxLatencyUs"] = bus.maxLatencyUs;
+    
+    JsonArray sensors = doc["sensors"].to<JsonArray>();
+    for (uint8_t i = 0; i < sensorManager.getSensorCount(); i++) {
+        const SensorData* data = sensorManager.getSensorData(i);
+        if (!data || data->source != SensorSource::PHYSICAL) {
+            continue;
+        }
+        
+        const SensorConfig* config = configManager.getSensorConfigByAddress(data->addressStr);
+        const SensorDiagnostics& diag = data->diag;
+        
+        JsonObject obj = sensors.add<JsonObject>();
+        obj["index"] = i;
+        obj["address"] = data->addressStr;
+        obj["name"] = config ? config->name : "";
+        obj["connected"] = data->connected;
+        obj["reads"] = diag.reads;
+        obj["crcErrors"] = diag.crcErrors;
+        obj["presenceErrors"] = diag.presenceErrors;
+        obj["rangeErrors"] = diag.rangeErrors;
+        obj["retries"] = diag.retries;
+        obj["recovered"] = diag.recovered;
+        obj["consecutiveErrors"] = data->errorCount;
+        obj["errorRate"] = roundf(diag.errorRate() * 1000.0f) / 1000.0f;
+        obj["latencyUs"] = diag.lastLatencyUs;
+        obj["maxLatencyUs"] = diag.maxLatencyUs;
+    }
+    
+    size_t bufferSize = measureJson(doc) + 1;
+    char* buffer = (char*)malloc(bufferSize);
+    if (!buffer) {
+        sendError(request, 500, "Out of memory");
+        return;
+    }
+    
+    serializeJson(doc, buffer, bufferSize);
+    sendJson(request, 200, buffer);
+    free(buffer);
+}
+
 void WebServer::handleReboot(AsyncWebServerRequest* request) {
     sendSuccess(request, "Rebooting...");
     delay(1000);
@@ -1131,10 +2618,73 @@ bool WebServer::checkServerLoad(AsyncWebServerRequest* request) {
     return true;
 }
 
+AsyncWebServerResponse* WebServer::beginJsonResponse(AsyncWebServerRequest* request, int code, const char* json) {
+    AsyncWebServerResponse* response = nullptr;
+    
+    size_t len = strlen(json);
+    if (HTTP_GZIP_MIN_SIZE > 0 && len >= HTTP_GZIP_MIN_SIZE && request->hasHeader("Accept-Encoding") &&
+        strstr(request->header("Accept-Encoding").c_str(), "gzip")) {
+        response = beginGzipResponse(request, code, json, len);
+    }
+    
+    if (!response) {
+        response = request->beginResponse(code, "application/json", json);
+    }
+    
+    // The server parses one request per connection: never offer keep-alive
+    response->addHeader("Connection", "close");
+    return response;
+}
+
+AsyncWebServerResponse* WebServer::beginGzipResponse(AsyncWebServerRequest* request, int code,
+                                                     const char* json, size_t len) {
+    // Encoder workspace plus the output, on top of the normal request margin
+    size_t cap = gzipMaxCompressedSize(len);
+    if (ESP.getFreeHeap() < MIN_HEAP_FOR_REQUEST + cap + 8192) {
+        return nullptr;
+    }
+    
+    uint8_t* out = (uint8_t*)malloc(cap);
+    if (!out) {
+        return nullptr;
+    }
+    
+    uint32_t start = micros();
+    size_t outLen = GzipEncoder::compress((const uint8_t*)json, len, out, cap);
+    uint32_t elapsed = micros() - start;
+    
+    if (outLen == 0 || outLen >= len) {
+        free(out);
+        return nullptr;
+    }
+    
+    _gzipStats.responses++;
+    _gzipStats.bytesIn += len;
+    _gzipStats.bytesOut += outLen;
+    _gzipStats.timeUs += elapsed;
+    
+    // The response reads the body while it is sent: it owns the buffer
+    std::shared_ptr<uint8_t> body(out, free);
+    AsyncWebServerResponse* response = request->beginResponse("application/json", outLen,
+        [body, outLen](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (index >= outLen) {
+                return 0;
+            }
+            size_t chunk = outLen - index;
+            if (chunk > maxLen) {
+                chunk = maxLen;
+            }
+            memcpy(buffer, body.get() + index, chunk);
+            return chunk;
+        });
+    response->setCode(code);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("Vary", "Accept-Encoding");
+    return response;
+}
+
 void WebServer::sendJson(AsyncWebServerRequest* request, int code, const char* json) {
-    AsyncWebServerResponse* response = request->beginResponse(code, "application/json", json);
-    response->addHeader("Connection", "close"); // Force connection close to prevent TCP window overflow
-    request->send(response);
+    request->send(beginJsonResponse(request, code, json));
 }
 
 void WebServer::sendError(AsyncWebServerRequest* request, int code, const char* message) {
@@ -1159,28 +2709,49 @@ void WebServer::sendSuccess(AsyncWebServerRequest* request, const char* message)
     sendJson(request, 200, buffer);
 }
 
-void WebServer::buildSensorJson(JsonObject& obj, uint8_t sensorIndex) {
+void WebServer::buildSensorJson(JsonObject& obj, uint8_t sensorIndex, uint32_t fields) {
     const SensorData* data = sensorManager.getSensorData(sensorIndex);
     if (!data) {
         return;
     }
     
-    const SensorConfig* config = configManager.getSensorConfigByAddress(data->addressStr);
-    
     obj["index"] = sensorIndex;
-    obj["address"] = data->addressStr;
-    obj["connected"] = data->connected;
-    obj["temperature"] = round(data->temperature * 100) / 100.0;
-    obj["rawTemperature"] = round(data->rawTemperature * 100) / 100.0;
-    obj["alarm"] = alarmStateToString(data->alarmState);
-    obj["lastReadMs"] = millis() - data->lastHistoryTime;  // Milliseconds since last read
-    
+    if (fields & SENSOR_FIELD_ADDRESS) obj["address"] = data->addressStr;
+    if (fields & SENSOR_FIELD_CONNECTED) obj["connected"] = data->connected;
+    if (fields & SENSOR_FIELD_TEMPERATURE) obj["temperature"] = round(data->temperature * 100) / 100.0;
+    if (fields & SENSOR_FIELD_RAW_TEMPERATURE) obj["rawTemperature"] = round(data->rawTemperature * 100) / 100.0;
+    if (fields & SENSOR_FIELD_ALARM) obj["alarm"] = alarmStateToString(data->alarmState);
+    if (fields & SENSOR_FIELD_LAST_READ_MS) obj["lastReadMs"] = millis() - data->lastHistoryTime;  // Milliseconds since last read
+    if (fields & SENSOR_FIELD_VIRTUAL) obj["virtual"] = data->source == SensorSource::VIRTUAL;
+    if (fields & SENSOR_FIELD_TYPE) obj["type"] = sensorManager.getSensorType(sensorIndex);
+    if (fields & SENSOR_FIELD_ACKNOWLEDGED) obj["acknowledged"] = data->alarmAcknowledged;
+    if (fields & SENSOR_FIELD_LATCHED) obj["latched"] = data->alarmLatched;
+    if (fields & SENSOR_FIELD_UNIT) obj["unit"] = sensorManager.getUnit(sensorIndex);
+    
+    // Configuration lookups are skipped when none of their fields is wanted
+    const SensorConfig* config = (fields & SENSOR_FIELDS_CONFIG) ?
+        configManager.getSensorConfigByAddress(data->addressStr) : nullptr;
     if (config) {
-        obj["name"] = config->name;
-        obj["calibrationOffset"] = config->calibrationOffset;
-        obj["thresholdLow"] = config->thresholdLow;
-        obj["thresholdHigh"] = config->thresholdHigh;
-        obj["alertEnabled"] = config->alertEnabled;
+        if (fields & SENSOR_FIELD_NAME) obj["name"] = config->name;
+        if (fields & SENSOR_FIELD_CALIBRATION_OFFSET) obj["calibrationOffset"] = config->calibrationOffset;
+        if (fields & SENSOR_FIELD_THRESHOLD_LOW) obj["thresholdLow"] = config->thresholdLow;
+        if (fields & SENSOR_FIELD_THRESHOLD_HIGH) obj["thresholdHigh"] = config->thresholdHigh;
+        if (fields & SENSOR_FIELD_ALERT_ENABLED) obj["alertEnabled"] = config->alertEnabled;
+    }
+    
+    const SensorAlarmConfig* alarmConfig = (fields & SENSOR_FIELDS_ALARM_CONFIG) ?
+        configManager.getSensorAlarmConfig(data->addressStr) : nullptr;
+    if (alarmConfig) {
+        if (fields & SENSOR_FIELD_ENTRY_DELAY) obj["entryDelay"] = alarmConfig->entryDelay;
+        if (fields & SENSOR_FIELD_EXIT_DELAY) obj["exitDelay"] = alarmConfig->exitDelay;
+        if (fields & SENSOR_FIELD_LATCH) obj["latch"] = alarmConfig->latch;
+    }
+    
+    const SensorFilterConfig* filterConfig = (fields & SENSOR_FIELDS_FILTER_CONFIG) ?
+        configManager.getSensorFilterConfig(data->addressStr) : nullptr;
+    if (filterConfig) {
+        if (fields & SENSOR_FIELD_FILTER) obj["filter"] = sensorFilterTypeToString(filterConfig->type);
+        if (fields & SENSOR_FIELD_FILTER_ALPHA) obj["filterAlpha"] = filterConfig->alpha;
     }
 }
 
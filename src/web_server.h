@@ -18,6 +18,76 @@
 #include "config_manager.h"
 #include "sensor_manager.h"
 
+// ============================================================================
+// Sensor Field Projection
+// ============================================================================
+
+/**
+ * Fields of a sensor object, as a bit mask for ?fields= projection
+ * (bit order matches the names in sensorFieldNames)
+ */
+enum SensorField : uint32_t {
+    SENSOR_FIELD_ADDRESS            = 1UL << 0,
+    SENSOR_FIELD_CONNECTED          = 1UL << 1,
+    SENSOR_FIELD_TEMPERATURE        = 1UL << 2,
+    SENSOR_FIELD_RAW_TEMPERATURE    = 1UL << 3,
+    SENSOR_FIELD_ALARM              = 1UL << 4,
+    SENSOR_FIELD_LAST_READ_MS       = 1UL << 5,
+    SENSOR_FIELD_VIRTUAL            = 1UL << 6,
+    SENSOR_FIELD_TYPE               = 1UL << 7,
+    SENSOR_FIELD_ACKNOWLEDGED       = 1UL << 8,
+    SENSOR_FIELD_LATCHED            = 1UL << 9,
+    SENSOR_FIELD_UNIT               = 1UL << 10,
+    SENSOR_FIELD_NAME               = 1UL << 11,
+    SENSOR_FIELD_CALIBRATION_OFFSET = 1UL << 12,
+    SENSOR_FIELD_THRESHOLD_LOW      = 1UL << 13,
+    SENSOR_FIELD_THRESHOLD_HIGH     = 1UL << 14,
+    SENSOR_FIELD_ALERT_ENABLED      = 1UL << 15,
+    SENSOR_FIELD_ENTRY_DELAY        = 1UL << 16,
+    SENSOR_FIELD_EXIT_DELAY         = 1UL << 17,
+    SENSOR_FIELD_LATCH              = 1UL << 18,
+    SENSOR_FIELD_FILTER             = 1UL << 19,
+    SENSOR_FIELD_FILTER_ALPHA       = 1UL << 20,
+    SENSOR_FIELD_COUNT              = 21
+};
+
+constexpr uint32_t SENSOR_FIELDS_ALL = (1UL << SENSOR_FIELD_COUNT) - 1;
+
+// Fields read from the sensor's stored configuration
+constexpr uint32_t SENSOR_FIELDS_CONFIG = SENSOR_FIELD_NAME | SENSOR_FIELD_CALIBRATION_OFFSET |
+    SENSOR_FIELD_THRESHOLD_LOW | SENSOR_FIELD_THRESHOLD_HIGH | SENSOR_FIELD_ALERT_ENABLED;
+constexpr uint32_t SENSOR_FIELDS_ALARM_CONFIG = SENSOR_FIELD_ENTRY_DELAY | SENSOR_FIELD_EXIT_DELAY |
+    SENSOR_FIELD_LATCH;
+constexpr uint32_t SENSOR_FIELDS_FILTER_CONFIG = SENSOR_FIELD_FILTER | SENSOR_FIELD_FILTER_ALPHA;
+
+/**
+ * Parse a comma-separated field list ("temperature,alarm")
+ * @param fields Field mask (0 if only "index" is listed)
+ * @return false if a name is unknown
+ */
+bool parseSensorFields(const char* list, uint32_t& fields);
+
+/**
+ * Which sensors and fields a collection request wants
+ */
+struct SensorQuery {
+    uint32_t fields;                    // SensorField mask ("index" is always included)
+    uint8_t offset;                     // First sensor index
+    uint8_t limit;                      // Sensors at most (0 = all)
+    
+    SensorQuery() : fields(SENSOR_FIELDS_ALL), offset(0), limit(0) {}
+};
+
+/**
+ * Response compression counters, exposed in /api/status
+ */
+struct GzipStats {
+    uint32_t responses;                 // Responses sent gzipped
+    uint32_t bytesIn;                   // JSON bytes before compression
+    uint32_t bytesOut;                  // Bytes actually sent
+    uint32_t timeUs;                    // Time spent compressing
+};
+
 // ============================================================================
 // WebServer Class
 // ============================================================================
@@ -62,12 +132,29 @@ public:
      */
     void setOtaMode(bool enabled);
     
+    /**
+     * Build sensor JSON object
+     * Shared with other transports (CoAP) so all APIs expose the same snapshot
+     * @param fields SensorField mask of the fields to include besides "index"
+     */
+    void buildSensorJson(JsonObject& obj, uint8_t sensorIndex, uint32_t fields = SENSOR_FIELDS_ALL);
+    
+    /**
+     * Build /api/status document
+     */
+    void buildStatusJson(JsonDocument& doc);
+    
 private:
     AsyncWebServer _server;
     AsyncWebSocket _ws;
     uint32_t _lastWsUpdate;
     bool _otaMode = false; // disables WebSocket activity during OTA
     
+    GzipStats _gzipStats;
+    
+    // Long-poll requests being held (only touched from the AsyncTCP task)
+    uint8_t _longPollWaiters;
+    
     /**
      * Setup API routes
      */
@@ -89,9 +176,24 @@ private:
     
     /**
      * GET /api/sensors - All sensor data
+     * ?fields=a,b limits the fields, ?offset=&limit= pages the sensors.
+     * With ?since=<generation>[&wait=<s>] answers as soon as a reading
+     * newer than that generation exists, or after the wait (long-poll)
      */
     void handleGetSensors(AsyncWebServerRequest* request);
     
+    /**
+     * Hold a /api/sensors?since= request until a newer reading or timeout
+     */
+    void handleLongPollSensors(AsyncWebServerRequest* request, const SensorQuery& query,
+                               uint32_t since, uint16_t waitS);
+    
+    /**
+     * Read ?fields=, ?offset= and ?limit=
+     * @return false if 400 was sent
+     */
+    bool parseSensorQuery(AsyncWebServerRequest* request, SensorQuery& query);
+    
     /**
      * GET /api/sensors/{id} - Single sensor data
      */
@@ -103,6 +205,48 @@ private:
     void handleUpdateSensor(AsyncWebServerRequest* request, uint8_t sensorIndex,
                            uint8_t* data, size_t len);
     
+    /**
+     * POST /api/sensors/{id}/ack - Acknowledge sensor alarm
+     */
+    void handleAcknowledgeAlarm(AsyncWebServerRequest* request, uint8_t sensorIndex);
+    
+    /**
+     * POST /api/ingest - Readings from satellite devices (CBOR or binary)
+     */
+    void handleIngest(AsyncWebServerRequest* request);
+    
+    /**
+     * GET /api/virtual - Virtual sensor definitions
+     */
+    void handleGetVirtualSensors(AsyncWebServerRequest* request);
+    
+    /**
+     * POST /api/virtual - Create or update a virtual sensor
+     */
+    void handleUpdateVirtualSensor(AsyncWebServerRequest* request,
+                                   uint8_t* data, size_t len);
+    
+    /**
+     * DELETE /api/virtual/{slot} - Remove a virtual sensor
+     */
+    void handleDeleteVirtualSensor(AsyncWebServerRequest* request, uint8_t slot);
+    
+    /**
+     * GET /api/rules - Alarm rules with compile status
+     */
+    void handleGetAlarmRules(AsyncWebServerRequest* request);
+    
+    /**
+     * POST /api/rules - Create or update an alarm rule
+     */
+    void handleUpdateAlarmRule(AsyncWebServerRequest* request,
+                               uint8_t* data, size_t len);
+    
+    /**
+     * DELETE /api/rules/{slot} - Remove an alarm rule
+     */
+    void handleDeleteAlarmRule(AsyncWebServerRequest* request, uint8_t slot);
+    
     /**
      * GET /api/config/wifi - WiFi configuration
      */
@@ -136,6 +280,100 @@ private:
     void handleUpdateSystemConfig(AsyncWebServerRequest* request,
                                   uint8_t* data, size_t len);
     
+    /**
+     * GET /api/config/udp - UDP telemetry configuration
+     */
+    void handleGetUdpConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/udp - Update UDP telemetry configuration
+     */
+    void handleUpdateUdpConfig(AsyncWebServerRequest* request,
+                               uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/hub - Hub mode configuration and peers
+     */
+    void handleGetHubConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/hub - Update hub mode configuration
+     */
+    void handleUpdateHubConfig(AsyncWebServerRequest* request,
+                               uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/ingest - Sensor ingestion configuration
+     */
+    void handleGetIngestConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/ingest - Update sensor ingestion configuration
+     */
+    void handleUpdateIngestConfig(AsyncWebServerRequest* request,
+                                  uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/coap - CoAP server configuration
+     */
+    void handleGetCoapConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/coap - Update CoAP server configuration
+     */
+    void handleUpdateCoapConfig(AsyncWebServerRequest* request,
+                                uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/influx - InfluxDB export configuration
+     */
+    void handleGetInfluxConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/influx - Update InfluxDB export configuration
+     */
+    void handleUpdateInfluxConfig(AsyncWebServerRequest* request,
+                                  uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/power - Battery mode configuration
+     */
+    void handleGetPowerConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/power - Update battery mode configuration
+     */
+    void handleUpdatePowerConfig(AsyncWebServerRequest* request,
+                                 uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/bus - OneWire bus configuration
+     */
+    void handleGetBusConfig(AsyncWebServerRequest* request);
+    
+    /**
+     * PUT /api/config/bus - Update OneWire bus configuration
+     */
+    void handleUpdateBusConfig(AsyncWebServerRequest* request,
+                               uint8_t* data, size_t len);
+    
+    /**
+     * GET /api/config/webhooks - Webhook endpoints with delivery metrics
+     */
+    void handleGetWebhooks(AsyncWebServerRequest* request);
+    
+    /**
+     * POST /api/config/webhooks - Update a webhook endpoint
+     */
+    void handleUpdateWebhook(AsyncWebServerRequest* request,
+                             uint8_t* data, size_t len);
+    
+    /**
+     * POST /api/webhooks/test - Send a test event to an endpoint
+     */
+    void handleTestWebhook(AsyncWebServerRequest* request,
+                           uint8_t* data, size_t len);
+    
     /**
      * GET /api/wifi/scan - Scan for WiFi networks
      */
@@ -162,6 +400,11 @@ private:
      */
     void handleRescan(AsyncWebServerRequest* request);
     
+    /**
+     * GET /api/diagnostics/bus - OneWire read health per bus and sensor
+     */
+    void handleGetBusDiagnostics(AsyncWebServerRequest* request);
+    
     /**
      * POST /api/reboot - Reboot device
      */
@@ -233,6 +476,33 @@ private:
      */
     bool checkServerLoad(AsyncWebServerRequest* request);
     
+    /**
+     * Add X-Read-Generation, X-Sample-Age and X-Next-Reading (ms) headers
+     * so clients can schedule their next poll just after new data lands
+     */
+    void addReadingHeaders(AsyncWebServerResponse* response);
+    
+    /**
+     * Serialize the queried sensors into a heap buffer (caller frees)
+     * @param generation Wrap as {"generation":n,"total":n,"sensors":[...]} if true
+     * @return nullptr if out of memory
+     */
+    char* buildSensorsBody(bool generation, const SensorQuery& query, size_t& len);
+    
+    /**
+     * Build a JSON response with connection headers, gzipped if the body
+     * is at least HTTP_GZIP_MIN_SIZE and the client accepts gzip
+     * @return Response to send (caller may add headers); json can be freed
+     */
+    AsyncWebServerResponse* beginJsonResponse(AsyncWebServerRequest* request, int code, const char* json);
+    
+    /**
+     * Build a gzipped response for a JSON body
+     * @return nullptr if compression is not possible or does not pay off
+     */
+    AsyncWebServerResponse* beginGzipResponse(AsyncWebServerRequest* request, int code,
+                                              const char* json, size_t len);
+    
     /**
      * Send JSON response
      */
@@ -247,11 +517,6 @@ private:
      * Send success response
      */
     void sendSuccess(AsyncWebServerRequest* request, const char* message = nullptr);
-    
-    /**
-     * Build sensor JSON object
-     */
-    void buildSensorJson(JsonObject& obj, uint8_t sensorIndex);
 };
 
 // Global web server instance